@@ -81,6 +81,36 @@ auto Binder::BindColumnDefinition(duckdb_libpgquery::PGColumnDef *cdef) -> Colum
   throw NotImplementedException(fmt::format("unsupported type: {}", name));
 }
 
+auto Binder::BindCompressionOption(duckdb_libpgquery::PGNode *arg) -> bool {
+  // A bare `compression` turns it on. Unquoted words arrive as type names, keywords like `true` as strings.
+  if (arg == nullptr) {
+    return true;
+  }
+  std::string value;
+  switch (arg->type) {
+    case duckdb_libpgquery::T_PGInteger:
+      return reinterpret_cast<duckdb_libpgquery::PGValue *>(arg)->val.ival != 0;
+    case duckdb_libpgquery::T_PGString:
+      value = reinterpret_cast<duckdb_libpgquery::PGValue *>(arg)->val.str;
+      break;
+    case duckdb_libpgquery::T_PGTypeName:
+      value = reinterpret_cast<duckdb_libpgquery::PGValue *>(
+                  reinterpret_cast<duckdb_libpgquery::PGTypeName *>(arg)->names->tail->data.ptr_value)
+                  ->val.str;
+      break;
+    default:
+      throw NotImplementedException("unsupported compression option");
+  }
+  value = StringUtil::Lower(value);
+  if (value == "lz" || value == "on" || value == "true") {
+    return true;
+  }
+  if (value == "none" || value == "off" || value == "false") {
+    return false;
+  }
+  throw NotImplementedException(fmt::format("unsupported compression: {}", value));
+}
+
 auto Binder::BindCreate(duckdb_libpgquery::PGCreateStmt *pg_stmt) -> std::unique_ptr<CreateStatement> {
   auto table = std::string(pg_stmt->relation->relname);
   auto columns = std::vector<Column>{};
@@ -112,7 +142,18 @@ auto Binder::BindCreate(duckdb_libpgquery::PGCreateStmt *pg_stmt) -> std::unique
     throw bustub::Exception("should have at least 1 column");
   }
 
-  return std::make_unique<CreateStatement>(std::move(table), std::move(columns));
+  bool compressed = false;
+  if (pg_stmt->options != nullptr) {
+    for (auto c = pg_stmt->options->head; c != nullptr; c = lnext(c)) {
+      auto option = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(c->data.ptr_value);
+      if (std::string(option->defname) != "compression") {
+        throw NotImplementedException(fmt::format("unsupported table option: {}", option->defname));
+      }
+      compressed = BindCompressionOption(option->arg);
+    }
+  }
+
+  return std::make_unique<CreateStatement>(std::move(table), std::move(columns), compressed);
 }
 
 auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<IndexStatement> {
@@ -0,0 +1,20 @@
+#include <memory>
+#include <string>
+
+#include "binder/binder.h"
+#include "binder/statement/vacuum_statement.h"
+#include "common/exception.h"
+#include "common/util/string_util.h"
+
+namespace bustub {
+
+auto Binder::BindVacuum(duckdb_libpgquery::PGVacuumStmt *stmt) -> std::unique_ptr<VacuumStatement> {
+  // `VACUUM FILE` parses as vacuuming a relation named "file".
+  if (stmt->relation == nullptr || stmt->relation->schemaname != nullptr ||
+      StringUtil::Lower(stmt->relation->relname) != "file") {
+    throw bustub::NotImplementedException("only VACUUM FILE is supported");
+  }
+  return std::make_unique<VacuumStatement>("file");
+}
+
+}  // namespace bustub
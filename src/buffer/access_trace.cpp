@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// access_trace.cpp
+//
+// Identification: src/buffer/access_trace.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/access_trace.h"
+
+#include <cstring>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+namespace {
+
+constexpr char TRACE_MAGIC[] = "BTTRACE1";
+constexpr size_t TRACE_MAGIC_SIZE = sizeof(TRACE_MAGIC) - 1;
+constexpr size_t TRACE_RECORD_SIZE = 5;
+/** Number of buffered bytes that triggers a write to the file. */
+constexpr size_t TRACE_BUFFER_SIZE = 64 * 1024;
+
+}  // namespace
+
+AccessTraceWriter::AccessTraceWriter(const std::string &file_name)
+    : file_(file_name, std::ios::binary | std::ios::out | std::ios::trunc) {
+  if (!file_.is_open()) {
+    throw Exception("cannot create access trace " + file_name);
+  }
+  file_.write(TRACE_MAGIC, TRACE_MAGIC_SIZE);
+  buffer_.reserve(TRACE_BUFFER_SIZE + TRACE_RECORD_SIZE);
+}
+
+AccessTraceWriter::~AccessTraceWriter() { Flush(); }
+
+void AccessTraceWriter::Record(AccessTraceOp op, page_id_t page_id) {
+  auto id = static_cast<uint32_t>(page_id);
+  std::scoped_lock<std::mutex> lock(latch_);
+  buffer_.push_back(static_cast<char>(op));
+  for (int shift = 0; shift < 32; shift += 8) {
+    buffer_.push_back(static_cast<char>((id >> shift) & 0xff));
+  }
+  num_records_++;
+  if (buffer_.size() >= TRACE_BUFFER_SIZE) {
+    FlushLocked();
+  }
+}
+
+void AccessTraceWriter::Flush() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  FlushLocked();
+  file_.flush();
+}
+
+void AccessTraceWriter::FlushLocked() {
+  file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+  buffer_.clear();
+}
+
+auto AccessTraceWriter::GetNumRecords() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return num_records_;
+}
+
+AccessTraceReader::AccessTraceReader(const std::string &file_name) : file_(file_name, std::ios::binary | std::ios::in) {
+  char magic[TRACE_MAGIC_SIZE];
+  if (!file_.is_open() || !file_.read(magic, TRACE_MAGIC_SIZE) || memcmp(magic, TRACE_MAGIC, TRACE_MAGIC_SIZE) != 0) {
+    throw Exception("not an access trace: " + file_name);
+  }
+}
+
+auto AccessTraceReader::Next(AccessTraceRecord *record) -> bool {
+  unsigned char data[TRACE_RECORD_SIZE];
+  if (!file_.read(reinterpret_cast<char *>(data), TRACE_RECORD_SIZE)) {
+    return false;
+  }
+  uint32_t id = 0;
+  for (int i = 0; i < 4; i++) {
+    id |= static_cast<uint32_t>(data[1 + i]) << (8 * i);
+  }
+  record->op_ = static_cast<AccessTraceOp>(data[0]);
+  record->page_id_ = static_cast<page_id_t>(id);
+  return true;
+}
+
+}  // namespace bustub
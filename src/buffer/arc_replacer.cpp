@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.cpp
+//
+// Identification: src/buffer/arc_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace bustub {
+
+ARCReplacer::ARCReplacer(size_t num_frames) : num_frames_(num_frames), frames_(num_frames) {}
+
+auto ARCReplacer::Victim(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (!t1_.empty() && (t1_.size() > target_ || t2_.empty())) {
+    return EvictFrom(&t1_, &b1_, frame_id) || EvictFrom(&t2_, &b2_, frame_id);
+  }
+  return EvictFrom(&t2_, &b2_, frame_id) || EvictFrom(&t1_, &b1_, frame_id);
+}
+
+auto ARCReplacer::EvictFrom(std::list<frame_id_t> *list, GhostList *ghost_list, frame_id_t *frame_id) -> bool {
+  for (auto candidate : *list) {
+    if (frames_[candidate].evictable_) {
+      ghost_list->PushBack(frames_[candidate].page_id_);
+      Untrack(candidate);
+      *frame_id = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+void ARCReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < num_frames_, "invalid frame id");
+  auto &entry = frames_[frame_id];
+  if (entry.list_ != ListId::NONE && entry.page_id_ == page_id) {
+    (entry.list_ == ListId::T1 ? t1_ : t2_).erase(entry.pos_);
+    entry.list_ = ListId::T2;
+    entry.pos_ = t2_.insert(t2_.end(), frame_id);
+    return;
+  }
+
+  // The frame was reused for another page without being victimized first.
+  const bool evictable = entry.evictable_;
+  if (entry.list_ != ListId::NONE) {
+    Untrack(frame_id);
+  }
+
+  if (b1_.Contains(page_id)) {
+    target_ = std::min(num_frames_, target_ + std::max<size_t>(1, b2_.Size() / b1_.Size()));
+    b1_.Erase(page_id);
+    entry.list_ = ListId::T2;
+    entry.pos_ = t2_.insert(t2_.end(), frame_id);
+  } else if (b2_.Contains(page_id)) {
+    target_ -= std::min(target_, std::max<size_t>(1, b1_.Size() / b2_.Size()));
+    b2_.Erase(page_id);
+    entry.list_ = ListId::T2;
+    entry.pos_ = t2_.insert(t2_.end(), frame_id);
+  } else {
+    entry.list_ = ListId::T1;
+    entry.pos_ = t1_.insert(t1_.end(), frame_id);
+    // Keep |T1| + |B1| <= c and |T1| + |T2| + |B1| + |B2| <= 2c.
+    while (t1_.size() + b1_.Size() > num_frames_ && b1_.Size() > 0) {
+      b1_.PopFront();
+    }
+    while (t1_.size() + t2_.size() + b1_.Size() + b2_.Size() > 2 * num_frames_ && b2_.Size() > 0) {
+      b2_.PopFront();
+    }
+  }
+  entry.page_id_ = page_id;
+  if (evictable) {
+    entry.evictable_ = true;
+    curr_size_++;
+  }
+}
+
+void ARCReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < num_frames_, "invalid frame id");
+  auto &entry = frames_[frame_id];
+  if (entry.list_ == ListId::NONE || entry.evictable_ == set_evictable) {
+    return;
+  }
+  entry.evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
+
+auto ARCReplacer::IsTracked(frame_id_t frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return static_cast<size_t>(frame_id) < num_frames_ && frames_[frame_id].list_ != ListId::NONE;
+}
+
+void ARCReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < num_frames_, "invalid frame id");
+  if (frames_[frame_id].list_ == ListId::NONE || !frames_[frame_id].evictable_) {
+    return;
+  }
+  Untrack(frame_id);
+}
+
+void ARCReplacer::Untrack(frame_id_t frame_id) {
+  auto &entry = frames_[frame_id];
+  (entry.list_ == ListId::T1 ? t1_ : t2_).erase(entry.pos_);
+  if (entry.evictable_) {
+    curr_size_--;
+  }
+  entry = FrameEntry();
+}
+
+auto ARCReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
+
+auto ARCReplacer::GetTarget() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return target_;
+}
+
+void ARCReplacer::SetNumFrames(size_t num_frames) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  num_frames_ = num_frames;
+  frames_.resize(num_frames);
+  target_ = std::min(target_, num_frames);
+}
+
+}  // namespace bustub
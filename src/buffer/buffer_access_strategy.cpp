@@ -0,0 +1,32 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_access_strategy.cpp
+//
+// Identification: src/buffer/buffer_access_strategy.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_access_strategy.h"
+
+#include "buffer/buffer_pool_manager.h"
+
+namespace bustub {
+
+BufferAccessStrategy::BufferAccessStrategy(BufferPoolManager *bpm, size_t ring_size)
+    : bpm_(bpm), ring_size_(ring_size) {
+  BUSTUB_ASSERT(ring_size > 0, "a ring needs at least one frame");
+}
+
+BufferAccessStrategy::~BufferAccessStrategy() { bpm_->ReleaseStrategy(this); }
+
+auto BufferAccessStrategy::GetRing(uint32_t instance_index) -> Ring & {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // References to the elements of an unordered_map stay valid when it grows.
+  return rings_[instance_index];
+}
+
+}  // namespace bustub
@@ -11,324 +11,1000 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/buffer_pool_manager_instance.h"
-#include <cstddef>
-#include <ostream>
+
+#include <algorithm>
+#include <cstring>
+#include <future>  // NOLINT
+#include <iterator>
+#include <memory>
+#include <new>
+#include <thread>
 
 #include "common/config.h"
 #include "common/exception.h"
 #include "common/macros.h"
-#include "iostream"
+#include "fmt/format.h"
 #include "storage/page/page.h"
 
 namespace bustub {
 
 BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, size_t replacer_k,
-                                                     LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
-  // we allocate a consecutive memory space for the buffer pool
-  pages_ = new Page[pool_size_];
-  page_table_ = new ExtendibleHashTable<page_id_t, frame_id_t>(bucket_size_);
-  replacer_ = new LRUKReplacer(pool_size, replacer_k);
-
-  // Initially, every page is in the free list.
-  for (size_t i = 0; i < pool_size_; ++i) {
-    free_list_.emplace_back(static_cast<int>(i));
+                                                     LogManager *log_manager, ReplacerType replacer_type)
+    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, replacer_k, log_manager, replacer_type) {}
+
+BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                                                     DiskManager *disk_manager, size_t replacer_k,
+                                                     LogManager *log_manager, ReplacerType replacer_type)
+    : pool_size_(0),
+      num_instances_(num_instances),
+      instance_index_(instance_index),
+      huge_pages_(buffer_pool_huge_pages),
+      disk_manager_(disk_manager),
+      read_only_(disk_manager->IsReadOnly()),
+      log_manager_(log_manager) {
+  BUSTUB_ASSERT(num_instances > 0, "If BPI is not part of a pool, then the pool size should just be 1");
+  BUSTUB_ASSERT(
+      instance_index < num_instances,
+      "BPI index cannot be greater than the number of BPIs in the pool. In non-parallel case, index should just be 1.");
+  BUSTUB_ASSERT(pool_size > 0, "a buffer pool needs at least one frame");
+  page_table_ = new ConcurrentPageTable(pool_size);
+  replacer_ = MakeReplacer(replacer_type, pool_size, replacer_k);
+  if (!page_class_priorities) {
+    replacer_->SetPageClassPriorities({});
+  }
+  if (victim_cache_size > 0 && !read_only_) {
+    victim_cache_ = new VictimCache(victim_cache_size / num_instances);
   }
 
-  // TODO(students): remove this line after you have implemented the buffer pool manager
-  // throw NotImplementedException(
-  //     "BufferPoolManager is not implemented yet. If you have finished implementing BPM, please remove the throw "
-  //     "exception line in `buffer_pool_manager_instance.cpp`.");
+  // Frames are allocated in chunks that never move, so that the pool can grow while it is in use. Initially, every
+  // frame is in the free list.
+  std::scoped_lock<std::mutex> lock(latch_);
+  Grow(pool_size);
 }
 
 BufferPoolManagerInstance::~BufferPoolManagerInstance() {
-  delete[] pages_;
-  delete page_table_;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    prefetcher_running_ = false;
+    prefetch_cv_.notify_all();
+  }
+  if (prefetcher_ != nullptr) {
+    prefetcher_->join();
+    delete prefetcher_;
+  }
+  StopPageCleaner();
+  for (size_t i = 0; i < num_chunks_; ++i) {
+    FrameChunk *chunk = GetChunk(i);
+    for (size_t j = 0; j < FRAMES_PER_CHUNK; ++j) {
+      chunk->pages_[j].~Page();
+    }
+    ::operator delete(chunk->pages_);
+    delete chunk->arena_;
+    delete chunk;
+  }
+  delete GetPageTable();
   delete replacer_;
+  delete victim_cache_;
 }
-/**
-  * TODO(P1): Add implementation
-  *
-  * @brief Create a new page in the buffer pool. Set page_id to the new page's id, or nullptr if all frames
-  * are currently in use and not evictable (in another word, pinned).
-  *
-  * You should pick the replacement frame from either the free list or the replacer (always find from the free list
-  * first), and then call the AllocatePage() method to get a new page id. If the replacement frame has a dirty page,
-  * you should write it back to the disk first. You also need to reset the memory and metadata for the new page.
-  *
-  * Remember to "Pin" the frame by calling replacer.SetEvictable(frame_id, false)
-  * so that the replacer wouldn't evict the frame before the buffer pool manager "Unpin"s it.
-  * Also, remember to record the access history of the frame in the replacer for the lru-k algorithm to work.
-  *
-  * @param[out] page_id id of created page
-  * @return nullptr if no new pages could be created, otherwise pointer to new page
-*/
-
-auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * { 
-  std::scoped_lock<std::mutex> lock(latch_);
- 
-  frame_id_t frame_allocated;
-  bool allocated = false;
-  if(!free_list_.empty()){
-    frame_allocated = *(free_list_.begin());
-    // std::cout << "Hey frame is free " << frame_allocated << std::endl;
-    free_list_.erase(free_list_.begin());
-    allocated = true;
-    
-  }
-  if(!allocated){
-    
-    if(replacer_->Evict(&frame_allocated)){
-      allocated = true;
-      
-      // std::cout << "Hey frame is evicted " << frame_allocated << std::endl;
-    }
-    
-  }
-  if(!allocated){
-    // std::cout << "Failed to get a frame" << std::endl;
+
+auto BufferPoolManagerInstance::PinFrame(frame_id_t frame_id) -> bool {
+  auto &pin_count = GetFrame(frame_id).pin_count_;
+  int cur = pin_count.load(std::memory_order_relaxed);
+  while (cur >= 0) {
+    if (pin_count.compare_exchange_weak(cur, cur + 1, std::memory_order_acquire)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+auto BufferPoolManagerInstance::UnpinFrame(frame_id_t frame_id) -> bool {
+  auto &pin_count = GetFrame(frame_id).pin_count_;
+  // Read while our pin keeps the frame from being recycled.
+  const page_id_t page_id = GetFrame(frame_id).GetPageId();
+  const PageClass page_class = GetFrame(frame_id).GetPageClass();
+  int cur = pin_count.load(std::memory_order_relaxed);
+  while (cur > 0) {
+    if (pin_count.compare_exchange_weak(cur, cur - 1, std::memory_order_release)) {
+      // Ring frames are recycled by their strategy and resident frames never evicted, so neither enters the replacer.
+      if (cur == 1 && !GetRingFrame(frame_id).load() && !GetResidentFrame(frame_id).load()) {
+        replacer_->RecordAccess(frame_id, page_id, page_class);
+        replacer_->SetEvictable(frame_id, true);
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+auto BufferPoolManagerInstance::LockFrame(frame_id_t frame_id) -> bool {
+  int expected = 0;
+  return GetFrame(frame_id).pin_count_.compare_exchange_strong(expected, -1, std::memory_order_acquire);
+}
+
+auto BufferPoolManagerInstance::AcquireFrame(frame_id_t *frame_id, page_id_t *victim_page_id,
+                                             BufferAccessStrategy *strategy) -> bool {
+  bool found = false;
+  BufferAccessStrategy::Ring *ring = nullptr;
+  size_t ring_capacity = 0;
+  if (strategy != nullptr) {
+    ring = &strategy->GetRing(instance_index_);
+    ring_capacity = std::max<size_t>(1, strategy->GetRingSize() / num_instances_);
+    if (ring->frames_.size() >= ring_capacity) {
+      *frame_id = ring->frames_[ring->next_];
+      found = GetRingFrame(*frame_id).load() && LockFrame(*frame_id);
+      if (!found) {
+        // Someone else is using the page; leave it to the replacer and give the ring a regular victim instead.
+        ReturnRingFrame(*frame_id);
+      }
+    }
+  }
+
+  // A free frame can only fail to lock if a stale hit-path reader pinned it for a moment; that reader's unpin hands
+  // the frame to the replacer, so dropping it from the free list does not leak it.
+  while (!found && !free_list_.empty()) {
+    *frame_id = free_list_.front();
+    free_list_.pop_front();
+    found = LockFrame(*frame_id);
+  }
+  // Frames re-pinned through the hit path are still in the replacer; skip them until their next unpin. Resident
+  // frames only get there through an unpin that raced with SetPageResident(), and are dropped from it here.
+  while (!found && replacer_->Victim(frame_id)) {
+    found = !GetResidentFrame(*frame_id).load() && LockFrame(*frame_id);
+  }
+  if (!found) {
+    return false;
+  }
+
+  Page &page = GetFrame(*frame_id);
+  *victim_page_id = INVALID_PAGE_ID;
+  if (page.GetPageId() != INVALID_PAGE_ID) {
+    stats_.Add(BufferPoolCounter::EVICTIONS);
+    if (page.IsDirty()) {
+      *victim_page_id = page.GetPageId();
+      stats_.Add(BufferPoolCounter::DIRTY_WRITE_BACKS);
+      if (page_cleaner_running_) {
+        page_cleaner_wakeup_ = true;
+        page_cleaner_cv_.notify_one();
+      }
+    } else {
+      if (cleaned_frames_[*frame_id]) {
+        stats_.Add(BufferPoolCounter::AVOIDED_WRITE_BACKS);
+      }
+      // Pages of a read-only pool may point into the mapped file, and never get a victim cache anyway.
+      if (victim_cache_ != nullptr) {
+        *victim_page_id = page.GetPageId();
+      }
+    }
+    GetPageTable()->Remove(page.GetPageId());
+  }
+  cleaned_frames_[*frame_id] = false;
+  page.SetPageClass(PageClass::UNKNOWN);
+
+  if (ring != nullptr) {
+    if (ring->frames_.size() < ring_capacity) {
+      ring->frames_.push_back(*frame_id);
+    } else {
+      ring->frames_[ring->next_] = *frame_id;
+    }
+    ring->next_ = (ring->next_ + 1) % ring_capacity;
+    GetRingFrame(*frame_id).store(true);
+  }
+  return true;
+}
+
+void BufferPoolManagerInstance::ReturnRingFrame(frame_id_t frame_id) {
+  // Frames deleted while in the ring are already back on the free list.
+  if (GetRingFrame(frame_id).exchange(false)) {
+    replacer_->RecordAccess(frame_id, GetFrame(frame_id).GetPageId(), GetFrame(frame_id).GetPageClass());
+    replacer_->SetEvictable(frame_id, true);
+  }
+}
+
+void BufferPoolManagerInstance::LoadFrame(std::unique_lock<std::mutex> *lock, frame_id_t frame_id,
+                                          page_id_t victim_page_id, bool read_page) {
+  Page &page = GetFrame(frame_id);
+  if (victim_page_id != INVALID_PAGE_ID) {
+    // A clean victim is demoted under the same protocol, so that requesters of it find it in the victim cache.
+    frame_states_[frame_id] = FrameState::WRITING_BACK;
+    writing_back_.emplace(victim_page_id, frame_id);
+    lock->unlock();
+    if (page.IsDirty()) {
+      WritePageToDisk(victim_page_id, page.GetData());
+    } else {
+      victim_cache_->Insert(victim_page_id, page.GetData());
+    }
+    lock->lock();
+    writing_back_.erase(victim_page_id);
+    GetFrameCv(frame_id).notify_all();
+  }
+  page.is_dirty_ = false;
+
+  if (MapFrame(frame_id, read_page)) {
+    read_page = false;
+  } else {
+    page.ResetMemory();
+  }
+  if (read_page) {
+    frame_states_[frame_id] = FrameState::LOADING;
+    lock->unlock();
+    ReadFrame(frame_id);
+    lock->lock();
+  }
+
+  frame_states_[frame_id] = FrameState::READY;
+  // Publishing the pin count releases the frame to hit-path readers.
+  page.pin_count_.store(1, std::memory_order_release);
+  GetFrameCv(frame_id).notify_all();
+}
+
+void BufferPoolManagerInstance::ReadFrame(frame_id_t frame_id) {
+  Page &page = GetFrame(frame_id);
+  if (victim_cache_ == nullptr || !victim_cache_->Take(page.GetPageId(), page.GetData())) {
+    ReadPageFromDisk(page.GetPageId(), page.GetData());
+  }
+}
+
+void BufferPoolManagerInstance::ReadPageFromDisk(page_id_t page_id, char *page_data) {
+  const auto start = BufferPoolStatsCollector::Clock::now();
+  disk_manager_->ReadPage(page_id, page_data);
+  stats_.Record(BufferPoolCounter::DISK_READS, BufferPoolLatency::DISK_READ, start);
+}
+
+void BufferPoolManagerInstance::WritePageToDisk(page_id_t page_id, const char *page_data) {
+  const auto start = BufferPoolStatsCollector::Clock::now();
+  disk_manager_->WritePage(page_id, page_data);
+  stats_.Record(BufferPoolCounter::DISK_WRITES, BufferPoolLatency::DISK_WRITE, start);
+}
+
+auto BufferPoolManagerInstance::SubmitDiskRequests(std::vector<DiskRequest> *requests) -> std::vector<bool> {
+  std::vector<bool> succeeded;
+  if (requests->empty()) {
+    return succeeded;
+  }
+  std::vector<std::future<bool>> results;
+  for (auto &request : *requests) {
+    results.push_back(request.callback_.get_future());
+  }
+  const auto start = BufferPoolStatsCollector::Clock::now();
+  disk_manager_->SubmitRequests(requests);
+  for (auto &result : results) {
+    succeeded.push_back(result.get());
+  }
+  // The requests of a batch complete together as far as the caller can tell, so each is charged the whole batch.
+  for (const auto &request : *requests) {
+    if (request.is_write_) {
+      stats_.Record(BufferPoolCounter::DISK_WRITES, BufferPoolLatency::DISK_WRITE, start);
+    } else {
+      stats_.Record(BufferPoolCounter::DISK_READS, BufferPoolLatency::DISK_READ, start);
+    }
+  }
+  return succeeded;
+}
+
+auto BufferPoolManagerInstance::MapFrame(frame_id_t frame_id, bool read_page) -> bool {
+  Page &page = GetFrame(frame_id);
+  const char *mapped = read_only_ && read_page ? disk_manager_->MapPage(page.GetPageId()) : nullptr;
+  // The mapping is PROT_READ; casting its constness away is safe as long as a read-only pool never dirties a page.
+  page.data_ = mapped != nullptr ? const_cast<char *>(mapped) : GetFrameData(frame_id);
+  return mapped != nullptr;
+}
+
+void BufferPoolManagerInstance::CheckWritable(const char *operation) const {
+  if (read_only_) {
+    throw Exception(fmt::format("can't {}: the buffer pool is read-only", operation));
+  }
+}
+
+auto BufferPoolManagerInstance::PinResidentPage(std::unique_lock<std::mutex> *lock, page_id_t page_id,
+                                                frame_id_t *frame_id) -> bool {
+  while (true) {
+    if (GetPageTable()->Find(page_id, frame_id)) {
+      // Outside of latch_, a frame is only locked while its I/O is in flight.
+      if (PinFrame(*frame_id)) {
+        return true;
+      }
+      const frame_id_t loading_frame = *frame_id;
+      const auto start = BufferPoolStatsCollector::Clock::now();
+      GetFrameCv(loading_frame).wait(*lock, [&] { return frame_states_[loading_frame] == FrameState::READY; });
+      stats_.Record(BufferPoolCounter::PIN_WAITS, BufferPoolLatency::PIN_WAIT, start);
+      continue;
+    }
+
+    auto it = writing_back_.find(page_id);
+    if (it == writing_back_.end()) {
+      return false;
+    }
+    // Reading the page from disk before its write-back completes would return a stale copy.
+    const auto start = BufferPoolStatsCollector::Clock::now();
+    GetFrameCv(it->second).wait(*lock, [&] { return writing_back_.count(page_id) == 0; });
+    stats_.Record(BufferPoolCounter::PIN_WAITS, BufferPoolLatency::PIN_WAIT, start);
+  }
+}
+
+auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * {
+  CheckWritable("create a page");
+  std::unique_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  page_id_t victim_page_id;
+  if (!AcquireFrame(&frame_id, &victim_page_id)) {
     return nullptr;
   }
 
-  Page& page_in_frame = pages_[frame_allocated];
-  // pages_[frame_allocated].WLatch(); 
-  // use locks
-  if(page_in_frame.IsDirty()){
-    // std::cout << "Evicting dirty page " << page_in_frame.GetPageId() << " Data: " << page_in_frame.GetData() << std::endl;
-    disk_manager_->WritePage(page_in_frame.GetPageId(), page_in_frame.GetData());
-  }
-  
-  page_table_->Remove(page_in_frame.GetPageId());
-  // std::cout << " Page id old assigned" << page_in_frame.GetPageId() << std::endl;
-  replacer_->Remove(frame_allocated);
-
-  
-  
-  
-  
-  page_in_frame.ResetMemory();
-  
-  page_in_frame.page_id_ = AllocatePage();
-  // std::cout << " Page id new assigned" << page_in_frame.GetPageId() << std::endl;
-  *page_id = page_in_frame.page_id_;
-  page_in_frame.is_dirty_ = false; 
-  page_in_frame.pin_count_ = 1;
-  // pages_[frame_allocated].WUnlatch();
-  
-  page_table_->Insert(*page_id, frame_allocated);
-  
-  replacer_->RecordAccess(frame_allocated);
-  replacer_->SetEvictable(frame_allocated, false);
-  
-
-  // std::cout << page_in_frame. << std::endl;
-  return &page_in_frame; 
-  
-}
-
-
-/**
-  * TODO(P1): Add implementation
-  *
-  * @brief Fetch the requested page from the buffer pool. Return nullptr if page_id needs to be fetched from the disk
-  * but all frames are currently in use and not evictable (in another word, pinned).
-  *
-  * First search for page_id in the buffer pool. If not found, pick a replacement frame from either the free list or
-  * the replacer (always find from the free list first), read the page from disk by calling disk_manager_->ReadPage(),
-  * and replace the old page in the frame. Similar to NewPgImp(), if the old page is dirty, you need to write it back
-  * to disk and update the metadata of the new page
-  *
-  * In addition, remember to disable eviction and record the access history of the frame like you did for NewPgImp().
-  *
-  * @param page_id id of page to be fetched
-  * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
-  */
-
-auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * { 
-  std::scoped_lock<std::mutex> lock(latch_);
-  frame_id_t frame_id_mapped;
-  // std::cout << " hey came for fetching " << page_id << std::endl;
-  if(page_table_->Find(page_id, frame_id_mapped)){
-    // std::cout << "Data is " << pages_[frame_id_mapped].GetData() << std::endl;
-    // pages_[frame_id_mapped].WLatch();
-    pages_[frame_id_mapped].pin_count_++;
-    // pages_[frame_id_mapped].WUnlatch();
-    return &pages_[frame_id_mapped];
-  }
-   
-  frame_id_t frame_allocated;
-  bool allocated = false;
-  if(!free_list_.empty()){
-    frame_allocated = *(free_list_.begin());
-    
-    free_list_.erase(free_list_.begin());
-    allocated = true;
-    
-  }
-  if(!allocated){
-    
-    if(replacer_->Evict(&frame_allocated)){
-      allocated = true;
-      
-    }
-    
-  }
-  if(!allocated){
-    //  std::cout << " sending null" << page_id << std::endl;
+  Page &page = GetFrame(frame_id);
+  *page_id = AllocatePage();
+  page.page_id_ = *page_id;
+  GetPageTable()->Insert(*page_id, frame_id);
+  Trace(AccessTraceOp::NEW, *page_id);
+  stats_.Add(BufferPoolCounter::NEW_PAGES);
+  LoadFrame(&lock, frame_id, victim_page_id, false);
+  // The id may be reused from a deleted page whose contents are still on disk; the zeroed page must replace them.
+  page.is_dirty_ = true;
+  return &page;
+}
+
+auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * {
+  return FetchPageWithStrategy(page_id, nullptr);
+}
+
+auto BufferPoolManagerInstance::FetchPageWithStrategy(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * {
+  Trace(AccessTraceOp::FETCH, page_id);
+  auto start = BufferPoolStatsCollector::StartFetch();
+  frame_id_t frame_id;
+  // Fast path: a hit pins the frame with a CAS and touches neither latch_ nor the replacer.
+  if (GetPageTable()->Find(page_id, &frame_id) && PinFrame(frame_id)) {
+    if (GetFrame(frame_id).GetPageId() == page_id) {
+      stats_.Record(BufferPoolCounter::FETCH_HITS, BufferPoolLatency::FETCH_HIT, start);
+      return &GetFrame(frame_id);
+    }
+    // The frame was recycled for another page between the lookup and the pin.
+    UnpinFrame(frame_id);
+  }
+
+  // Past the fast path, a fetch likely misses; misses are always timed.
+  if (start == BufferPoolStatsCollector::Clock::time_point()) {
+    start = BufferPoolStatsCollector::Clock::now();
+  }
+  std::unique_lock<std::mutex> lock(latch_);
+  if (PinResidentPage(&lock, page_id, &frame_id)) {
+    stats_.Record(BufferPoolCounter::FETCH_HITS, BufferPoolLatency::FETCH_HIT, start);
+    return &GetFrame(frame_id);
+  }
+
+  page_id_t victim_page_id;
+  if (!AcquireFrame(&frame_id, &victim_page_id, strategy)) {
     return nullptr;
   }
 
-  Page& page_in_frame = pages_[frame_allocated];
-  // page_in_frame.WLatch();
-  // use locks
-  if(page_in_frame.IsDirty()){
-    disk_manager_->WritePage(page_in_frame.GetPageId(), page_in_frame.GetData());
-  }
-  page_table_->Remove(page_in_frame.GetPageId());
-  replacer_->Remove(frame_allocated);
-
-  page_in_frame.ResetMemory();
-  
-  page_in_frame.page_id_ = page_id;
-  page_in_frame.pin_count_ = 1;
-  page_in_frame.is_dirty_ = false;
-  
-  disk_manager_->ReadPage(page_id, page_in_frame.data_);
-  // std::cout << "Hey assigned " << page_in_frame.page_id_ << " data " << page_in_frame.data_ << std::endl;
-  page_table_->Insert(page_id, frame_allocated);
-  
-  replacer_->RecordAccess(frame_allocated);
-  replacer_->SetEvictable(frame_allocated, false);
-  
-  // page_in_frame.WUnlatch(); 
-  // std::cout << "Data is " << page_in_frame.GetData() << std::endl;
-  return &page_in_frame; 
-
-  
-  }
-
-/**
-  * TODO(P1): Add implementation
-  *
-  * @brief Unpin the target page from the buffer pool. If page_id is not in the buffer pool or its pin count is already
-  * 0, return false.
-  *
-  * Decrement the pin count of a page. If the pin count reaches 0, the frame should be evictable by the replacer.
-  * Also, set the dirty flag on the page to indicate if the page was modified.
-  *
-  * @param page_id id of page to be unpinned
-  * @param is_dirty true if the page should be marked as dirty, false otherwise
-  * @return false if the page is not in the page table or its pin count is <= 0 before this call, true otherwise
-  */
-auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool { 
-  std::scoped_lock<std::mutex> lock(latch_);
-  frame_id_t frame_alloted;
-  if(!page_table_->Find(page_id, frame_alloted)){
-    return false; 
+  // Map the page before reading it, so that concurrent requesters wait for this load instead of issuing their own.
+  Page &page = GetFrame(frame_id);
+  page.page_id_ = page_id;
+  GetPageTable()->Insert(page_id, frame_id);
+  LoadFrame(&lock, frame_id, victim_page_id, true);
+  stats_.Record(BufferPoolCounter::FETCH_MISSES, BufferPoolLatency::FETCH_MISS, start);
+  return &page;
+}
+
+auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool {
+  frame_id_t frame_id;
+  if (!GetPageTable()->Find(page_id, &frame_id)) {
+    // A lock-free lookup racing with the removal of another page can miss a page that is present; only a miss under
+    // the writer latch is a real one.
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (!GetPageTable()->Find(page_id, &frame_id)) {
+      return false;
+    }
+  }
+
+  // The caller holds a pin on the page, so the frame cannot be recycled under us.
+  Page &page = GetFrame(frame_id);
+  if (page.GetPinCount() <= 0 || page.GetPageId() != page_id) {
+    return false;
   }
+  if (is_dirty && !read_only_) {
+    page.is_dirty_ = true;
+  }
+  if (!UnpinFrame(frame_id)) {
+    return false;
+  }
+  Trace(AccessTraceOp::UNPIN, page_id);
+  // Still release the pin, so that the caller's error handling does not leak it.
+  if (is_dirty) {
+    CheckWritable("write a page");
+  }
+  return true;
+}
 
-  if(pages_[frame_alloted].GetPinCount() <= 0){
+auto BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) -> bool {
+  std::unique_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  if (!PinResidentPage(&lock, page_id, &frame_id)) {
     return false;
   }
-  // pages_[frame_alloted].WLatch();
-  
-  pages_[frame_alloted].pin_count_--;
-  pages_[frame_alloted].is_dirty_ = is_dirty;
+  lock.unlock();
 
-  if(pages_[frame_alloted].GetPinCount() == 0){
-    replacer_->SetEvictable(frame_alloted, true);
+  // Clear the flag before writing, so that a concurrent modification marks the page dirty again. Pages of a read-only
+  // buffer pool are never modified and are already on disk as they are.
+  GetFrame(frame_id).is_dirty_ = false;
+  if (!read_only_) {
+    WritePageToDisk(page_id, GetFrame(frame_id).GetData());
   }
-  // std::cout << "isdirty ? " << pages_[frame_alloted].IsDirty() << std::endl;
-  // pages_[frame_alloted].WUnlatch();
+  UnpinFrame(frame_id);
   return true;
 }
 
-/**
-  * TODO(P1): Add implementation
-  *
-  * @brief Flush the target page to disk.
-  *
-  * Use the DiskManager::WritePage() method to flush a page to disk, REGARDLESS of the dirty flag.
-  * Unset the dirty flag of the page after flushing.
-  *
-  * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
-  * @return false if the page could not be found in the page table, true otherwise
-  */
+void BufferPoolManagerInstance::FlushAllPgsImp() {
+  std::vector<page_id_t> dirty_pages;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    for (size_t i = 0; i < pool_size_; i++) {
+      Page &page = GetFrame(static_cast<frame_id_t>(i));
+      if (frame_states_[i] == FrameState::READY && page.GetPageId() != INVALID_PAGE_ID && page.IsDirty()) {
+        dirty_pages.push_back(page.GetPageId());
+      }
+    }
+  }
+  for (auto page_id : dirty_pages) {
+    FlushPgImp(page_id);
+  }
+  disk_manager_->Sync();
+}
 
-auto BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) -> bool { 
+auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool {
+  CheckWritable("delete a page");
+  Trace(AccessTraceOp::DELETE, page_id);
   std::scoped_lock<std::mutex> lock(latch_);
-  frame_id_t frame_alloted;
-  if(page_table_->Find(page_id, frame_alloted)){
-    // pages_[frame_alloted].WLatch();
-    page_id_t page = pages_[frame_alloted].GetPageId();
-    
-    disk_manager_->WritePage(page, pages_[frame_alloted].GetData());
-    pages_[frame_alloted].is_dirty_ = false;
-    // std::cout << "Flushing dirty page " << pages_[frame_alloted].GetPageId() << " Data: " << pages_[frame_alloted].GetData() << std::endl;
-    // pages_[frame_alloted].WUnlatch();
+  frame_id_t frame_id;
+  if (!GetPageTable()->Find(page_id, &frame_id)) {
+    // A write-back still in flight would land after the page id had been handed out again.
+    if (writing_back_.count(page_id) > 0) {
+      return false;
+    }
+    if (victim_cache_ != nullptr) {
+      victim_cache_->Erase(page_id);
+    }
+    DeallocatePage(page_id);
     return true;
   }
+  // Fails both for pinned pages and for pages whose frame has I/O in flight.
+  if (!LockFrame(frame_id)) {
+    return false;
+  }
 
-  return false; 
-  
+  Page &page = GetFrame(frame_id);
+  GetPageTable()->Remove(page_id);
+  replacer_->Remove(frame_id);
+  page.ResetMemory();
+  page.page_id_ = INVALID_PAGE_ID;
+  page.is_dirty_ = false;
+  GetRingFrame(frame_id).store(false);
+  if (GetResidentFrame(frame_id).exchange(false)) {
+    num_resident_frames_--;
   }
+  page.pin_count_.store(0, std::memory_order_release);
+  free_list_.push_back(frame_id);
 
-void BufferPoolManagerInstance::FlushAllPgsImp() {
+  DeallocatePage(page_id);
+  return true;
+}
 
-  for(size_t i = 0;i < pool_size_;i++){
-    if(pages_[i].IsDirty()){
-      FlushPgImp(pages_[i].GetPageId());
+auto BufferPoolManagerInstance::SetPageResident(page_id_t page_id, bool resident) -> bool {
+  if (!resident) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    frame_id_t frame_id;
+    if (GetPageTable()->Find(page_id, &frame_id) && GetFrame(frame_id).GetPageId() == page_id &&
+        GetResidentFrame(frame_id).exchange(false)) {
+      num_resident_frames_--;
+      // Like a ring frame returned to the replacer: if the frame is pinned, its victimization fails until it is not.
+      replacer_->RecordAccess(frame_id, page_id, GetFrame(frame_id).GetPageClass());
+      replacer_->SetEvictable(frame_id, true);
+    }
+    return true;
+  }
+
+  Page *page = FetchPage(page_id);
+  if (page == nullptr) {
+    return false;
+  }
+  bool made_resident = true;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    // Our pin keeps the page in its frame.
+    frame_id_t frame_id;
+    GetPageTable()->Find(page_id, &frame_id);
+    if (!GetResidentFrame(frame_id).load()) {
+      if (num_resident_frames_ >= pool_size_ / 2) {
+        made_resident = false;
+      } else {
+        GetResidentFrame(frame_id).store(true);
+        num_resident_frames_++;
+        // A ring that still lists the frame sees it outside of the ring and takes a regular victim instead.
+        GetRingFrame(frame_id).store(false);
+        replacer_->SetEvictable(frame_id, false);
+      }
     }
   }
+  UnpinPage(page_id, false);
+  return made_resident;
 }
 
-/**
-  * TODO(P1): Add implementation
-  *
-  * @brief Delete a page from the buffer pool. If page_id is not in the buffer pool, do nothing and return true. If the
-  * page is pinned and cannot be deleted, return false immediately.
-  *
-  * After deleting the page from the page table, stop tracking the frame in the replacer and add the frame
-  * back to the free list. Also, reset the page's memory and metadata. Finally, you should call DeallocatePage() to
-  * imitate freeing the page on the disk.
-  *
-  * @param page_id id of page to be deleted
-  * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
-  */
+auto BufferPoolManagerInstance::Resize(size_t pool_size, std::chrono::milliseconds timeout) -> bool {
+  if (pool_size == 0) {
+    return false;
+  }
+  std::scoped_lock<std::mutex> resize_lock(resize_latch_);
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (pool_size >= pool_size_) {
+      Grow(pool_size);
+      return true;
+    }
+  }
+
+  // Retire one frame per hold of latch_, so that requests keep being served in between.
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (true) {
+    bool retired;
+    {
+      std::unique_lock<std::mutex> lock(latch_);
+      if (pool_size_ <= pool_size) {
+        break;
+      }
+      retired = RetireLastFrame(&lock);
+    }
+    if (retired) {
+      deadline = std::chrono::steady_clock::now() + timeout;
+    } else if (std::chrono::steady_clock::now() >= deadline) {
+      break;
+    } else {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
 
-auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool { 
+  // The replacer keeps its capacity: an unpin that raced with the retirement may still hand it a retired frame, which
+  // it then offers as a victim that fails to lock, like any frame re-pinned through the hit path.
   std::scoped_lock<std::mutex> lock(latch_);
-  frame_id_t frame_allocated;
-  if(!page_table_->Find(page_id, frame_allocated)){
-    return true;
+  free_list_.remove_if([this](frame_id_t frame_id) { return static_cast<size_t>(frame_id) >= pool_size_; });
+  return pool_size_ == pool_size;
+}
+
+void BufferPoolManagerInstance::Grow(size_t pool_size) {
+  const size_t num_chunks = (pool_size + FRAMES_PER_CHUNK - 1) / FRAMES_PER_CHUNK;
+  if (num_chunks > num_chunks_) {
+    auto directory = std::make_unique<FrameChunk *[]>(num_chunks);
+    for (size_t i = 0; i < num_chunks_; i++) {
+      directory[i] = GetChunk(i);
+    }
+    for (size_t i = num_chunks_; i < num_chunks; i++) {
+      auto *chunk = new FrameChunk();
+      chunk->arena_ = new FrameArena(FRAMES_PER_CHUNK, huge_pages_);
+      chunk->pages_ = static_cast<Page *>(::operator new(sizeof(Page) * FRAMES_PER_CHUNK));
+      for (size_t j = 0; j < FRAMES_PER_CHUNK; j++) {
+        new (&chunk->pages_[j]) Page(chunk->arena_->GetFrameData(static_cast<frame_id_t>(j)));
+        chunk->ring_frames_[j].store(false, std::memory_order_relaxed);
+        chunk->resident_frames_[j].store(false, std::memory_order_relaxed);
+      }
+      directory[i] = chunk;
+    }
+    // Readers that loaded the previous directory keep indexing it; it stays valid, as do the chunks it points to.
+    chunks_.store(directory.get(), std::memory_order_release);
+    chunk_directories_.push_back(std::move(directory));
+    num_chunks_ = num_chunks;
   }
-  Page& page = pages_[frame_allocated];
 
-  if(page.GetPinCount() > 0){
-    return false; 
+  if (pool_size > GetPageTable()->GetNumFrames()) {
+    auto *page_table = new ConcurrentPageTable(pool_size);
+    page_table->InsertAll(*GetPageTable());
+    retired_page_tables_.emplace_back(GetPageTable());
+    page_table_.store(page_table, std::memory_order_release);
+  }
+  if (frame_states_.size() < pool_size) {
+    replacer_->SetNumFrames(pool_size);
+    frame_states_.resize(pool_size, FrameState::READY);
+    cleaned_frames_.resize(pool_size, false);
   }
 
-  page_table_->Remove(page_id);
+  for (size_t i = pool_size_; i < pool_size; i++) {
+    // Frames retired by an earlier shrink are still locked; new ones are unpinned already.
+    GetFrame(static_cast<frame_id_t>(i)).pin_count_.store(0, std::memory_order_release);
+    free_list_.emplace_back(static_cast<frame_id_t>(i));
+  }
+  pool_size_ = pool_size;
+}
 
-  replacer_->Remove(frame_allocated);
+auto BufferPoolManagerInstance::RetireLastFrame(std::unique_lock<std::mutex> *lock) -> bool {
+  const auto frame_id = static_cast<frame_id_t>(pool_size_ - 1);
+  // Fails both for pinned frames and for frames whose I/O is in flight.
+  if (!LockFrame(frame_id)) {
+    return false;
+  }
 
-  free_list_.push_back(frame_allocated);
+  Page &page = GetFrame(frame_id);
+  const page_id_t page_id = page.GetPageId();
+  replacer_->Remove(frame_id);
+  if (page_id != INVALID_PAGE_ID) {
+    GetPageTable()->Remove(page_id);
+    if (page.IsDirty()) {
+      // Like the write-back of a victim: requesters of the page wait for it instead of reading a stale copy.
+      frame_states_[frame_id] = FrameState::WRITING_BACK;
+      writing_back_.emplace(page_id, frame_id);
+      lock->unlock();
+      WritePageToDisk(page_id, page.GetData());
+      lock->lock();
+      writing_back_.erase(page_id);
+      frame_states_[frame_id] = FrameState::READY;
+      GetFrameCv(frame_id).notify_all();
+    }
+  }
 
-  page.ResetMemory();
+  // The frame stays locked at -1 until the pool grows again, so stale readers can never pin it.
+  page.page_id_ = INVALID_PAGE_ID;
+  page.is_dirty_ = false;
+  page.data_ = GetFrameData(frame_id);
+  cleaned_frames_[frame_id] = false;
+  GetRingFrame(frame_id).store(false);
+  if (GetResidentFrame(frame_id).exchange(false)) {
+    num_resident_frames_--;
+  }
+  GetChunk(frame_id / FRAMES_PER_CHUNK)->arena_->ReleaseFrameData(frame_id % FRAMES_PER_CHUNK);
+  pool_size_--;
+  return true;
+}
 
-  page.is_dirty_ = true;
+void BufferPoolManagerInstance::RunPageCleaner(size_t dirty_low_watermark, size_t dirty_high_watermark,
+                                               std::chrono::milliseconds interval) {
+  BUSTUB_ASSERT(dirty_low_watermark <= dirty_high_watermark, "low watermark must not exceed the high watermark");
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (page_cleaner_ != nullptr) {
+    return;
+  }
+  page_cleaner_running_ = true;
+  page_cleaner_ = new std::thread([this, dirty_low_watermark, dirty_high_watermark, interval] {
+    PageCleanerLoop(dirty_low_watermark, dirty_high_watermark, interval);
+  });
+}
 
-  page.page_id_ = INVALID_PAGE_ID;
+void BufferPoolManagerInstance::StopPageCleaner() {
+  std::thread *page_cleaner;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    page_cleaner = page_cleaner_;
+    page_cleaner_ = nullptr;
+    page_cleaner_running_ = false;
+    page_cleaner_cv_.notify_all();
+  }
+  if (page_cleaner != nullptr) {
+    page_cleaner->join();
+    delete page_cleaner;
+  }
+}
 
-  DeallocatePage(page_id);
+void BufferPoolManagerInstance::PageCleanerLoop(size_t dirty_low_watermark, size_t dirty_high_watermark,
+                                                std::chrono::milliseconds interval) {
+  std::unique_lock<std::mutex> lock(latch_);
+  size_t clock_hand = 0;
+  while (true) {
+    page_cleaner_cv_.wait_for(lock, interval, [&] { return !page_cleaner_running_ || page_cleaner_wakeup_; });
+    page_cleaner_wakeup_ = false;
+    if (!page_cleaner_running_) {
+      return;
+    }
 
-  return true;
-  
+    size_t num_dirty = 0;
+    for (size_t i = 0; i < pool_size_; i++) {
+      Page &page = GetFrame(static_cast<frame_id_t>(i));
+      if (frame_states_[i] == FrameState::READY && page.GetPageId() != INVALID_PAGE_ID && page.IsDirty()) {
+        num_dirty++;
+      }
+    }
+    if (num_dirty < dirty_high_watermark) {
+      continue;
+    }
+
+    std::vector<std::pair<frame_id_t, page_id_t>> batch;
+    for (size_t scanned = 0; scanned < pool_size_ && num_dirty > dirty_low_watermark && page_cleaner_running_;
+         scanned++, clock_hand = (clock_hand + 1) % pool_size_) {
+      const auto frame_id = static_cast<frame_id_t>(clock_hand);
+      Page &page = GetFrame(frame_id);
+      // Only clean unpinned frames: the 0 -> 1 CAS keeps the frame from being recycled during the write, and
+      // hiding it from the replacer keeps evictors from dropping it on a failed eviction CAS.
+      int unpinned = 0;
+      if (frame_states_[frame_id] != FrameState::READY || page.GetPageId() == INVALID_PAGE_ID || !page.IsDirty() ||
+          !page.pin_count_.compare_exchange_strong(unpinned, 1, std::memory_order_acquire)) {
+        continue;
+      }
+      replacer_->SetEvictable(frame_id, false);
+      batch.emplace_back(frame_id, page.GetPageId());
+      num_dirty--;
+      if (batch.size() == static_cast<size_t>(DISK_IO_BATCH_SIZE)) {
+        CleanFrames(&lock, &batch);
+      }
+    }
+    if (!batch.empty()) {
+      CleanFrames(&lock, &batch);
+    }
+  }
+}
+
+void BufferPoolManagerInstance::CleanFrames(std::unique_lock<std::mutex> *lock,
+                                            std::vector<std::pair<frame_id_t, page_id_t>> *batch) {
+  lock->unlock();
+  // Write copies, so that no page latch is held across the I/O: holding the read latches of a whole batch could
+  // deadlock with a thread that write-latches the same pages in another order. The copies are aligned like the
+  // frames, for disk managers using O_DIRECT.
+  std::unique_ptr<char, decltype(&std::free)> buffer(
+      static_cast<char *>(std::aligned_alloc(BUSTUB_PAGE_SIZE, batch->size() * BUSTUB_PAGE_SIZE)), &std::free);
+  std::vector<DiskRequest> requests;
+  for (size_t i = 0; i < batch->size(); i++) {
+    const auto [frame_id, page_id] = (*batch)[i];
+    Page &page = GetFrame(frame_id);
+    char *copy = buffer.get() + i * BUSTUB_PAGE_SIZE;
+    page.RLatch();
+    page.is_dirty_ = false;
+    memcpy(copy, page.GetData(), BUSTUB_PAGE_SIZE);
+    page.RUnlatch();
+    requests.push_back(DiskRequest{true, copy, page_id, std::promise<bool>()});
+  }
+  auto written = SubmitDiskRequests(&requests);
+
+  lock->lock();
+  for (size_t i = 0; i < batch->size(); i++) {
+    const frame_id_t frame_id = (*batch)[i].first;
+    Page &page = GetFrame(frame_id);
+    if (written[i]) {
+      cleaned_frames_[frame_id] = true;
+      stats_.Add(BufferPoolCounter::CLEANER_WRITE_BACKS);
+    } else {
+      page.is_dirty_ = true;
+    }
+    // Unlike UnpinFrame(), do not record an access: cleaning must not make the page look recently used. Unless the
+    // frame is gone from the replacer: a user's unpin that raced with the cleaner's pin may have made it evictable,
+    // and an evictor then took it out of the replacer but failed to lock it.
+    if (page.pin_count_.fetch_sub(1, std::memory_order_release) == 1) {
+      if (!replacer_->IsTracked(frame_id) && !GetRingFrame(frame_id).load() && !GetResidentFrame(frame_id).load()) {
+        replacer_->RecordAccess(frame_id, page.GetPageId(), page.GetPageClass());
+      }
+      replacer_->SetEvictable(frame_id, true);
+    }
+  }
+  batch->clear();
+}
+
+void BufferPoolManagerInstance::PrefetchPages(const std::vector<page_id_t> &page_ids, BufferAccessStrategy *strategy) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // A bounded queue keeps a long read-ahead window from evicting the pages it prefetched before they are used.
+  for (auto page_id : page_ids) {
+    if (prefetch_queue_.size() >= pool_size_ / 2) {
+      break;
+    }
+    ValidatePageId(page_id);
+    prefetch_queue_.emplace_back(page_id, strategy);
+  }
+  WakePrefetcher();
+}
+
+void BufferPoolManagerInstance::WarmUp(const std::vector<page_id_t> &page_ids) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  const size_t num_pages = std::min(page_ids.size(), free_list_.size());
+  for (size_t i = 0; i < num_pages; i++) {
+    ValidatePageId(page_ids[i]);
+    prefetch_queue_.emplace_back(page_ids[i], nullptr);
+  }
+  WakePrefetcher();
+}
+
+void BufferPoolManagerInstance::WakePrefetcher() {
+  if (prefetch_queue_.empty()) {
+    return;
+  }
+  if (prefetcher_ == nullptr) {
+    prefetcher_running_ = true;
+    prefetcher_ = new std::thread([this] { PrefetcherLoop(); });
+  }
+  prefetch_cv_.notify_one();
+}
+
+auto BufferPoolManagerInstance::GetHotPages() -> std::vector<page_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> frame_ids;
+  for (size_t i = 0; i < pool_size_; i++) {
+    if (GetFrame(static_cast<frame_id_t>(i)).GetPageId() != INVALID_PAGE_ID && frame_states_[i] == FrameState::READY) {
+      frame_ids.push_back(static_cast<frame_id_t>(i));
+    }
   }
+  replacer_->RankByHotness(&frame_ids);
+
+  std::vector<page_id_t> page_ids;
+  page_ids.reserve(frame_ids.size());
+  for (auto frame_id : frame_ids) {
+    page_ids.push_back(GetFrame(frame_id).GetPageId());
+  }
+  return page_ids;
+}
+
+void BufferPoolManagerInstance::PrefetcherLoop() {
+  std::unique_lock<std::mutex> lock(latch_);
+  std::vector<std::pair<frame_id_t, page_id_t>> loads;
+  while (true) {
+    prefetch_cv_.wait(lock, [&] { return !prefetcher_running_ || !prefetch_queue_.empty(); });
+    if (!prefetcher_running_) {
+      return;
+    }
+
+    while (!prefetch_queue_.empty() && loads.size() < static_cast<size_t>(DISK_IO_BATCH_SIZE)) {
+      const auto [page_id, strategy] = prefetch_queue_.front();
+      prefetch_queue_.pop_front();
+
+      // Page table writers hold latch_, so this lookup is exact. Pages being written back are not re-read either, and
+      // neither are deleted pages, whose ids NewPage() may hand out again.
+      frame_id_t frame_id;
+      if (page_id == INVALID_PAGE_ID || !disk_manager_->IsPageAllocated(page_id) ||
+          GetPageTable()->Find(page_id, &frame_id) || writing_back_.count(page_id) > 0) {
+        continue;
+      }
+      page_id_t victim_page_id;
+      if (!AcquireFrame(&frame_id, &victim_page_id, strategy)) {
+        // Every frame is pinned; the rest of the window would fail the same way.
+        prefetch_queue_.clear();
+        break;
+      }
+
+      // Same protocol as a FetchPage() miss: a concurrent fetch of the page waits for this load instead of reading
+      // it.
+      GetFrame(frame_id).page_id_ = page_id;
+      GetPageTable()->Insert(page_id, frame_id);
+      loads.emplace_back(frame_id, victim_page_id);
+    }
+    if (loads.empty()) {
+      continue;
+    }
 
-auto BufferPoolManagerInstance::AllocatePage() -> page_id_t { 
-  // std::scoped_lock<std::mutex> lock(latch_);
-  return next_page_id_++; 
+    auto loaded = LoadFrames(&lock, loads);
+    for (size_t i = 0; i < loads.size(); i++) {
+      if (loaded[i]) {
+        stats_.Add(BufferPoolCounter::PREFETCHED_PAGES);
+        UnpinFrame(loads[i].first);
+      }
+    }
+    loads.clear();
   }
+}
+
+auto BufferPoolManagerInstance::LoadFrames(std::unique_lock<std::mutex> *lock,
+                                           const std::vector<std::pair<frame_id_t, page_id_t>> &loads)
+    -> std::vector<bool> {
+  std::vector<bool> loaded(loads.size(), true);
+  std::vector<DiskRequest> requests;
+  std::vector<size_t> request_loads;
+  std::vector<std::pair<frame_id_t, page_id_t>> demotions;
+  for (size_t i = 0; i < loads.size(); i++) {
+    const auto [frame_id, victim_page_id] = loads[i];
+    if (victim_page_id != INVALID_PAGE_ID) {
+      frame_states_[frame_id] = FrameState::WRITING_BACK;
+      writing_back_.emplace(victim_page_id, frame_id);
+      if (GetFrame(frame_id).IsDirty()) {
+        requests.push_back(DiskRequest{true, GetFrame(frame_id).GetData(), victim_page_id, std::promise<bool>()});
+        request_loads.push_back(i);
+      } else {
+        demotions.emplace_back(frame_id, victim_page_id);
+      }
+    }
+  }
+  if (!requests.empty() || !demotions.empty()) {
+    lock->unlock();
+    for (const auto &[frame_id, victim_page_id] : demotions) {
+      victim_cache_->Insert(victim_page_id, GetFrame(frame_id).GetData());
+    }
+    auto written = SubmitDiskRequests(&requests);
+    lock->lock();
+    for (size_t i = 0; i < written.size(); i++) {
+      if (written[i]) {
+        continue;
+      }
+      // Like a failed cleaning, the victim stays dirty in its frame; the page to load is left to a later fetch.
+      const size_t load = request_loads[i];
+      const auto [frame_id, victim_page_id] = loads[load];
+      Page &page = GetFrame(frame_id);
+      loaded[load] = false;
+      GetPageTable()->Remove(page.GetPageId());
+      page.page_id_ = victim_page_id;
+      GetPageTable()->Insert(victim_page_id, frame_id);
+      GetRingFrame(frame_id).store(false);
+      frame_states_[frame_id] = FrameState::READY;
+      page.pin_count_.store(0, std::memory_order_release);
+      replacer_->RecordAccess(frame_id, victim_page_id, page.GetPageClass());
+      replacer_->SetEvictable(frame_id, true);
+    }
+    for (const auto &[frame_id, victim_page_id] : loads) {
+      if (victim_page_id != INVALID_PAGE_ID) {
+        writing_back_.erase(victim_page_id);
+        GetFrameCv(frame_id).notify_all();
+      }
+    }
+  }
+
+  requests.clear();
+  request_loads.clear();
+  std::vector<size_t> reads;
+  for (size_t i = 0; i < loads.size(); i++) {
+    if (!loaded[i]) {
+      continue;
+    }
+    Page &page = GetFrame(loads[i].first);
+    page.is_dirty_ = false;
+    if (MapFrame(loads[i].first, true)) {
+      continue;
+    }
+    page.ResetMemory();
+    frame_states_[loads[i].first] = FrameState::LOADING;
+    reads.push_back(i);
+  }
+  if (!reads.empty()) {
+    lock->unlock();
+    for (auto load : reads) {
+      Page &page = GetFrame(loads[load].first);
+      if (victim_cache_ == nullptr || !victim_cache_->Take(page.GetPageId(), page.GetData())) {
+        requests.push_back(DiskRequest{false, page.GetData(), page.GetPageId(), std::promise<bool>()});
+        request_loads.push_back(load);
+      }
+    }
+    auto read = SubmitDiskRequests(&requests);
+    lock->lock();
+    for (size_t i = 0; i < read.size(); i++) {
+      if (read[i]) {
+        continue;
+      }
+      // Drop the page rather than publish a zeroed frame for it, so that the next fetch reads it again.
+      const frame_id_t frame_id = loads[request_loads[i]].first;
+      Page &page = GetFrame(frame_id);
+      loaded[request_loads[i]] = false;
+      GetPageTable()->Remove(page.GetPageId());
+      page.ResetMemory();
+      page.page_id_ = INVALID_PAGE_ID;
+      GetRingFrame(frame_id).store(false);
+      frame_states_[frame_id] = FrameState::READY;
+      page.pin_count_.store(0, std::memory_order_release);
+      free_list_.push_back(frame_id);
+      GetFrameCv(frame_id).notify_all();
+    }
+  }
+
+  for (size_t i = 0; i < loads.size(); i++) {
+    if (!loaded[i]) {
+      continue;
+    }
+    frame_states_[loads[i].first] = FrameState::READY;
+    // Publishing the pin count releases the frame to hit-path readers.
+    GetFrame(loads[i].first).pin_count_.store(1, std::memory_order_release);
+    GetFrameCv(loads[i].first).notify_all();
+  }
+  return loaded;
+}
+
+void BufferPoolManagerInstance::ReleaseStrategy(BufferAccessStrategy *strategy) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  for (auto it = prefetch_queue_.begin(); it != prefetch_queue_.end();) {
+    it = it->second == strategy ? prefetch_queue_.erase(it) : std::next(it);
+  }
+  auto &ring = strategy->GetRing(instance_index_);
+  for (auto frame_id : ring.frames_) {
+    ReturnRingFrame(frame_id);
+  }
+  ring.frames_.clear();
+  ring.next_ = 0;
+}
+
+auto BufferPoolManagerInstance::AllocatePage() -> page_id_t {
+  // Stride by the number of shards so that every id maps back to this instance.
+  const page_id_t page_id = disk_manager_->AllocatePage(num_instances_, instance_index_);
+  ValidatePageId(page_id);
+  return page_id;
+}
+
+void BufferPoolManagerInstance::DeallocatePage(page_id_t page_id) { disk_manager_->DeallocatePage(page_id); }
+
+void BufferPoolManagerInstance::ValidatePageId(const page_id_t page_id) const {
+  BUSTUB_ASSERT(page_id % num_instances_ == instance_index_, "allocated pages mod back to this BPI");
+}
 
 }  // namespace bustub
\ No newline at end of file
@@ -0,0 +1,133 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats.cpp
+//
+// Identification: src/buffer/buffer_pool_stats.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_stats.h"
+
+namespace bustub {
+
+auto BufferPoolCounterToString(BufferPoolCounter counter) -> std::string {
+  switch (counter) {
+    case BufferPoolCounter::FETCH_HITS:
+      return "fetch_hits";
+    case BufferPoolCounter::FETCH_MISSES:
+      return "fetch_misses";
+    case BufferPoolCounter::NEW_PAGES:
+      return "new_pages";
+    case BufferPoolCounter::EVICTIONS:
+      return "evictions";
+    case BufferPoolCounter::DIRTY_WRITE_BACKS:
+      return "dirty_write_backs";
+    case BufferPoolCounter::CLEANER_WRITE_BACKS:
+      return "cleaner_write_backs";
+    case BufferPoolCounter::AVOIDED_WRITE_BACKS:
+      return "avoided_write_backs";
+    case BufferPoolCounter::PREFETCHED_PAGES:
+      return "prefetched_pages";
+    case BufferPoolCounter::PIN_WAITS:
+      return "pin_waits";
+    case BufferPoolCounter::DISK_READS:
+      return "disk_reads";
+    case BufferPoolCounter::DISK_WRITES:
+      return "disk_writes";
+    case BufferPoolCounter::NUM_COUNTERS:
+      break;
+  }
+  return "unknown";
+}
+
+auto BufferPoolLatencyToString(BufferPoolLatency latency) -> std::string {
+  switch (latency) {
+    case BufferPoolLatency::FETCH_HIT:
+      return "fetch_hit";
+    case BufferPoolLatency::FETCH_MISS:
+      return "fetch_miss";
+    case BufferPoolLatency::PIN_WAIT:
+      return "pin_wait";
+    case BufferPoolLatency::DISK_READ:
+      return "disk_read";
+    case BufferPoolLatency::DISK_WRITE:
+      return "disk_write";
+    case BufferPoolLatency::NUM_LATENCIES:
+      break;
+  }
+  return "unknown";
+}
+
+auto LatencyHistogram::operator+=(const LatencyHistogram &other) -> LatencyHistogram & {
+  for (size_t i = 0; i < NUM_BUCKETS; i++) {
+    buckets_[i] += other.buckets_[i];
+  }
+  count_ += other.count_;
+  sum_ns_ += other.sum_ns_;
+  return *this;
+}
+
+auto LatencyHistogram::GetPercentileNs(double percentile) const -> uint64_t {
+  if (count_ == 0) {
+    return 0;
+  }
+  // The rank of the percentile, counting from 1, so that p0 is the smallest latency and p100 the largest.
+  auto rank = static_cast<uint64_t>(percentile / 100 * static_cast<double>(count_ - 1)) + 1;
+  uint64_t seen = 0;
+  for (size_t i = 0; i < NUM_BUCKETS; i++) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      return (uint64_t{2} << i) - 1;
+    }
+  }
+  return (uint64_t{2} << (NUM_BUCKETS - 1)) - 1;
+}
+
+auto BufferPoolStats::operator+=(const BufferPoolStats &other) -> BufferPoolStats & {
+  for (size_t i = 0; i < counters_.size(); i++) {
+    counters_[i] += other.counters_[i];
+  }
+  for (size_t i = 0; i < latencies_.size(); i++) {
+    latencies_[i] += other.latencies_[i];
+  }
+  return *this;
+}
+
+auto BufferPoolStatsCollector::GetThreadShard() -> size_t {
+  static std::atomic<size_t> next_shard{0};
+  thread_local const size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % NUM_SHARDS;
+  return shard;
+}
+
+auto BufferPoolStatsCollector::Get(BufferPoolCounter counter) const -> uint64_t {
+  uint64_t count = 0;
+  for (const auto &shard : shards_) {
+    count += shard.counters_[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+  }
+  return count;
+}
+
+auto BufferPoolStatsCollector::GetSnapshot() const -> BufferPoolStats {
+  BufferPoolStats stats;
+  for (const auto &shard : shards_) {
+    for (size_t i = 0; i < stats.counters_.size(); i++) {
+      stats.counters_[i] += shard.counters_[i].load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < stats.latencies_.size(); i++) {
+      auto &histogram = stats.latencies_[i];
+      for (size_t j = 0; j < LatencyHistogram::NUM_BUCKETS; j++) {
+        auto count = shard.latencies_[i].buckets_[j].load(std::memory_order_relaxed);
+        histogram.buckets_[j] += count;
+        histogram.count_ += count;
+      }
+      histogram.sum_ns_ += shard.latencies_[i].sum_ns_.load(std::memory_order_relaxed);
+    }
+  }
+  return stats;
+}
+
+}  // namespace bustub
@@ -0,0 +1,100 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// concurrent_page_table.cpp
+//
+// Identification: src/buffer/concurrent_page_table.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/concurrent_page_table.h"
+
+namespace bustub {
+
+ConcurrentPageTable::ConcurrentPageTable(size_t num_frames) : num_frames_(num_frames) {
+  capacity_ = 2;
+  while (capacity_ < 2 * num_frames) {
+    capacity_ <<= 1;
+  }
+  mask_ = capacity_ - 1;
+  slots_ = std::make_unique<std::atomic<uint64_t>[]>(capacity_);
+  for (size_t i = 0; i < capacity_; i++) {
+    slots_[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+  }
+}
+
+auto ConcurrentPageTable::HomeOf(page_id_t page_id) const -> size_t {
+  // Fibonacci hashing spreads the sequential page ids handed out by AllocatePage over the whole table.
+  return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(page_id)) * 0x9E3779B97F4A7C15ULL) >> 32) &
+         mask_;
+}
+
+auto ConcurrentPageTable::Find(page_id_t page_id, frame_id_t *frame_id) const -> bool {
+  for (size_t i = HomeOf(page_id), probes = 0; probes < capacity_; i = (i + 1) & mask_, probes++) {
+    auto slot = slots_[i].load(std::memory_order_acquire);
+    if (slot == EMPTY_SLOT) {
+      return false;
+    }
+    if (PageIdOf(slot) == page_id) {
+      *frame_id = FrameIdOf(slot);
+      return true;
+    }
+  }
+  return false;
+}
+
+void ConcurrentPageTable::Insert(page_id_t page_id, frame_id_t frame_id) {
+  for (size_t i = HomeOf(page_id);; i = (i + 1) & mask_) {
+    auto slot = slots_[i].load(std::memory_order_relaxed);
+    BUSTUB_ASSERT(slot == EMPTY_SLOT || PageIdOf(slot) != page_id, "page is already in the page table");
+    if (slot == EMPTY_SLOT) {
+      slots_[i].store(Pack(page_id, frame_id), std::memory_order_release);
+      return;
+    }
+  }
+}
+
+auto ConcurrentPageTable::Remove(page_id_t page_id) -> bool {
+  size_t hole = HomeOf(page_id);
+  while (true) {
+    auto slot = slots_[hole].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT) {
+      return false;
+    }
+    if (PageIdOf(slot) == page_id) {
+      break;
+    }
+    hole = (hole + 1) & mask_;
+  }
+
+  // Backward-shift deletion: pull every later entry of the probe chain that may live in the hole into it, so that
+  // the chain never contains an empty slot in front of an entry.
+  for (size_t i = (hole + 1) & mask_;; i = (i + 1) & mask_) {
+    auto slot = slots_[i].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT) {
+      break;
+    }
+    size_t home = HomeOf(PageIdOf(slot));
+    // The entry may move into the hole iff the hole lies cyclically in [home, i).
+    if (((i - home) & mask_) >= ((i - hole) & mask_)) {
+      slots_[hole].store(slot, std::memory_order_release);
+      hole = i;
+    }
+  }
+  slots_[hole].store(EMPTY_SLOT, std::memory_order_release);
+  return true;
+}
+
+void ConcurrentPageTable::InsertAll(const ConcurrentPageTable &other) {
+  for (size_t i = 0; i < other.capacity_; i++) {
+    auto slot = other.slots_[i].load(std::memory_order_relaxed);
+    if (slot != EMPTY_SLOT) {
+      Insert(PageIdOf(slot), FrameIdOf(slot));
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.cpp
+//
+// Identification: src/buffer/frame_arena.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_arena.h"
+
+#include <sys/mman.h>
+#include <algorithm>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+namespace {
+
+/** Size of a huge page on the platforms we run on. */
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+}  // namespace
+
+FrameArena::FrameArena(size_t num_frames, bool huge_pages)
+    : data_(nullptr), size_(std::max<size_t>(1, num_frames) * BUSTUB_PAGE_SIZE) {
+  void *data = MAP_FAILED;
+#ifdef MAP_HUGETLB
+  if (huge_pages) {
+    const size_t huge_size = (size_ + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    data = mmap(nullptr, huge_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (data != MAP_FAILED) {
+      size_ = huge_size;
+      huge_tlb_ = true;
+    }
+  }
+#endif
+  if (data == MAP_FAILED) {
+    // Anonymous mappings are page aligned and zero filled.
+    data = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot map the frame arena");
+    }
+#ifdef MADV_HUGEPAGE
+    if (huge_pages) {
+      madvise(data, size_, MADV_HUGEPAGE);
+    }
+#endif
+  }
+  data_ = static_cast<char *>(data);
+}
+
+FrameArena::~FrameArena() { munmap(data_, size_); }
+
+void FrameArena::ReleaseFrameData(frame_id_t frame_id) {
+  // Huge pages can only be released as a whole.
+  if (!huge_tlb_) {
+    madvise(GetFrameData(frame_id), BUSTUB_PAGE_SIZE, MADV_DONTNEED);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hot_page_set.cpp
+//
+// Identification: src/buffer/hot_page_set.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/hot_page_set.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace bustub {
+
+namespace {
+
+constexpr char HOT_PAGE_SET_MAGIC[] = "BTWARM01";
+constexpr size_t HOT_PAGE_SET_MAGIC_SIZE = sizeof(HOT_PAGE_SET_MAGIC) - 1;
+
+}  // namespace
+
+auto HotPageSet::Save(const std::string &file_name, const std::vector<page_id_t> &page_ids) -> bool {
+  const std::string tmp_file_name = file_name + ".tmp";
+  {
+    std::ofstream file(tmp_file_name, std::ios::binary | std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+      return false;
+    }
+    file.write(HOT_PAGE_SET_MAGIC, HOT_PAGE_SET_MAGIC_SIZE);
+    file.write(reinterpret_cast<const char *>(page_ids.data()),
+               static_cast<std::streamsize>(page_ids.size() * sizeof(page_id_t)));
+    if (!file.good()) {
+      remove(tmp_file_name.c_str());
+      return false;
+    }
+  }
+  return rename(tmp_file_name.c_str(), file_name.c_str()) == 0;
+}
+
+auto HotPageSet::Load(const std::string &file_name) -> std::vector<page_id_t> {
+  std::ifstream file(file_name, std::ios::binary | std::ios::in);
+  char magic[HOT_PAGE_SET_MAGIC_SIZE];
+  if (!file.is_open() || !file.read(magic, HOT_PAGE_SET_MAGIC_SIZE) ||
+      memcmp(magic, HOT_PAGE_SET_MAGIC, HOT_PAGE_SET_MAGIC_SIZE) != 0) {
+    return {};
+  }
+  std::vector<page_id_t> page_ids;
+  page_id_t page_id;
+  while (file.read(reinterpret_cast<char *>(&page_id), sizeof(page_id))) {
+    page_ids.push_back(page_id);
+  }
+  return page_ids;
+}
+
+}  // namespace bustub
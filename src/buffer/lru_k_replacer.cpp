@@ -11,135 +11,140 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/lru_k_replacer.h"
-#include <bits/types/time_t.h>
-#include <cstddef>
-#include <ctime>
-#include <limits>
-#include "common/config.h"
-#include <iostream>
-#include <ostream>
-#include <chrono>
-#include <thread>
+
+#include <algorithm>
+
 namespace bustub {
 
-LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k)
+    : replacer_size_(num_frames),
+      k_(k),
+      history_(num_frames * k),
+      history_head_(num_frames, 0),
+      history_size_(num_frames, 0),
+      evictable_(num_frames, false),
+      class_priority_(num_frames, 0) {
+  BUSTUB_ASSERT(k > 0, "k must be positive");
+}
 
+auto LRUKReplacer::GetEvictionKey(frame_id_t frame_id) const -> EvictionKey {
+  // Once the ring is full, its oldest slot holds the kth most recent access; before that, the earliest one.
+  const auto oldest = history_[frame_id * k_ + history_head_[frame_id]];
+  return {class_priority_[frame_id], history_size_[frame_id] == k_, oldest, frame_id};
 }
 
 auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
-    std::scoped_lock<std::mutex> lock(latch_);
-    // std::cout << "Prev" << *frame_id << std::endl;
-    time_t dist_max = -1;
-    frame_id_t &f = *frame_id;
-    bool flag = false;
-    time_t earliest_timestamp = std::numeric_limits<time_t>::max();
-
-    for(auto& kv : access_history_){
-        auto frame = kv.first;
-        auto d = kv.second.size() == k_ ? kv.second[k_-1]-kv.second[0] : std::numeric_limits<time_t>::max();
-        
-        if(is_evicted_[frame]){
-            flag = true;
-            if(d > dist_max){
-                
-                dist_max = d;
-                f = frame;
-                earliest_timestamp = kv.second[0];
-
-            }else if(d == dist_max){
-                if(earliest_timestamp > kv.second[0]){
-                    f = frame;
-                    earliest_timestamp = kv.second[0];
-                }
-            }
-            // std::cout << "distance " << d << " timestamp " << kv.second[0] << " frame " << frame << std::endl;
-        }
-    }
-    
-    if(flag){
-        // std::cout << "Next << " << *frame_id << std::endl;
-        access_history_.erase(*frame_id);
-        is_evicted_.erase(*frame_id);
-        curr_size_--;
-        return true;
-    }
-    return false; 
-     
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (evictable_frames_.empty()) {
+    return false;
+  }
+  *frame_id = std::get<3>(*evictable_frames_.begin());
+  evictable_frames_.erase(evictable_frames_.begin());
+  history_head_[*frame_id] = 0;
+  history_size_[*frame_id] = 0;
+  evictable_[*frame_id] = false;
+  curr_size_--;
+  return true;
 }
 
-void LRUKReplacer::RecordAccess(frame_id_t frame_id) {
-    std::scoped_lock<std::mutex> lock(latch_);
-    //bring in the page
-    if (access_history_.count(frame_id) == 0 && access_history_.size() == replacer_size_) {
-        return;
-    }
-    if(access_history_.count(frame_id) == 0){
-        is_evicted_[frame_id] = false;
-    }
-    // auto t = std::time(nullptr);
-    auto current_time = std::chrono::system_clock::now();
-
-    // Convert the current time point to milliseconds
-    auto timestamp = std::chrono::time_point_cast<std::chrono::milliseconds>(current_time);
-    
-    // for(int i= 0;i < 10000000;i++){
-
-    // }
-    // Extract the number of milliseconds
-    auto milliseconds = timestamp.time_since_epoch().count();
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    access_history_[frame_id].push_back(milliseconds);
-    
-    if(access_history_[frame_id].size() > k_){
-        auto it = access_history_[frame_id].begin();
-        access_history_[frame_id].erase(it);
-        
+void LRUKReplacer::RecordAccess(frame_id_t frame_id) { RecordAccess(frame_id, INVALID_PAGE_ID, PageClass::UNKNOWN); }
+
+void LRUKReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id, PageClass page_class) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  if (evictable_[frame_id]) {
+    evictable_frames_.erase(GetEvictionKey(frame_id));
+  }
+
+  class_priority_[frame_id] = priorities_[static_cast<size_t>(page_class)];
+  auto &head = history_head_[frame_id];
+  auto &size = history_size_[frame_id];
+  const size_t timestamp = current_timestamp_++;
+  if (size < k_) {
+    history_[frame_id * k_ + (head + size) % k_] = timestamp;
+    size++;
+  } else {
+    history_[frame_id * k_ + head] = timestamp;
+    head = (head + 1) % k_;
+  }
+
+  if (evictable_[frame_id]) {
+    evictable_frames_.insert(GetEvictionKey(frame_id));
+  }
+}
+
+void LRUKReplacer::RankByHotness(std::vector<frame_id_t> *frame_ids) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto is_tracked = [this](frame_id_t frame_id) {
+    return static_cast<size_t>(frame_id) < replacer_size_ && history_size_[frame_id] > 0;
+  };
+  std::stable_sort(frame_ids->begin(), frame_ids->end(), [&](frame_id_t a, frame_id_t b) {
+    if (!is_tracked(a) || !is_tracked(b)) {
+      return is_tracked(a) && !is_tracked(b);
     }
-    // std::cout << "Record Access : " << frame_id << " " << is_evicted_[frame_id] << std::endl;
+    return GetEvictionKey(a) > GetEvictionKey(b);
+  });
 }
 
-void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
-    std::scoped_lock<std::mutex> lock(latch_);
+void LRUKReplacer::SetPageClassPriorities(const PageClassPriorities &priorities) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  priorities_ = priorities;
+}
 
-    if(access_history_.count(frame_id) == 0){
+void LRUKReplacer::SetNumFrames(size_t num_frames) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // The histories are laid out frame by frame, so resizing keeps those of the frames below num_frames in place.
+  replacer_size_ = num_frames;
+  history_.resize(num_frames * k_);
+  history_head_.resize(num_frames, 0);
+  history_size_.resize(num_frames, 0);
+  evictable_.resize(num_frames, false);
+  class_priority_.resize(num_frames, 0);
+}
 
-        return;
-    }
+void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  if (history_size_[frame_id] == 0 || evictable_[frame_id] == set_evictable) {
+    return;
+  }
+
+  evictable_[frame_id] = set_evictable;
+  if (set_evictable) {
+    evictable_frames_.insert(GetEvictionKey(frame_id));
+    curr_size_++;
+  } else {
+    evictable_frames_.erase(GetEvictionKey(frame_id));
+    curr_size_--;
+  }
+}
 
-    if(is_evicted_[frame_id] && !set_evictable){
-        // std::cout << "Turning back from evicted to non-evicted" << frame_id << std::endl;
-        is_evicted_[frame_id] = set_evictable;
-        curr_size_--;
-    }else if(!is_evicted_[frame_id] && set_evictable){
-        // std::cout << "Turning back from non-evicted to evicted" << frame_id << std::endl;
-        is_evicted_[frame_id] = set_evictable;
-        curr_size_++;
-    }
-    // std::cout << "Record Update: " << frame_id << " " << is_evicted_[frame_id] << std::endl;
-    // std::cout << curr_size_ << std::endl;
+auto LRUKReplacer::IsTracked(frame_id_t frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return static_cast<size_t>(frame_id) < replacer_size_ && history_size_[frame_id] > 0;
 }
 
 void LRUKReplacer::Remove(frame_id_t frame_id) {
-    std::scoped_lock<std::mutex> lock(latch_);
-    if(access_history_.count(frame_id) == 0 || !is_evicted_[frame_id]){
-        return;
-    }
-
-    access_history_.erase(frame_id);
-    is_evicted_.erase(frame_id);
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  if (history_size_[frame_id] == 0) {
+    return;
+  }
+
+  // A frame that is not evictable, e.g. the frame of a deleted resident page, still loses its history, so that the
+  // next page in the frame does not inherit it.
+  if (evictable_[frame_id]) {
+    evictable_frames_.erase(GetEvictionKey(frame_id));
     curr_size_--;
+  }
+  history_head_[frame_id] = 0;
+  history_size_[frame_id] = 0;
+  evictable_[frame_id] = false;
 }
 
-auto LRUKReplacer::Size() -> size_t { 
-    std::scoped_lock<std::mutex> lock(latch_);
-    // std::cout << "To be evicted "; 
-    // for(auto it : is_evicted_){
-    //     if(it.second){
-    //         std::cout << it.first << " ";
-    //     }
-    // }
-    // std::cout << "currsize " << curr_size_ << std::endl;
-    return curr_size_;
-    }
+auto LRUKReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
 
-}  // namespace bustub
\ No newline at end of file
+}  // namespace bustub
@@ -0,0 +1,186 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.cpp
+//
+// Identification: src/buffer/parallel_buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                                                     size_t replacer_k, LogManager *log_manager,
+                                                     ReplacerType replacer_type) {
+  BUSTUB_ASSERT(num_instances > 0, "a parallel buffer pool needs at least one instance");
+  instances_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; i++) {
+    instances_.emplace_back(std::make_unique<BufferPoolManagerInstance>(
+        pool_size, static_cast<uint32_t>(num_instances), static_cast<uint32_t>(i), disk_manager, replacer_k,
+        log_manager, replacer_type));
+  }
+}
+
+ParallelBufferPoolManager::~ParallelBufferPoolManager() = default;
+
+auto ParallelBufferPoolManager::GetPoolSize() -> size_t {
+  size_t pool_size = 0;
+  for (auto &instance : instances_) {
+    pool_size += instance->GetPoolSize();
+  }
+  return pool_size;
+}
+
+auto ParallelBufferPoolManager::Resize(size_t pool_size) -> bool {
+  if (pool_size < instances_.size()) {
+    return false;
+  }
+  bool resized = true;
+  for (size_t i = 0; i < instances_.size(); i++) {
+    const size_t instance_size = pool_size / instances_.size() + (i < pool_size % instances_.size() ? 1 : 0);
+    resized = instances_[i]->Resize(instance_size) && resized;
+  }
+  return resized;
+}
+
+auto ParallelBufferPoolManager::GetStats() -> BufferPoolStats {
+  BufferPoolStats stats;
+  for (auto &instance : instances_) {
+    stats += instance->GetStats();
+  }
+  return stats;
+}
+
+auto ParallelBufferPoolManager::GetVictimCacheStats() -> VictimCacheStats {
+  VictimCacheStats stats;
+  for (auto &instance : instances_) {
+    stats += instance->GetVictimCacheStats();
+  }
+  return stats;
+}
+
+auto ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) -> BufferPoolManagerInstance * {
+  return instances_[static_cast<size_t>(page_id) % instances_.size()].get();
+}
+
+void ParallelBufferPoolManager::RunPageCleaner(size_t dirty_low_watermark, size_t dirty_high_watermark,
+                                               std::chrono::milliseconds interval) {
+  for (auto &instance : instances_) {
+    instance->RunPageCleaner(dirty_low_watermark, dirty_high_watermark, interval);
+  }
+}
+
+void ParallelBufferPoolManager::StopPageCleaner() {
+  for (auto &instance : instances_) {
+    instance->StopPageCleaner();
+  }
+}
+
+auto ParallelBufferPoolManager::FetchPageWithStrategy(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * {
+  return GetBufferPoolManager(page_id)->FetchPageWithStrategy(page_id, strategy);
+}
+
+void ParallelBufferPoolManager::PrefetchPages(const std::vector<page_id_t> &page_ids,
+                                              BufferAccessStrategy *strategy) {
+  std::vector<std::vector<page_id_t>> shard_page_ids(instances_.size());
+  for (auto page_id : page_ids) {
+    if (page_id != INVALID_PAGE_ID) {
+      shard_page_ids[static_cast<size_t>(page_id) % instances_.size()].push_back(page_id);
+    }
+  }
+  for (size_t i = 0; i < instances_.size(); i++) {
+    if (!shard_page_ids[i].empty()) {
+      instances_[i]->PrefetchPages(shard_page_ids[i], strategy);
+    }
+  }
+}
+
+void ParallelBufferPoolManager::ReleaseStrategy(BufferAccessStrategy *strategy) {
+  for (auto &instance : instances_) {
+    instance->ReleaseStrategy(strategy);
+  }
+}
+
+auto ParallelBufferPoolManager::GetHotPages() -> std::vector<page_id_t> {
+  std::vector<std::vector<page_id_t>> shard_hot_pages;
+  size_t max_size = 0;
+  for (auto &instance : instances_) {
+    shard_hot_pages.push_back(instance->GetHotPages());
+    max_size = std::max(max_size, shard_hot_pages.back().size());
+  }
+  std::vector<page_id_t> hot_pages;
+  for (size_t rank = 0; rank < max_size; rank++) {
+    for (const auto &shard : shard_hot_pages) {
+      if (rank < shard.size()) {
+        hot_pages.push_back(shard[rank]);
+      }
+    }
+  }
+  return hot_pages;
+}
+
+void ParallelBufferPoolManager::WarmUp(const std::vector<page_id_t> &page_ids) {
+  std::vector<std::vector<page_id_t>> shard_page_ids(instances_.size());
+  for (auto page_id : page_ids) {
+    if (page_id != INVALID_PAGE_ID) {
+      shard_page_ids[static_cast<size_t>(page_id) % instances_.size()].push_back(page_id);
+    }
+  }
+  for (size_t i = 0; i < instances_.size(); i++) {
+    if (!shard_page_ids[i].empty()) {
+      instances_[i]->WarmUp(shard_page_ids[i]);
+    }
+  }
+}
+
+void ParallelBufferPoolManager::SetAccessTrace(AccessTraceWriter *trace) {
+  for (auto &instance : instances_) {
+    instance->SetAccessTrace(trace);
+  }
+}
+
+auto ParallelBufferPoolManager::FetchPgImp(page_id_t page_id) -> Page * {
+  return GetBufferPoolManager(page_id)->FetchPage(page_id);
+}
+
+auto ParallelBufferPoolManager::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool {
+  return GetBufferPoolManager(page_id)->UnpinPage(page_id, is_dirty);
+}
+
+auto ParallelBufferPoolManager::FlushPgImp(page_id_t page_id) -> bool {
+  return GetBufferPoolManager(page_id)->FlushPage(page_id);
+}
+
+auto ParallelBufferPoolManager::NewPgImp(page_id_t *page_id) -> Page * {
+  // Only the starting point is shared between threads; the probing itself runs without any pool-wide latch.
+  const size_t num_instances = instances_.size();
+  const size_t start = next_instance_.fetch_add(1) % num_instances;
+  for (size_t i = 0; i < num_instances; i++) {
+    Page *page = instances_[(start + i) % num_instances]->NewPage(page_id);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  return nullptr;
+}
+
+auto ParallelBufferPoolManager::DeletePgImp(page_id_t page_id) -> bool {
+  return GetBufferPoolManager(page_id)->DeletePage(page_id);
+}
+
+void ParallelBufferPoolManager::FlushAllPgsImp() {
+  for (auto &instance : instances_) {
+    instance->FlushAllPages();
+  }
+}
+
+}  // namespace bustub
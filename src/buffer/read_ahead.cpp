@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// read_ahead.cpp
+//
+// Identification: src/buffer/read_ahead.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/read_ahead.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace bustub {
+
+void ReadAhead::OnPage(BufferPoolManager *bpm, page_id_t page_id, page_id_t next_page_id,
+                       BufferAccessStrategy *strategy) {
+  const bool sequential = page_id == last_page_id_ + 1 && next_page_id == page_id + 1;
+  last_page_id_ = page_id;
+  if (next_page_id == INVALID_PAGE_ID) {
+    window_ = 0;
+    return;
+  }
+
+  if (!sequential) {
+    window_ = 0;
+    prefetched_until_ = next_page_id;
+    bpm->PrefetchPages({next_page_id}, strategy);
+    return;
+  }
+
+  // Never let one scan's window take more than a quarter of the pool, or recycle ring frames before they are used.
+  const size_t max_window = std::max<size_t>(
+      1, std::min<size_t>(READ_AHEAD_MAX_PAGES,
+                          strategy != nullptr ? strategy->GetRingSize() / 2 : bpm->GetPoolSize() / 4));
+  window_ = std::min(max_window, std::max<size_t>(READ_AHEAD_MIN_PAGES, window_ * 2));
+
+  // Refill only once half of the window has been consumed, so that prefetches are issued in batches.
+  if (prefetched_until_ > page_id + static_cast<page_id_t>(window_ / 2)) {
+    return;
+  }
+  const auto window_end = page_id + static_cast<page_id_t>(window_);
+  std::vector<page_id_t> page_ids;
+  for (page_id_t id = std::max(next_page_id, prefetched_until_ + 1); id <= window_end; id++) {
+    page_ids.push_back(id);
+  }
+  prefetched_until_ = std::max(prefetched_until_, window_end);
+  if (!page_ids.empty()) {
+    bpm->PrefetchPages(page_ids, strategy);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,33 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer.cpp
+//
+// Identification: src/buffer/replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/replacer.h"
+
+#include "buffer/arc_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/two_q_replacer.h"
+
+namespace bustub {
+
+auto MakeReplacer(ReplacerType replacer_type, size_t num_frames, size_t replacer_k) -> Replacer * {
+  switch (replacer_type) {
+    case ReplacerType::LRU_K:
+      return new LRUKReplacer(num_frames, replacer_k);
+    case ReplacerType::ARC:
+      return new ARCReplacer(num_frames);
+    case ReplacerType::TWO_Q:
+      return new TwoQReplacer(num_frames);
+  }
+  UNREACHABLE("unknown replacer type");
+}
+
+}  // namespace bustub
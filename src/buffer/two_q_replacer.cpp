@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_q_replacer.cpp
+//
+// Identification: src/buffer/two_q_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/two_q_replacer.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+TwoQReplacer::TwoQReplacer(size_t num_frames)
+    : num_frames_(num_frames),
+      a1in_size_(std::max<size_t>(1, num_frames / 4)),
+      a1out_size_(std::max<size_t>(1, num_frames / 2)),
+      frames_(num_frames) {}
+
+auto TwoQReplacer::Victim(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (a1in_.size() > a1in_size_ || am_.empty()) {
+    return EvictFrom(&a1in_, true, frame_id) || EvictFrom(&am_, false, frame_id);
+  }
+  return EvictFrom(&am_, false, frame_id) || EvictFrom(&a1in_, true, frame_id);
+}
+
+auto TwoQReplacer::EvictFrom(std::list<frame_id_t> *queue, bool remember, frame_id_t *frame_id) -> bool {
+  for (auto candidate : *queue) {
+    if (frames_[candidate].evictable_) {
+      if (remember) {
+        a1out_.PushBack(frames_[candidate].page_id_);
+        if (a1out_.Size() > a1out_size_) {
+          a1out_.PopFront();
+        }
+      }
+      Untrack(candidate);
+      *frame_id = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+void TwoQReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < num_frames_, "invalid frame id");
+  auto &entry = frames_[frame_id];
+  if (entry.queue_ != QueueId::NONE && entry.page_id_ == page_id) {
+    // Correlated references to a page in A1in do not make it hot.
+    if (entry.queue_ == QueueId::AM) {
+      am_.splice(am_.end(), am_, entry.pos_);
+    }
+    return;
+  }
+
+  // The frame was reused for another page without being victimized first.
+  const bool evictable = entry.evictable_;
+  if (entry.queue_ != QueueId::NONE) {
+    Untrack(frame_id);
+  }
+
+  if (a1out_.Contains(page_id)) {
+    a1out_.Erase(page_id);
+    entry.queue_ = QueueId::AM;
+    entry.pos_ = am_.insert(am_.end(), frame_id);
+  } else {
+    entry.queue_ = QueueId::A1IN;
+    entry.pos_ = a1in_.insert(a1in_.end(), frame_id);
+  }
+  entry.page_id_ = page_id;
+  if (evictable) {
+    entry.evictable_ = true;
+    curr_size_++;
+  }
+}
+
+void TwoQReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < num_frames_, "invalid frame id");
+  auto &entry = frames_[frame_id];
+  if (entry.queue_ == QueueId::NONE || entry.evictable_ == set_evictable) {
+    return;
+  }
+  entry.evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
+
+auto TwoQReplacer::IsTracked(frame_id_t frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return static_cast<size_t>(frame_id) < num_frames_ && frames_[frame_id].queue_ != QueueId::NONE;
+}
+
+void TwoQReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < num_frames_, "invalid frame id");
+  if (frames_[frame_id].queue_ == QueueId::NONE || !frames_[frame_id].evictable_) {
+    return;
+  }
+  Untrack(frame_id);
+}
+
+void TwoQReplacer::Untrack(frame_id_t frame_id) {
+  auto &entry = frames_[frame_id];
+  (entry.queue_ == QueueId::A1IN ? a1in_ : am_).erase(entry.pos_);
+  if (entry.evictable_) {
+    curr_size_--;
+  }
+  entry = FrameEntry();
+}
+
+auto TwoQReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
+
+void TwoQReplacer::SetNumFrames(size_t num_frames) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  num_frames_ = num_frames;
+  a1in_size_ = std::max<size_t>(1, num_frames / 4);
+  a1out_size_ = std::max<size_t>(1, num_frames / 2);
+  frames_.resize(num_frames);
+  while (a1out_.Size() > a1out_size_) {
+    a1out_.PopFront();
+  }
+}
+
+}  // namespace bustub
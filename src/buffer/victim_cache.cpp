@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// victim_cache.cpp
+//
+// Identification: src/buffer/victim_cache.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/victim_cache.h"
+
+#include <cstring>
+#include <iterator>
+
+#include "storage/disk/lz_codec.h"
+
+namespace bustub {
+
+VictimCache::VictimCache(size_t capacity_bytes) : capacity_bytes_(capacity_bytes) {}
+
+auto VictimCache::Insert(page_id_t page_id, const char *page_data) -> bool {
+  // Compress outside of the latch; a page that does not fit into less than a page is not worth storing.
+  char buffer[BUSTUB_PAGE_SIZE];
+  const size_t size = LzCodec::Compress(page_data, BUSTUB_PAGE_SIZE, buffer, BUSTUB_PAGE_SIZE - 1);
+
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto it = index_.find(page_id);
+  if (it != index_.end()) {
+    RemoveEntry(it->second);
+  }
+  if (size == 0 || size > capacity_bytes_) {
+    stats_.rejections_++;
+    return false;
+  }
+  while (used_bytes_ + size > capacity_bytes_) {
+    RemoveEntry(std::prev(entries_.end()));
+    stats_.evictions_++;
+  }
+
+  auto data = std::make_unique<char[]>(size);
+  memcpy(data.get(), buffer, size);
+  entries_.push_front(Entry{page_id, std::move(data), size});
+  index_[page_id] = entries_.begin();
+  used_bytes_ += size;
+  stats_.demotions_++;
+  stats_.logical_bytes_ += BUSTUB_PAGE_SIZE;
+  stats_.compressed_bytes_ += size;
+  return true;
+}
+
+auto VictimCache::Take(page_id_t page_id, char *page_data) -> bool {
+  std::unique_lock<std::mutex> lock(latch_);
+  stats_.lookups_++;
+  auto it = index_.find(page_id);
+  if (it == index_.end()) {
+    return false;
+  }
+  // Unlink the entry and decompress it outside of the latch.
+  Entry entry = std::move(*it->second);
+  entries_.erase(it->second);
+  index_.erase(it);
+  used_bytes_ -= entry.size_;
+  stats_.hits_++;
+  lock.unlock();
+
+  return LzCodec::Decompress(entry.data_.get(), entry.size_, page_data, BUSTUB_PAGE_SIZE) ==
+         static_cast<size_t>(BUSTUB_PAGE_SIZE);
+}
+
+void VictimCache::Erase(page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto it = index_.find(page_id);
+  if (it != index_.end()) {
+    RemoveEntry(it->second);
+  }
+}
+
+auto VictimCache::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return entries_.size();
+}
+
+auto VictimCache::GetUsedBytes() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return used_bytes_;
+}
+
+auto VictimCache::GetStats() -> VictimCacheStats {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return stats_;
+}
+
+void VictimCache::RemoveEntry(std::list<Entry>::iterator it) {
+  used_bytes_ -= it->size_;
+  index_.erase(it->page_id_);
+  entries_.erase(it);
+}
+
+}  // namespace bustub
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <optional>
 #include <shared_mutex>
 #include <string>
@@ -11,7 +12,10 @@
 #include "binder/statement/index_statement.h"
 #include "binder/statement/select_statement.h"
 #include "binder/statement/set_show_statement.h"
+#include "binder/statement/vacuum_statement.h"
 #include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/hot_page_set.h"
+#include "buffer/parallel_buffer_pool_manager.h"
 #include "catalog/schema.h"
 #include "catalog/table_generator.h"
 #include "common/bustub_instance.h"
@@ -32,7 +36,10 @@
 #include "recovery/checkpoint_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_compressed.h"
 #include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_manager_mmap.h"
+#include "storage/disk/disk_manager_uring.h"
 #include "type/value_factory.h"
 
 namespace bustub {
@@ -41,11 +48,49 @@ auto BustubInstance::MakeExecutorContext(Transaction *txn) -> std::unique_ptr<Ex
   return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_);
 }
 
-BustubInstance::BustubInstance(const std::string &db_file_name) {
+auto BustubInstance::IsModifyingStatement(StatementType type) -> bool {
+  switch (type) {
+    case StatementType::INSERT_STATEMENT:
+    case StatementType::UPDATE_STATEMENT:
+    case StatementType::CREATE_STATEMENT:
+    case StatementType::DELETE_STATEMENT:
+    case StatementType::DROP_STATEMENT:
+    case StatementType::INDEX_STATEMENT:
+    case StatementType::VACUUM_STATEMENT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void BustubInstance::ResizeBufferPool(const std::string &value) {
+  if (value.empty() || value.size() > 9 || value.find_first_not_of("0123456789") != std::string::npos) {
+    throw Exception(fmt::format("invalid buffer_pool_size: {}", value));
+  }
+  const size_t pool_size = std::stoul(value);
+  if (!buffer_pool_manager_->Resize(pool_size)) {
+    throw Exception(fmt::format("could only resize the buffer pool to {} frames", buffer_pool_manager_->GetPoolSize()));
+  }
+}
+
+auto BustubInstance::MakeBufferPoolManager(size_t bpm_size, size_t bpm_instances) -> BufferPoolManager * {
+  if (bpm_instances > 1) {
+    return new ParallelBufferPoolManager(bpm_instances, bpm_size, disk_manager_, LRUK_REPLACER_K, log_manager_);
+  }
+  return new BufferPoolManagerInstance(bpm_size, disk_manager_, LRUK_REPLACER_K, log_manager_);
+}
+
+BustubInstance::BustubInstance(const std::string &db_file_name, size_t bpm_size, size_t bpm_instances) {
   enable_logging = false;
 
   // Storage related.
-  disk_manager_ = new DiskManager(db_file_name);
+  if (open_read_only) {
+    disk_manager_ = new DiskManagerMmap(db_file_name);
+  } else if (enable_page_compression) {
+    disk_manager_ = new DiskManagerCompressed(db_file_name);
+  } else {
+    disk_manager_ = new DiskManagerUring(db_file_name);
+  }
 
   // Log related.
   log_manager_ = new LogManager(disk_manager_);
@@ -53,12 +98,22 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
   // buffer pool size specified in `config.h`.
   try {
-    buffer_pool_manager_ = new BufferPoolManagerInstance(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    buffer_pool_manager_ = MakeBufferPoolManager(bpm_size, bpm_instances);
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
   }
 
+  // Warm start: reload the pages that were hot when the previous instance shut down. The hottest ones that fit are
+  // read in page-id order by the prefetcher, alongside the first queries.
+  if (buffer_pool_manager_ != nullptr) {
+    hot_page_file_ = db_file_name.substr(0, db_file_name.rfind('.')) + ".warm";
+    auto hot_pages = HotPageSet::Load(hot_page_file_);
+    hot_pages.resize(std::min(hot_pages.size(), buffer_pool_manager_->GetPoolSize()));
+    std::sort(hot_pages.begin(), hot_pages.end());
+    buffer_pool_manager_->WarmUp(hot_pages);
+  }
+
   // Transaction (txn) related.
   lock_manager_ = new LockManager();
   txn_manager_ = new TransactionManager(lock_manager_, log_manager_);
@@ -73,7 +128,7 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
 }
 
-BustubInstance::BustubInstance() {
+BustubInstance::BustubInstance(size_t bpm_size, size_t bpm_instances) {
   enable_logging = false;
 
   // Storage related.
@@ -85,7 +140,7 @@ BustubInstance::BustubInstance() {
   // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
   // buffer pool size specified in `config.h`.
   try {
-    buffer_pool_manager_ = new BufferPoolManagerInstance(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    buffer_pool_manager_ = MakeBufferPoolManager(bpm_size, bpm_instances);
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
@@ -146,6 +201,92 @@ void BustubInstance::CmdDisplayIndices(ResultWriter &writer) {
   writer.EndTable();
 }
 
+void BustubInstance::CmdSetResident(const std::string &name, bool resident, ResultWriter &writer) {
+  std::vector<page_id_t> page_ids;
+  {
+    std::shared_lock<std::shared_mutex> l(catalog_lock_);
+    bool found = false;
+    auto *table_info = catalog_->GetTable(name);
+    if (table_info != Catalog::NULL_TABLE_INFO) {
+      page_ids = table_info->table_->GetPageIds();
+      found = true;
+    }
+    for (const auto &table_name : catalog_->GetTableNames()) {
+      for (auto *index_info : catalog_->GetTableIndexes(table_name)) {
+        if (!found && index_info->name_ == name) {
+          page_ids = index_info->index_->GetPageIds();
+          found = true;
+        }
+      }
+    }
+    if (!found) {
+      throw Exception(fmt::format("no table or index named {}", name));
+    }
+  }
+
+  size_t num_pages = 0;
+  for (auto page_id : page_ids) {
+    if (buffer_pool_manager_->SetPageResident(page_id, resident)) {
+      num_pages++;
+    }
+  }
+  if (num_pages < page_ids.size()) {
+    throw Exception(fmt::format("could only keep {} of the {} pages of {} resident", num_pages, page_ids.size(), name));
+  }
+  WriteOneCell(fmt::format("{} {} pages of {}", resident ? "Pinned" : "Unpinned", num_pages, name), writer);
+}
+
+void BustubInstance::CmdDisplayBufferPool(ResultWriter &writer) {
+  auto stats = buffer_pool_manager_->GetStats();
+  writer.BeginTable(false);
+  writer.BeginHeader();
+  writer.WriteHeaderCell("metric");
+  writer.WriteHeaderCell("value");
+  writer.EndHeader();
+  auto write_row = [&writer](const std::string &metric, const std::string &value) {
+    writer.BeginRow();
+    writer.WriteCell(metric);
+    writer.WriteCell(value);
+    writer.EndRow();
+  };
+  write_row("pool_size", fmt::format("{}", buffer_pool_manager_->GetPoolSize()));
+  for (size_t i = 0; i < static_cast<size_t>(BufferPoolCounter::NUM_COUNTERS); i++) {
+    auto counter = static_cast<BufferPoolCounter>(i);
+    write_row(BufferPoolCounterToString(counter), fmt::format("{}", stats.Get(counter)));
+  }
+  write_row("hit_ratio", fmt::format("{:.4f}", stats.GetHitRatio()));
+  auto victim_cache_stats = buffer_pool_manager_->GetVictimCacheStats();
+  if (victim_cache_stats.lookups_ > 0 || victim_cache_stats.demotions_ > 0) {
+    write_row("victim_cache_hits", fmt::format("{}", victim_cache_stats.hits_));
+    write_row("victim_cache_demotions", fmt::format("{}", victim_cache_stats.demotions_));
+    write_row("victim_cache_compression_ratio", fmt::format("{:.2f}", victim_cache_stats.GetCompressionRatio()));
+  }
+  writer.EndTable();
+
+  writer.BeginTable(false);
+  writer.BeginHeader();
+  writer.WriteHeaderCell("latency");
+  writer.WriteHeaderCell("count");
+  writer.WriteHeaderCell("mean_ns");
+  writer.WriteHeaderCell("p50_ns");
+  writer.WriteHeaderCell("p99_ns");
+  writer.WriteHeaderCell("max_ns");
+  writer.EndHeader();
+  for (size_t i = 0; i < static_cast<size_t>(BufferPoolLatency::NUM_LATENCIES); i++) {
+    auto latency = static_cast<BufferPoolLatency>(i);
+    const auto &histogram = stats.GetLatency(latency);
+    writer.BeginRow();
+    writer.WriteCell(BufferPoolLatencyToString(latency));
+    writer.WriteCell(fmt::format("{}", histogram.count_));
+    writer.WriteCell(fmt::format("{}", histogram.GetMeanNs()));
+    writer.WriteCell(fmt::format("{}", histogram.GetPercentileNs(50)));
+    writer.WriteCell(fmt::format("{}", histogram.GetPercentileNs(99)));
+    writer.WriteCell(fmt::format("{}", histogram.GetPercentileNs(100)));
+    writer.EndRow();
+  }
+  writer.EndTable();
+}
+
 void BustubInstance::WriteOneCell(const std::string &cell, ResultWriter &writer) {
   writer.BeginTable(true);
   writer.BeginRow();
@@ -159,6 +300,8 @@ void BustubInstance::CmdDisplayHelp(ResultWriter &writer) {
 
 \dt: show all tables
 \di: show all indices
+\pin <name>: keep the pages of a table or index resident in the buffer pool
+\unpin <name>: let the pages of a table or index be evicted again
 \help: show this message again
 
 BusTub shell currently only supports a small set of Postgres queries. We'll set
@@ -195,6 +338,14 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
       CmdDisplayHelp(writer);
       return true;
     }
+    if (StringUtil::StartsWith(sql, "\\pin ")) {
+      CmdSetResident(StringUtil::Strip(sql.substr(5), ' '), true, writer);
+      return true;
+    }
+    if (StringUtil::StartsWith(sql, "\\unpin ")) {
+      CmdSetResident(StringUtil::Strip(sql.substr(7), ' '), false, writer);
+      return true;
+    }
     throw Exception(fmt::format("unsupported internal command: {}", sql));
   }
 
@@ -207,12 +358,16 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
 
   for (auto *stmt : binder.statement_nodes_) {
     auto statement = binder.BindStatement(stmt);
+    if (disk_manager_->IsReadOnly() && IsModifyingStatement(statement->type_)) {
+      throw Exception(fmt::format("{} statements are not allowed: the database is read-only", statement->type_));
+    }
     switch (statement->type_) {
       case StatementType::CREATE_STATEMENT: {
         const auto &create_stmt = dynamic_cast<const CreateStatement &>(*statement);
 
         std::unique_lock<std::shared_mutex> l(catalog_lock_);
-        auto info = catalog_->CreateTable(txn, create_stmt.table_, Schema(create_stmt.columns_));
+        auto info =
+            catalog_->CreateTable(txn, create_stmt.table_, Schema(create_stmt.columns_), true, create_stmt.compressed_);
         l.unlock();
 
         if (info == nullptr) {
@@ -251,15 +406,30 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
       }
       case StatementType::VARIABLE_SHOW_STATEMENT: {
         const auto &show_stmt = dynamic_cast<const VariableShowStatement &>(*statement);
-        auto content = GetSessionVariable(show_stmt.variable_);
+        if (StringUtil::Lower(show_stmt.variable_) == "buffer_pool") {
+          CmdDisplayBufferPool(writer);
+          continue;
+        }
+        auto content = show_stmt.variable_ == "buffer_pool_size"
+                           ? std::to_string(buffer_pool_manager_->GetPoolSize())
+                           : GetSessionVariable(show_stmt.variable_);
         WriteOneCell(fmt::format("{}={}", show_stmt.variable_, content), writer);
         continue;
       }
       case StatementType::VARIABLE_SET_STATEMENT: {
         const auto &set_stmt = dynamic_cast<const VariableSetStatement &>(*statement);
+        if (set_stmt.variable_ == "buffer_pool_size") {
+          ResizeBufferPool(set_stmt.value_);
+          continue;
+        }
         session_variables_[set_stmt.variable_] = set_stmt.value_;
         continue;
       }
+      case StatementType::VACUUM_STATEMENT: {
+        auto num_pages = disk_manager_->Vacuum();
+        WriteOneCell(fmt::format("Truncated {} free pages", num_pages), writer);
+        continue;
+      }
       case StatementType::EXPLAIN_STATEMENT: {
         const auto &explain_stmt = dynamic_cast<const ExplainStatement &>(*statement);
         std::string output;
@@ -392,6 +562,9 @@ BustubInstance::~BustubInstance() {
   if (enable_logging) {
     log_manager_->StopFlushThread();
   }
+  if (buffer_pool_manager_ != nullptr && !hot_page_file_.empty()) {
+    HotPageSet::Save(hot_page_file_, buffer_pool_manager_->GetHotPages());
+  }
   delete execution_engine_;
   delete catalog_;
   delete checkpoint_manager_;
@@ -20,4 +20,22 @@ std::chrono::duration<int64_t> log_timeout = std::chrono::seconds(1);
 
 std::chrono::milliseconds cycle_detection_interval = std::chrono::milliseconds(50);
 
+std::chrono::milliseconds page_cleaner_interval = std::chrono::milliseconds(100);
+
+std::chrono::milliseconds resize_pin_timeout = std::chrono::milliseconds(1000);
+
+std::atomic<bool> buffer_pool_huge_pages(false);
+
+std::atomic<size_t> victim_cache_size(0);
+
+std::atomic<bool> page_class_priorities(false);
+
+std::atomic<bool> b_plus_tree_optimistic_latching(true);
+
+std::atomic<bool> b_plus_tree_optimistic_reads(true);
+
+std::atomic<bool> enable_page_compression(false);
+
+std::atomic<bool> open_read_only(false);
+
 }  // namespace bustub
@@ -22,7 +22,10 @@ SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNod
 void SeqScanExecutor::Init() { 
     
     table_heap_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid())->table_.get();
-    iter_ = table_heap_->Begin(exec_ctx_->GetTransaction());
+    if (plan_->bulk_read_ && strategy_ == nullptr) {
+        strategy_ = std::make_unique<BufferAccessStrategy>(exec_ctx_->GetBufferPoolManager(), BULK_READ_RING_SIZE);
+    }
+    iter_ = table_heap_->Begin(exec_ctx_->GetTransaction(), strategy_.get());
  }
 
 auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool { 
@@ -21,10 +21,12 @@ namespace bustub {
 
 class CreateStatement : public BoundStatement {
  public:
-  explicit CreateStatement(std::string table, std::vector<Column> columns);
+  explicit CreateStatement(std::string table, std::vector<Column> columns, bool compressed = false);
 
   std::string table_;
   std::vector<Column> columns_;
+  /** Whether the table was created WITH (compression), opting its pages in to compression on disk. */
+  bool compressed_;
 
   auto ToString() const -> std::string override;
 };
@@ -0,0 +1,33 @@
+//===----------------------------------------------------------------------===//
+//                         BusTub
+//
+// binder/vacuum_statement.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+
+#include "binder/bound_statement.h"
+#include "common/enums/statement_type.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+/**
+ * `VACUUM FILE` truncates the free pages at the end of the database file. Vacuuming single tables is not supported.
+ */
+class VacuumStatement : public BoundStatement {
+ public:
+  explicit VacuumStatement(std::string target)
+      : BoundStatement(StatementType::VACUUM_STATEMENT), target_(std::move(target)) {}
+
+  /** What to vacuum; always "file" for now. */
+  std::string target_;
+
+  auto ToString() const -> std::string override { return fmt::format("BoundVacuum {{ target={} }}", target_); }
+};
+
+}  // namespace bustub
@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// access_trace.h
+//
+// Identification: src/include/buffer/access_trace.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/** The buffer pool requests an access trace records. */
+enum class AccessTraceOp : uint8_t { FETCH = 0, NEW = 1, UNPIN = 2, DELETE = 3 };
+
+/** One request of an access trace. */
+struct AccessTraceRecord {
+  AccessTraceOp op_;
+  page_id_t page_id_;
+};
+
+/**
+ * AccessTraceWriter records the page requests a buffer pool serves to a binary file, to be replayed offline against
+ * other replacement policies, pool sizes and values of K.
+ *
+ * The file starts with an 8-byte magic, followed by one 5-byte record per request: the op and the little-endian
+ * page id. Records are buffered in memory and appended to the file in large chunks. Requests from concurrent threads
+ * are recorded in the order they acquire the writer's latch, which is close to, but not exactly, the order in which
+ * the buffer pool served them.
+ */
+class AccessTraceWriter {
+ public:
+  /**
+   * @brief Create a trace file, replacing any existing file.
+   * @param file_name the path of the trace file
+   */
+  explicit AccessTraceWriter(const std::string &file_name);
+
+  DISALLOW_COPY_AND_MOVE(AccessTraceWriter);
+
+  /** @brief Flush the remaining records and close the file. */
+  ~AccessTraceWriter();
+
+  /** @brief Append a record. */
+  void Record(AccessTraceOp op, page_id_t page_id);
+
+  /** @brief Write the buffered records to the file. */
+  void Flush();
+
+  /** @return the number of records written so far, including buffered ones */
+  auto GetNumRecords() -> size_t;
+
+ private:
+  void FlushLocked();
+
+  std::mutex latch_;
+  std::ofstream file_;
+  std::vector<char> buffer_;
+  size_t num_records_{0};
+};
+
+/**
+ * AccessTraceReader reads back the records of a trace file written by AccessTraceWriter.
+ */
+class AccessTraceReader {
+ public:
+  /**
+   * @brief Open a trace file. Throws if the file cannot be opened or is not a trace.
+   * @param file_name the path of the trace file
+   */
+  explicit AccessTraceReader(const std::string &file_name);
+
+  /**
+   * @brief Read the next record.
+   * @param[out] record the record read
+   * @return false at the end of the trace, true otherwise
+   */
+  auto Next(AccessTraceRecord *record) -> bool;
+
+ private:
+  std::ifstream file_;
+};
+
+}  // namespace bustub
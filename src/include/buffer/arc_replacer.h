@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.h
+//
+// Identification: src/include/buffer/arc_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/ghost_list.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ARCReplacer implements the Adaptive Replacement Cache policy (Megiddo and Modha, FAST '03).
+ *
+ * Resident frames are split between T1, holding pages accessed once since they were loaded, and T2, holding pages
+ * accessed again. The ghost lists B1 and B2 remember the pages recently evicted from T1 and T2. A page read back
+ * while remembered in B1 means T1 was too small, and grows the target size p of T1; one remembered in B2 shrinks it.
+ * Victims are taken from T1 while it is larger than p, and from T2 otherwise, so the policy adapts between recency
+ * (scans) and frequency (hot working sets) as the workload changes.
+ *
+ * Both lists are kept in LRU order. Victim() skips non-evictable frames, so it is linear in the number of pinned
+ * frames at the cold end of the list; all other operations are O(1).
+ */
+class ARCReplacer : public Replacer {
+ public:
+  /**
+   * @brief Create a new ARCReplacer.
+   * @param num_frames the maximum number of frames the ARCReplacer will be required to store
+   */
+  explicit ARCReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(ARCReplacer);
+
+  ~ARCReplacer() override = default;
+
+  /**
+   * @brief Evict the least recently used evictable frame of T1 if T1 is larger than its target, of T2 otherwise,
+   * falling back to the other list if the chosen one has no evictable frame. The evicted page joins B1 or B2.
+   */
+  auto Victim(frame_id_t *frame_id) -> bool override;
+
+  void Pin(frame_id_t frame_id) override { SetEvictable(frame_id, false); }
+
+  void Unpin(frame_id_t frame_id) override { SetEvictable(frame_id, true); }
+
+  auto Size() -> size_t override;
+
+  /**
+   * @brief Record an access. A frame already holding the page moves to the most recently used end of T2. Otherwise
+   * the frame starts tracking the page: in T2 if the page is remembered in B1 or B2 (adapting the target), in T1 if
+   * it is new.
+   */
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override;
+
+  /** Page classes are ignored. */
+  using Replacer::RecordAccess;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  auto IsTracked(frame_id_t frame_id) -> bool override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  /** @return the current target size of T1 */
+  auto GetTarget() -> size_t;
+
+  /**
+   * @brief Change the number of frames. The target size of T1 is capped to it, and the ghost lists shrink to fit on
+   * the next miss.
+   */
+  void SetNumFrames(size_t num_frames) override;
+
+ private:
+  enum class ListId : uint8_t { NONE, T1, T2 };
+
+  struct FrameEntry {
+    ListId list_{ListId::NONE};
+    std::list<frame_id_t>::iterator pos_;
+    page_id_t page_id_{INVALID_PAGE_ID};
+    bool evictable_{false};
+  };
+
+  /** @brief Take a tracked frame out of its list and stop tracking it. */
+  void Untrack(frame_id_t frame_id);
+
+  /** @brief Evict the least recently used evictable frame of a list, remembering its page in the given ghost list. */
+  auto EvictFrom(std::list<frame_id_t> *list, GhostList *ghost_list, frame_id_t *frame_id) -> bool;
+
+  size_t num_frames_;
+  /** Target size of T1. */
+  size_t target_{0};
+  size_t curr_size_{0};
+  std::mutex latch_;
+  std::vector<FrameEntry> frames_;
+  /** Resident frames, least recently used first. */
+  std::list<frame_id_t> t1_;
+  std::list<frame_id_t> t2_;
+  GhostList b1_;
+  GhostList b2_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_access_strategy.h
+//
+// Identification: src/include/buffer/buffer_access_strategy.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+class BufferPoolManager;
+
+/**
+ * BufferAccessStrategy confines the pages read by one large scan to a small private ring of frames.
+ *
+ * Frames loaded on behalf of a strategy join its ring instead of the replacer, so the scan neither records LRU-K
+ * history nor evicts the working set of other queries: once the ring is full, every miss recycles the oldest frame
+ * of the ring. A ring frame that is pinned by someone else when its turn comes is handed over to the replacer and
+ * replaced in the ring by a regular victim. Destroying the strategy hands all of its frames to the replacer.
+ *
+ * A strategy belongs to a single scan, but its rings are only touched under the latch of the buffer pool instance
+ * that owns them, so the instances' prefetchers may work on them concurrently.
+ */
+class BufferAccessStrategy {
+ public:
+  /** The frames of one buffer pool instance that belong to the strategy, in the order they are recycled. */
+  struct Ring {
+    std::vector<frame_id_t> frames_;
+    /** Position of the next frame to recycle once the ring is full. */
+    size_t next_{0};
+  };
+
+  /**
+   * @brief Create a new BufferAccessStrategy.
+   * @param bpm the buffer pool the scan reads from
+   * @param ring_size the number of frames the scan may occupy in the whole buffer pool
+   */
+  BufferAccessStrategy(BufferPoolManager *bpm, size_t ring_size);
+
+  DISALLOW_COPY_AND_MOVE(BufferAccessStrategy);
+
+  /**
+   * @brief Hand the frames of the ring back to the buffer pool.
+   */
+  ~BufferAccessStrategy();
+
+  /** @return the number of frames the scan may occupy in the whole buffer pool */
+  auto GetRingSize() const -> size_t { return ring_size_; }
+
+  /**
+   * @brief Return the ring of a buffer pool instance, creating it on first use. Caller must hold the instance latch.
+   * @param instance_index index of the instance in its parallel buffer pool, 0 for a standalone instance
+   */
+  auto GetRing(uint32_t instance_index) -> Ring &;
+
+ private:
+  BufferPoolManager *bpm_;
+  const size_t ring_size_;
+  /** Protects the map itself; each ring is protected by the latch of its instance. */
+  std::mutex latch_;
+  std::unordered_map<uint32_t, Ring> rings_;
+};
+
+}  // namespace bustub
@@ -15,8 +15,12 @@
 #include <list>
 #include <mutex>  // NOLINT
 #include <unordered_map>
+#include <vector>
 
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/buffer_pool_stats.h"
 #include "buffer/lru_replacer.h"
+#include "buffer/victim_cache.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
@@ -87,6 +91,101 @@ class BufferPoolManager {
   /** @return size of the buffer pool */
   virtual auto GetPoolSize() -> size_t = 0;
 
+  /**
+   * Fetch a page on behalf of a scan that reads through an access strategy. A miss loads the page into one of the
+   * strategy's frames; the default implementation ignores the strategy.
+   * @param page_id id of page to be fetched
+   * @param strategy the access strategy of the scan, or nullptr for a regular fetch
+   * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
+   */
+  virtual auto FetchPageWithStrategy(page_id_t page_id, __attribute__((unused)) BufferAccessStrategy *strategy)
+      -> Page * {
+    return FetchPage(page_id);
+  }
+
+  /**
+   * Hint that the given pages will be fetched soon. Implementations may load them asynchronously, leaving them
+   * unpinned; the default implementation ignores the hint.
+   * @param page_ids ids of the pages to load ahead of their FetchPage()
+   * @param strategy the access strategy the pages will be fetched with, or nullptr
+   */
+  virtual void PrefetchPages(__attribute__((unused)) const std::vector<page_id_t> &page_ids,
+                             __attribute__((unused)) BufferAccessStrategy *strategy) {}
+
+  /**
+   * Hand the frames of a strategy that is being destroyed back to the buffer pool. Called by ~BufferAccessStrategy().
+   * @param strategy the strategy being destroyed
+   */
+  virtual void ReleaseStrategy(__attribute__((unused)) BufferAccessStrategy *strategy) {}
+
+  /**
+   * Opt a page in or out of compression on disk, e.g. because it belongs to a table created WITH (compression).
+   * The default implementation ignores it.
+   * @param page_id id of the page
+   * @param compressed whether the page should be compressed when it is written back
+   */
+  virtual void SetPageCompressed(__attribute__((unused)) page_id_t page_id, __attribute__((unused)) bool compressed) {}
+
+  /**
+   * Fetch a page and tag it with what it holds, so that replacers which honor page classes can favor it or not.
+   * @param page_id id of page to be fetched
+   * @param page_class the class of the page
+   * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
+   */
+  auto FetchPageWithClass(page_id_t page_id, PageClass page_class) -> Page * {
+    auto *page = FetchPage(page_id);
+    if (page != nullptr) {
+      page->SetPageClass(page_class);
+    }
+    return page;
+  }
+
+  /**
+   * Keep a page in the buffer pool until it is released again, e.g. because it belongs to a hot table or index. The
+   * default implementation cannot keep pages resident.
+   * @param page_id id of the page
+   * @param resident whether to keep the page in the buffer pool, or release it
+   * @return true if the page is resident (or released) afterwards, false otherwise
+   */
+  virtual auto SetPageResident(__attribute__((unused)) page_id_t page_id, __attribute__((unused)) bool resident)
+      -> bool {
+    return false;
+  }
+
+  /**
+   * Return the resident pages, hottest first according to the replacement policy, so that a restarted buffer pool
+   * can be warmed up with them. The default implementation knows no pages.
+   * @return the ids of the resident pages
+   */
+  virtual auto GetHotPages() -> std::vector<page_id_t> { return {}; }
+
+  /**
+   * Load pages into the buffer pool in the background, e.g. the hot pages of a previous run after a restart. They
+   * are left unpinned. The default implementation ignores them.
+   * @param page_ids ids of the pages to load, in the order to load them in
+   */
+  virtual void WarmUp(__attribute__((unused)) const std::vector<page_id_t> &page_ids) {}
+
+  /**
+   * Change the number of frames of the buffer pool while it is in use. The default implementation cannot resize.
+   * @param pool_size the new number of frames
+   * @return true if the buffer pool has the requested size afterwards, false otherwise
+   */
+  virtual auto Resize(__attribute__((unused)) size_t pool_size) -> bool { return false; }
+
+  /**
+   * Return the counters of the compressed victim cache (see victim_cache_size). The default implementation has none.
+   * @return the counters, all zero if there is no victim cache
+   */
+  virtual auto GetVictimCacheStats() -> VictimCacheStats { return {}; }
+
+  /**
+   * Return a snapshot of the counters and latency histograms of the buffer pool, e.g. for SHOW BUFFER_POOL. The
+   * default implementation records nothing.
+   * @return the snapshot, all zero if nothing is recorded
+   */
+  virtual auto GetStats() -> BufferPoolStats { return {}; }
+
  protected:
   /**
    * Grading function. Do not modify!
@@ -12,14 +12,25 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <deque>
 #include <list>
 #include <mutex>  // NOLINT
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "buffer/access_trace.h"
+#include "buffer/buffer_access_strategy.h"
 #include "buffer/buffer_pool_manager.h"
-#include "buffer/lru_k_replacer.h"
+#include "buffer/buffer_pool_stats.h"
+#include "buffer/concurrent_page_table.h"
+#include "buffer/frame_arena.h"
+#include "buffer/replacer.h"
 #include "common/config.h"
-#include "container/hash/extendible_hash_table.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
@@ -28,18 +39,44 @@ namespace bustub {
 
 /**
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
+ *
+ * On top of a read-only disk manager that maps the database file (see DiskManager::MapPage()), a page miss points the
+ * frame's page at the mapping instead of copying the page into the frame. Such pages must not be written to: NewPage(),
+ * DeletePage() and dirty unpins throw an exception instead.
  */
 class BufferPoolManagerInstance : public BufferPoolManager {
  public:
+  /** Number of frames a chunk holds. The data of a full chunk fills one 2 MiB huge page. */
+  static constexpr size_t FRAMES_PER_CHUNK = 512;
+
   /**
    * @brief Creates a new BufferPoolManagerInstance.
    * @param pool_size the size of the buffer pool
    * @param disk_manager the disk manager
    * @param replacer_k the lookback constant k for the LRU-K replacer
    * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param replacer_type the replacement policy of the buffer pool
    */
   BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
-                            LogManager *log_manager = nullptr);
+                            LogManager *log_manager = nullptr, ReplacerType replacer_type = ReplacerType::LRU_K);
+
+  /**
+   * @brief Creates a new BufferPoolManagerInstance that is one shard of a ParallelBufferPoolManager.
+   *
+   * The instance only allocates page ids p with p % num_instances == instance_index, so that the parallel
+   * buffer pool can route every page id back to the shard that owns it.
+   *
+   * @param pool_size the size of the buffer pool
+   * @param num_instances total number of BPIs in the parallel BPM
+   * @param instance_index index of this BPI in the parallel BPM
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer
+   * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param replacer_type the replacement policy of the buffer pool
+   */
+  BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                            DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
+                            LogManager *log_manager = nullptr, ReplacerType replacer_type = ReplacerType::LRU_K);
 
   /**
    * @brief Destroy an existing BufferPoolManagerInstance.
@@ -49,8 +86,146 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** @brief Return the size (number of frames) of the buffer pool. */
   auto GetPoolSize() -> size_t override { return pool_size_; }
 
-  /** @brief Return the pointer to all the pages in the buffer pool. */
-  auto GetPages() -> Page * { return pages_; }
+  /**
+   * @brief Return the pointer to the pages of the first chunk of frames, which are contiguous. With more than
+   * FRAMES_PER_CHUNK frames, the pages of the other frames are not included.
+   */
+  auto GetPages() -> Page * { return GetChunk(0)->pages_; }
+
+  /**
+   * @brief Resize the buffer pool while it is in use.
+   *
+   * Growing allocates new chunks of frames as needed and hands the new frames to the free list; existing frames never
+   * move, and page table hits are served without interruption. Shrinking retires frames from the end of the pool one
+   * at a time, each under a short hold of the pool latch: a dirty page is written back first, and the frame's memory
+   * is returned to the operating system. Pinned frames are waited for; if one is still pinned after `timeout`, the
+   * pool stops shrinking there.
+   *
+   * @param pool_size the new number of frames, at least 1
+   * @param timeout how long to wait for a pinned frame while shrinking
+   * @return true if the pool has the requested size, false if it could not shrink that far
+   */
+  auto Resize(size_t pool_size, std::chrono::milliseconds timeout) -> bool;
+
+  /** @brief Resize the buffer pool, waiting up to resize_pin_timeout for pinned frames. */
+  auto Resize(size_t pool_size) -> bool override { return Resize(pool_size, resize_pin_timeout); }
+
+  /**
+   * @brief Start a background thread that writes dirty, unpinned pages back to disk ahead of their eviction.
+   *
+   * The cleaner wakes up every `interval`, and whenever a miss has to write back a dirty victim in the foreground.
+   * Once at least `dirty_high_watermark` frames are dirty, it flushes unpinned dirty frames until no more than
+   * `dirty_low_watermark` remain dirty, submitting the writes to the disk manager in batches of DISK_IO_BATCH_SIZE
+   * pages. Cleaned frames keep their place in the replacer, so they are still evicted in LRU-K order, but without a
+   * write on the critical path. Does nothing if the cleaner is already running.
+   *
+   * @param dirty_low_watermark number of dirty frames the cleaner stops at
+   * @param dirty_high_watermark number of dirty frames that starts a cleaning round
+   * @param interval maximum time between two checks of the dirty frames
+   */
+  void RunPageCleaner(size_t dirty_low_watermark, size_t dirty_high_watermark,
+                      std::chrono::milliseconds interval = page_cleaner_interval);
+
+  /**
+   * @brief Stop and join the page cleaner thread, if it is running.
+   */
+  void StopPageCleaner();
+
+  /** @return the number of dirty victims written back by NewPage/FetchPage themselves */
+  auto GetNumForegroundWriteBacks() const -> uint64_t { return stats_.Get(BufferPoolCounter::DIRTY_WRITE_BACKS); }
+
+  /** @return the number of pages written back by the page cleaner */
+  auto GetNumCleanerWriteBacks() const -> uint64_t { return stats_.Get(BufferPoolCounter::CLEANER_WRITE_BACKS); }
+
+  /** @return the number of victims that needed no write-back because the page cleaner had already written them */
+  auto GetNumAvoidedWriteBacks() const -> uint64_t { return stats_.Get(BufferPoolCounter::AVOIDED_WRITE_BACKS); }
+
+  auto GetStats() -> BufferPoolStats override { return stats_.GetSnapshot(); }
+
+  auto GetVictimCacheStats() -> VictimCacheStats override {
+    return victim_cache_ == nullptr ? VictimCacheStats{} : victim_cache_->GetStats();
+  }
+
+  /**
+   * @brief Fetch a page, loading it into a frame of the strategy's ring on a miss.
+   *
+   * Hits are served exactly like FetchPage(). Each instance gives the strategy GetRingSize() / num_instances frames
+   * (at least one); until the ring is full, misses take regular victims and add them to it.
+   *
+   * @param page_id id of page to be fetched
+   * @param strategy the access strategy of the scan, or nullptr for a regular fetch
+   * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
+   */
+  auto FetchPageWithStrategy(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * override;
+
+  /**
+   * @brief Queue pages to be read into the buffer pool by a background prefetcher, started on first use.
+   *
+   * Prefetched pages are left unpinned with a single recorded access, so LRU-K evicts them before pages that were
+   * actually used. Pages that are already resident, not yet allocated, or beyond the queue capacity (half of the
+   * pool) are skipped, and prefetching stops when every frame is pinned. The prefetcher loads up to
+   * DISK_IO_BATCH_SIZE queued pages at a time, submitting their reads to the disk manager as one batch.
+   *
+   * @param page_ids ids of the pages to load, all owned by this instance
+   * @param strategy the access strategy whose ring the pages are loaded into, or nullptr
+   */
+  void PrefetchPages(const std::vector<page_id_t> &page_ids, BufferAccessStrategy *strategy) override;
+
+  /**
+   * @brief Hand the strategy's ring frames to the replacer and drop its queued prefetches.
+   * @param strategy the strategy being destroyed
+   */
+  void ReleaseStrategy(BufferAccessStrategy *strategy) override;
+
+  /**
+   * @brief Pass the page's compression opt-in on to the disk manager.
+   * @see DiskManager::SetPageCompressed
+   */
+  void SetPageCompressed(page_id_t page_id, bool compressed) override {
+    disk_manager_->SetPageCompressed(page_id, compressed);
+  }
+
+  /**
+   * @brief Keep a page in the buffer pool, or let it be evicted again.
+   *
+   * Making a page resident loads it if necessary and takes its frame out of the replacer; the frame's unpins then
+   * leave it out, like those of ring frames. Resident pages may take at most half of the frames, so that the pool
+   * keeps room for everything else. A resident page can still be deleted, or retired by a shrinking Resize().
+   *
+   * @param page_id id of the page
+   * @param resident whether to keep the page in the buffer pool
+   * @return false if the page could not be loaded, or if the resident pages already take half of the frames
+   */
+  auto SetPageResident(page_id_t page_id, bool resident) -> bool override;
+
+  /**
+   * @brief Return the resident pages, ranked by the replacer from the hottest to the coldest. Pages whose I/O is in
+   * flight are left out.
+   */
+  auto GetHotPages() -> std::vector<page_id_t> override;
+
+  /**
+   * @brief Queue pages on the prefetcher, which loads them in the background like PrefetchPages().
+   *
+   * Only as many pages as there are free frames at the time of the call are queued, so a warm-up never evicts the
+   * pages that queries have loaded in the meantime; the rest are dropped.
+   *
+   * @param page_ids ids of the pages to load, all owned by this instance
+   */
+  void WarmUp(const std::vector<page_id_t> &page_ids) override;
+
+  /** @return the number of pages read from disk by the prefetcher */
+  auto GetNumPrefetchedPages() const -> uint64_t { return stats_.Get(BufferPoolCounter::PREFETCHED_PAGES); }
+
+  /**
+   * @brief Record every FetchPage, NewPage, UnpinPage and DeletePage served from now on to an access trace.
+   *
+   * Unpins are only recorded when they succeed. The trace must outlive the instance, or be detached by passing
+   * nullptr once no requests are in flight.
+   *
+   * @param trace the trace to record to, or nullptr to stop tracing
+   */
+  void SetAccessTrace(AccessTraceWriter *trace) { trace_.store(trace); }
 
  protected:
   /**
@@ -85,6 +260,10 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    *
    * In addition, remember to disable eviction and record the access history of the frame like you did for NewPgImp().
    *
+   * A page-table hit is served without the pool latch: the lock-free page table yields a candidate frame, which is
+   * pinned with a CAS on its pin count and then validated against the requested page id. Frames being recycled
+   * (pin count -1) and page-table misses fall back to the latched path.
+   *
    * @param page_id id of page to be fetched
    * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
    */
@@ -121,7 +300,7 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /**
    * TODO(P1): Add implementation
    *
-   * @brief Flush all the pages in the buffer pool to disk.
+   * @brief Flush all the pages in the buffer pool to disk, then Sync() the disk manager so that they are durable.
    */
   void FlushAllPgsImp() override;
 
@@ -140,43 +319,314 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    */
   auto DeletePgImp(page_id_t page_id) -> bool override;
 
-  /** Number of pages in the buffer pool. */
-  const size_t pool_size_;
-  /** The next page id to be allocated  */
-  std::atomic<page_id_t> next_page_id_ = 0;
-  /** Bucket size for the extendible hash table */
-  const size_t bucket_size_ = 4;
 
-  /** Array of buffer pool pages. */
-  Page *pages_;
+  /**
+   * A fixed-size group of frames. Chunks are never moved or freed before the instance is destroyed, so pinned pages
+   * and lock-free readers holding a frame id stay valid while the pool is resized.
+   */
+  struct FrameChunk {
+    /** The data of the frames, aligned for O_DIRECT. */
+    FrameArena *arena_;
+    /** The pages of the frames, constructed in place. */
+    Page *pages_;
+    /** Per-frame condition variables (used with latch_), signalled when a frame finishes a write-back or a load. */
+    std::condition_variable cvs_[FRAMES_PER_CHUNK];
+    /**
+     * Frames that belong to the ring of some BufferAccessStrategy. Their last unpin leaves them out of the replacer.
+     * Set under latch_, read by the lock-free unpin path.
+     */
+    std::atomic<bool> ring_frames_[FRAMES_PER_CHUNK];
+    /** Frames holding a page made resident by SetPageResident(). Set under latch_, read by the lock-free unpin path. */
+    std::atomic<bool> resident_frames_[FRAMES_PER_CHUNK];
+  };
+
+  /** @return the chunk of the given index */
+  auto GetChunk(size_t chunk_index) -> FrameChunk * { return chunks_.load(std::memory_order_acquire)[chunk_index]; }
+  /** @return the page of a frame */
+  auto GetFrame(frame_id_t frame_id) -> Page & {
+    return GetChunk(frame_id / FRAMES_PER_CHUNK)->pages_[frame_id % FRAMES_PER_CHUNK];
+  }
+  /** @return the condition variable of a frame */
+  auto GetFrameCv(frame_id_t frame_id) -> std::condition_variable & {
+    return GetChunk(frame_id / FRAMES_PER_CHUNK)->cvs_[frame_id % FRAMES_PER_CHUNK];
+  }
+  /** @return whether a frame belongs to the ring of some BufferAccessStrategy */
+  auto GetRingFrame(frame_id_t frame_id) -> std::atomic<bool> & {
+    return GetChunk(frame_id / FRAMES_PER_CHUNK)->ring_frames_[frame_id % FRAMES_PER_CHUNK];
+  }
+  /** @return whether a frame holds a resident page */
+  auto GetResidentFrame(frame_id_t frame_id) -> std::atomic<bool> & {
+    return GetChunk(frame_id / FRAMES_PER_CHUNK)->resident_frames_[frame_id % FRAMES_PER_CHUNK];
+  }
+  /** @return the data of a frame in its chunk's arena */
+  auto GetFrameData(frame_id_t frame_id) -> char * {
+    return GetChunk(frame_id / FRAMES_PER_CHUNK)->arena_->GetFrameData(frame_id % FRAMES_PER_CHUNK);
+  }
+  /** @return the page table, which is replaced by a larger one when the pool grows beyond its capacity */
+  auto GetPageTable() -> ConcurrentPageTable * { return page_table_.load(std::memory_order_acquire); }
+
+  /**
+   * Number of frames in the buffer pool. Frames at or beyond it are retired: they are locked at a pin count of -1
+   * and their memory is released.
+   */
+  std::atomic<size_t> pool_size_;
+  /** How many instances are in the parallel BPM (if present, otherwise just 1 BPI) */
+  const uint32_t num_instances_ = 1;
+  /** Index of this BPI in the parallel BPM (if present, otherwise just 0) */
+  const uint32_t instance_index_ = 0;
+
+  /** The chunks of frames. Replaced by a larger copy when the pool grows; readers may still use an older copy. */
+  std::atomic<FrameChunk **> chunks_{nullptr};
+  /** Number of chunks allocated. Guarded by latch_. */
+  size_t num_chunks_{0};
+  /** Every chunk directory published so far, kept until the instance is destroyed. The last one is chunks_. */
+  std::vector<std::unique_ptr<FrameChunk *[]>> chunk_directories_;
+  /** Whether new chunks back their frames with huge pages. */
+  const bool huge_pages_;
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
+  /** Whether the disk manager is read-only, so that pages are never created, deleted or written back. */
+  const bool read_only_;
   /** Pointer to the log manager. Please ignore this for P1. */
   LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  ExtendibleHashTable<page_id_t, frame_id_t> *page_table_;
-  /** Replacer to find unpinned pages for replacement. */
-  LRUKReplacer *replacer_;
+  /** Page table for keeping track of buffer pool pages. Lock-free for readers, written under latch_. */
+  std::atomic<ConcurrentPageTable *> page_table_;
+  /** Page tables replaced by larger ones, kept for the lock-free readers that may still use them. */
+  std::vector<std::unique_ptr<ConcurrentPageTable>> retired_page_tables_;
+  /**
+   * Replacer to find unpinned pages for replacement. Frames enter it when their pin count drops to zero; a frame
+   * pinned again through the hit path stays in it and is skipped when its eviction CAS fails.
+   */
+  Replacer *replacer_;
+  /**
+   * Second cache tier for clean victims, or nullptr if victim_cache_size was 0. Victims are demoted to it with the
+   * write-back protocol, and misses consult it before the disk manager.
+   */
+  VictimCache *victim_cache_{nullptr};
   /** List of free frames that don't have any pages on them. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /**
+   * Protects the free list, page table updates, the (re)assignment of frames to pages, frame_states_ and
+   * writing_back_. Disk I/O is never performed while holding it.
+   */
   std::mutex latch_;
+  /** Number of frames holding a resident page. Guarded by latch_. */
+  size_t num_resident_frames_{0};
+  /** Serializes Resize() calls, which release latch_ in between the frames they retire. */
+  std::mutex resize_latch_;
+
+  /** I/O state of a frame. A frame that is not READY is pinned at -1 by the thread performing its I/O. */
+  enum class FrameState : uint8_t { READY, WRITING_BACK, LOADING };
+  /** Per-frame I/O state. */
+  std::vector<FrameState> frame_states_;
+  /** Dirty victims whose write-back is in flight, and the frame that still holds their data. */
+  std::unordered_map<page_id_t, frame_id_t> writing_back_;
+
+  /** The page cleaner thread, or nullptr if it is not running. */
+  std::thread *page_cleaner_{nullptr};
+  /** Whether the page cleaner should keep running. Guarded by latch_. */
+  bool page_cleaner_running_{false};
+  /** Set by foreground write-backs to start a cleaning round early. Guarded by latch_. */
+  bool page_cleaner_wakeup_{false};
+  /** Wakes up the page cleaner (used with latch_). */
+  std::condition_variable page_cleaner_cv_;
+  /** Frames whose current page was last written by the page cleaner. Guarded by latch_. */
+  std::vector<bool> cleaned_frames_;
+
+  /** The prefetcher thread, or nullptr if PrefetchPages() has not been called yet. */
+  std::thread *prefetcher_{nullptr};
+  /** Whether the prefetcher should keep running. Guarded by latch_. */
+  bool prefetcher_running_{false};
+  /** Pages waiting to be prefetched, with the strategy to load them through. Guarded by latch_. */
+  std::deque<std::pair<page_id_t, BufferAccessStrategy *>> prefetch_queue_;
+  /** Wakes up the prefetcher (used with latch_). */
+  std::condition_variable prefetch_cv_;
+
+  /** Counters and latency histograms of the requests served and the disk I/O performed. */
+  BufferPoolStatsCollector stats_;
 
- 
+  /** The access trace requests are recorded to, or nullptr. */
+  std::atomic<AccessTraceWriter *> trace_{nullptr};
+
+  /** @brief Record a request to the access trace, if one is set. */
+  void Trace(AccessTraceOp op, page_id_t page_id) {
+    auto *trace = trace_.load(std::memory_order_relaxed);
+    if (trace != nullptr) {
+      trace->Record(op, page_id);
+    }
+  }
+
+  /**
+   * @brief Body of the page cleaner thread.
+   * @param dirty_low_watermark number of dirty frames a cleaning round stops at
+   * @param dirty_high_watermark number of dirty frames that starts a cleaning round
+   * @param interval maximum time between two checks of the dirty frames
+   */
+  void PageCleanerLoop(size_t dirty_low_watermark, size_t dirty_high_watermark, std::chrono::milliseconds interval);
+
+  /**
+   * @brief Body of the prefetcher thread: load queued pages until the instance is destroyed.
+   */
+  void PrefetcherLoop();
+
+  /** @brief Start the prefetcher if necessary and wake it up for the queued pages. Requires latch_. */
+  void WakePrefetcher();
+
+  /**
+   * @brief Make frames [pool_size_, pool_size) usable, allocating chunks, growing the page table and the replacer as
+   * needed, and add them to the free list. Requires latch_.
+   * @param pool_size the new number of frames, larger than pool_size_
+   */
+  void Grow(size_t pool_size);
+
+  /**
+   * @brief Retire the last frame of the pool, writing its page back first if it is dirty, and release its memory.
+   * @param lock the caller's lock on latch_, held on entry and on return
+   * @return false if the frame is pinned or has I/O in flight, true once pool_size_ has shrunk by one
+   */
+  auto RetireLastFrame(std::unique_lock<std::mutex> *lock) -> bool;
+
+  /**
+   * @brief Pin a frame by incrementing its pin count, unless the frame is being recycled.
+   * @param frame_id the frame to pin
+   * @return false if the frame's pin count is -1, true otherwise
+   */
+  auto PinFrame(frame_id_t frame_id) -> bool;
+
+  /**
+   * @brief Drop one pin of a frame. The last unpin records the access and hands the frame to the replacer.
+   * @param frame_id the frame to unpin
+   * @return false if the frame was not pinned, true otherwise
+   */
+  auto UnpinFrame(frame_id_t frame_id) -> bool;
+
+  /**
+   * @brief Take exclusive ownership of an unpinned frame by moving its pin count from 0 to -1.
+   * @param frame_id the frame to lock
+   * @return true if the frame was unpinned and is now owned by the caller
+   */
+  auto LockFrame(frame_id_t frame_id) -> bool;
 
   /**
-   * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Pick a frame from the free list or the replacer, lock it and drop its old mapping from the page table.
+   * With a strategy whose ring is full, the next frame of the ring is recycled instead whenever it is unpinned.
+   * Caller should acquire the latch before calling this function.
+   * @param[out] frame_id the frame that can be reused, with its pin count at -1
+   * @param[out] victim_page_id the old page of the frame if it is dirty and must be written back, or clean and is
+   * demoted to the victim cache; INVALID_PAGE_ID otherwise. The frame's dirty flag tells the two apart until
+   * LoadFrame() clears it.
+   * @param strategy the access strategy whose ring the frame joins, or nullptr
+   * @return false if all frames are pinned, true otherwise
+   */
+  auto AcquireFrame(frame_id_t *frame_id, page_id_t *victim_page_id, BufferAccessStrategy *strategy = nullptr)
+      -> bool;
+
+  /**
+   * @brief Take a frame out of its ring and hand it to the replacer. Caller should acquire the latch.
+   *
+   * The frame may still be pinned: the replacer then skips it until its last unpin, which sees it outside of any
+   * ring and hands it over again.
+   *
+   * @param frame_id the frame to return
+   */
+  void ReturnRingFrame(frame_id_t frame_id);
+
+  /**
+   * @brief Finish recycling a frame acquired by AcquireFrame(): write back or demote the victim and, if requested,
+   * read the frame's new page from the victim cache or from disk. latch_ is released around each of these steps;
+   * requesters of either page wait on the frame's condition variable meanwhile.
+   * @param lock the caller's lock on latch_, held on entry and on return
+   * @param frame_id the frame, already mapped to its new page in the page table
+   * @param victim_page_id the page to write back or demote first, or INVALID_PAGE_ID
+   * @param read_page whether to read the new page
+   */
+  void LoadFrame(std::unique_lock<std::mutex> *lock, frame_id_t frame_id, page_id_t victim_page_id, bool read_page);
+
+  /**
+   * @brief Read a page into a frame, from the victim cache if it is there and from disk otherwise. Called without
+   * latch_, while the frame is LOADING.
+   */
+  void ReadFrame(frame_id_t frame_id);
+
+  /** @brief Read a page from disk, recording the read in stats_. Called without latch_. */
+  void ReadPageFromDisk(page_id_t page_id, char *page_data);
+
+  /** @brief Write a page to disk, recording the write in stats_. Called without latch_. */
+  void WritePageToDisk(page_id_t page_id, const char *page_data);
+
+  /**
+   * @brief Submit a batch of page I/Os to the disk manager, wait for it and record the I/Os in stats_. Called without
+   * latch_.
+   * @param requests the requests, whose callbacks must not have been retrieved yet
+   * @return whether each request succeeded
+   */
+  auto SubmitDiskRequests(std::vector<DiskRequest> *requests) -> std::vector<bool>;
+
+  /**
+   * @brief Point the page of a frame being loaded at its mapping in a read-only disk manager, or back at the frame's
+   * own data if the page is not mapped. Only called on locked frames.
+   * @param frame_id the frame, already mapped to its new page in the page table
+   * @param read_page whether the new page is read from disk, rather than created
+   * @return true if the page is mapped and needs no read
+   */
+  auto MapFrame(frame_id_t frame_id, bool read_page) -> bool;
+
+  /** @brief Throw if the buffer pool is read-only, before an operation that would modify the database file. */
+  void CheckWritable(const char *operation) const;
+
+  /**
+   * @brief Like LoadFrame() with read_page set, for several frames at once: the victims' write-backs are submitted
+   * to the disk manager as one batch, then the reads of the new pages that miss the victim cache as another.
+   * @param lock the caller's lock on latch_, held on entry and on return
+   * @param loads the frames, already mapped to their new pages, with the page each must write back first or
+   * INVALID_PAGE_ID
+   * @return whether each frame was loaded. A frame whose victim failed to write back keeps the victim, dirty and
+   * unpinned; a frame whose page failed to read goes back to the free list.
+   */
+  auto LoadFrames(std::unique_lock<std::mutex> *lock, const std::vector<std::pair<frame_id_t, page_id_t>> &loads)
+      -> std::vector<bool>;
+
+  /**
+   * @brief Write back a batch of dirty frames the page cleaner has pinned and hidden from the replacer, then unpin
+   * them. The pages are copied under their read latches and the copies submitted as one batch.
+   * @param lock the caller's lock on latch_, held on entry and on return
+   * @param batch the frames with the pages they hold; cleared on return
+   */
+  void CleanFrames(std::unique_lock<std::mutex> *lock, std::vector<std::pair<frame_id_t, page_id_t>> *batch);
+
+  /**
+   * @brief Pin a resident page, waiting for in-flight I/O on it to finish. Caller must hold latch_ through `lock`.
+   *
+   * If the page is being loaded, wait until its frame is READY. If the page is being written back, wait until the
+   * write-back completes, after which it is no longer resident.
+   *
+   * @param lock the caller's lock on latch_
+   * @param page_id the page to pin
+   * @param[out] frame_id the frame holding the page
+   * @return true if the page was pinned, false if it is not in the buffer pool
+   */
+  auto PinResidentPage(std::unique_lock<std::mutex> *lock, page_id_t page_id, frame_id_t *frame_id) -> bool;
+
+  /**
+   * @brief Allocate a page on disk, reusing a deallocated page of this instance's shard if there is one. Caller
+   * should acquire the latch before calling this function.
    * @return the id of the allocated page
    */
   auto AllocatePage() -> page_id_t;
 
   /**
-   * @brief Deallocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Validate that the page_id being used is accessible to this BPI. This can be used in all of the functions
+   * to validate input data and ensure that a parallel BPM is routing requests to the correct BPI.
+   * @param page_id the page id to validate
+   */
+  void ValidatePageId(page_id_t page_id) const;
+
+  /**
+   * @brief Deallocate a page on disk, returning it to the disk manager's free page map. Caller should acquire the
+   * latch before calling this function.
    * @param page_id id of the page to deallocate
    */
-  void DeallocatePage(__attribute__((unused)) page_id_t page_id) {
-    // This is a no-nop right now without a more complex data structure to track deallocated pages
-  }
+  void DeallocatePage(page_id_t page_id);
 
   // TODO(student): You may add additional private members and helper functions
 };
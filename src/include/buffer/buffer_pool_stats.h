@@ -0,0 +1,175 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats.h
+//
+// Identification: src/include/buffer/buffer_pool_stats.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <string>
+
+namespace bustub {
+
+/** Events a buffer pool counts. */
+enum class BufferPoolCounter : uint8_t {
+  FETCH_HITS,
+  FETCH_MISSES,
+  NEW_PAGES,
+  EVICTIONS,
+  /** Dirty victims written back by NewPage/FetchPage themselves. */
+  DIRTY_WRITE_BACKS,
+  CLEANER_WRITE_BACKS,
+  /** Clean victims that needed no write-back because the page cleaner had already written them. */
+  AVOIDED_WRITE_BACKS,
+  PREFETCHED_PAGES,
+  /** Requests that found their page with I/O in flight and waited for it. */
+  PIN_WAITS,
+  DISK_READS,
+  DISK_WRITES,
+  NUM_COUNTERS
+};
+
+/** Operations a buffer pool measures the latency of. */
+enum class BufferPoolLatency : uint8_t { FETCH_HIT, FETCH_MISS, PIN_WAIT, DISK_READ, DISK_WRITE, NUM_LATENCIES };
+
+/** @return the name of a counter as SHOW BUFFER_POOL prints it, e.g. "fetch_hits" */
+auto BufferPoolCounterToString(BufferPoolCounter counter) -> std::string;
+
+/** @return the name of a latency as SHOW BUFFER_POOL prints it, e.g. "disk_read" */
+auto BufferPoolLatencyToString(BufferPoolLatency latency) -> std::string;
+
+/**
+ * LatencyHistogram counts latencies in power-of-two buckets of nanoseconds: bucket i holds the latencies in
+ * [2^i, 2^(i+1)), bucket 0 also holds 0. Percentiles are reported as the upper bound of their bucket, so they are
+ * accurate to a factor of two.
+ */
+struct LatencyHistogram {
+  static constexpr size_t NUM_BUCKETS = 40;
+
+  std::array<uint64_t, NUM_BUCKETS> buckets_{};
+  uint64_t count_{0};
+  uint64_t sum_ns_{0};
+
+  /** @return the bucket a latency falls into */
+  static auto BucketOf(uint64_t latency_ns) -> size_t {
+    size_t bucket = latency_ns == 0 ? 0 : 63 - __builtin_clzll(latency_ns);
+    return bucket < NUM_BUCKETS ? bucket : NUM_BUCKETS - 1;
+  }
+
+  auto operator+=(const LatencyHistogram &other) -> LatencyHistogram &;
+
+  /** @return the mean latency in nanoseconds, or 0 if nothing was recorded */
+  auto GetMeanNs() const -> uint64_t { return count_ == 0 ? 0 : sum_ns_ / count_; }
+
+  /**
+   * @param percentile the percentile, between 0 and 100
+   * @return the upper bound of the bucket the percentile falls into, in nanoseconds, or 0 if nothing was recorded
+   */
+  auto GetPercentileNs(double percentile) const -> uint64_t;
+};
+
+/**
+ * A snapshot of the counters and latency histograms of a buffer pool, see BufferPoolManager::GetStats(). Snapshots
+ * of several instances add up.
+ */
+struct BufferPoolStats {
+  std::array<uint64_t, static_cast<size_t>(BufferPoolCounter::NUM_COUNTERS)> counters_{};
+  std::array<LatencyHistogram, static_cast<size_t>(BufferPoolLatency::NUM_LATENCIES)> latencies_{};
+
+  auto Get(BufferPoolCounter counter) const -> uint64_t { return counters_[static_cast<size_t>(counter)]; }
+
+  auto GetLatency(BufferPoolLatency latency) const -> const LatencyHistogram & {
+    return latencies_[static_cast<size_t>(latency)];
+  }
+
+  /** @return the fraction of the fetches that were hits */
+  auto GetHitRatio() const -> double {
+    auto fetches = Get(BufferPoolCounter::FETCH_HITS) + Get(BufferPoolCounter::FETCH_MISSES);
+    return fetches == 0 ? 0.0 : static_cast<double>(Get(BufferPoolCounter::FETCH_HITS)) / fetches;
+  }
+
+  auto operator+=(const BufferPoolStats &other) -> BufferPoolStats &;
+};
+
+/**
+ * BufferPoolStatsCollector records the counters and latencies of one buffer pool instance with as little overhead as
+ * possible on the paths it measures.
+ *
+ * Every thread records into its own shard, picked once per thread, so that threads do not bounce each other's
+ * cache lines; relaxed atomic increments only matter once more threads than NUM_SHARDS record at the same time.
+ * GetSnapshot() sums up the shards; it is not atomic with respect to concurrent recording, which only means that a
+ * snapshot may count some events of an operation and not others.
+ */
+class BufferPoolStatsCollector {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr size_t NUM_SHARDS = 16;
+
+  /**
+   * Every thread times one in FETCH_SAMPLE_RATE of its fetches: a hit takes tens of nanoseconds, which two clock reads
+   * would noticeably add to. The hit latency histogram therefore counts samples, not hits.
+   */
+  static constexpr uint32_t FETCH_SAMPLE_RATE = 16;
+
+  /** @return the start time of a fetch if the calling thread samples it, Clock::time_point() otherwise */
+  static auto StartFetch() -> Clock::time_point {
+    thread_local uint32_t fetches = 0;
+    return fetches++ % FETCH_SAMPLE_RATE == 0 ? Clock::now() : Clock::time_point();
+  }
+
+  void Add(BufferPoolCounter counter, uint64_t count = 1) {
+    GetShard().counters_[static_cast<size_t>(counter)].fetch_add(count, std::memory_order_relaxed);
+  }
+
+  /** @brief Record the latency of an operation that started at `start`. */
+  void Record(BufferPoolLatency latency, Clock::time_point start) {
+    auto latency_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    auto &histogram = GetShard().latencies_[static_cast<size_t>(latency)];
+    histogram.buckets_[LatencyHistogram::BucketOf(latency_ns)].fetch_add(1, std::memory_order_relaxed);
+    histogram.sum_ns_.fetch_add(latency_ns, std::memory_order_relaxed);
+  }
+
+  /** @brief Count an event and record its latency, unless its start time is Clock::time_point(). */
+  void Record(BufferPoolCounter counter, BufferPoolLatency latency, Clock::time_point start) {
+    Add(counter);
+    if (start != Clock::time_point()) {
+      Record(latency, start);
+    }
+  }
+
+  auto Get(BufferPoolCounter counter) const -> uint64_t;
+
+  auto GetSnapshot() const -> BufferPoolStats;
+
+ private:
+  struct AtomicHistogram {
+    std::array<std::atomic<uint64_t>, LatencyHistogram::NUM_BUCKETS> buckets_{};
+    std::atomic<uint64_t> sum_ns_{0};
+  };
+
+  struct alignas(64) Shard {
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(BufferPoolCounter::NUM_COUNTERS)> counters_{};
+    std::array<AtomicHistogram, static_cast<size_t>(BufferPoolLatency::NUM_LATENCIES)> latencies_{};
+  };
+
+  /** @return the shard of the calling thread */
+  auto GetShard() -> Shard & { return shards_[GetThreadShard()]; }
+
+  static auto GetThreadShard() -> size_t;
+
+  std::array<Shard, NUM_SHARDS> shards_{};
+};
+
+}  // namespace bustub
@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// concurrent_page_table.h
+//
+// Identification: src/include/buffer/concurrent_page_table.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ConcurrentPageTable maps page ids to frame ids for a buffer pool of a fixed number of frames.
+ *
+ * It is a linear-probing hash table whose slots are single atomic words holding a packed (page_id, frame_id)
+ * pair, so readers never take a latch and never write to shared memory. Writers must be serialized by the
+ * caller (the buffer pool latch). Deletion shifts later entries of the probe chain backwards instead of
+ * leaving tombstones, so a lock-free Find racing with a writer may miss an entry that is present. It never
+ * returns a pair that was not in the table at some point, so callers treat a hit as a hint that must be
+ * validated against the frame, and retry a miss under the writer latch.
+ */
+class ConcurrentPageTable {
+ public:
+  /**
+   * @brief Create a new ConcurrentPageTable.
+   * @param num_frames the maximum number of entries the table will be required to store
+   */
+  explicit ConcurrentPageTable(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(ConcurrentPageTable);
+
+  ~ConcurrentPageTable() = default;
+
+  /**
+   * @brief Find the frame currently holding the given page. Safe to call without any latch.
+   * @param page_id the page to look up
+   * @param[out] frame_id the frame that held the page when its slot was read
+   * @return true if the page was found, false otherwise
+   */
+  auto Find(page_id_t page_id, frame_id_t *frame_id) const -> bool;
+
+  /**
+   * @brief Insert a mapping for a page that is not in the table. Caller must hold the writer latch.
+   * @param page_id the page to insert
+   * @param frame_id the frame holding the page
+   */
+  void Insert(page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * @brief Remove the mapping of the given page. Caller must hold the writer latch.
+   * @param page_id the page to remove
+   * @return true if the page was in the table, false otherwise
+   */
+  auto Remove(page_id_t page_id) -> bool;
+
+  /**
+   * @brief Insert every mapping of another table, e.g. when moving to a larger one. Caller must hold the writer latch
+   * of both tables.
+   * @param other the table to copy the mappings of
+   */
+  void InsertAll(const ConcurrentPageTable &other);
+
+  /** @return the maximum number of entries the table was created for */
+  auto GetNumFrames() const -> size_t { return num_frames_; }
+
+ private:
+  static constexpr uint64_t EMPTY_SLOT = UINT64_MAX;
+
+  static auto Pack(page_id_t page_id, frame_id_t frame_id) -> uint64_t {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << 32) | static_cast<uint32_t>(frame_id);
+  }
+  static auto PageIdOf(uint64_t slot) -> page_id_t { return static_cast<page_id_t>(slot >> 32); }
+  static auto FrameIdOf(uint64_t slot) -> frame_id_t { return static_cast<frame_id_t>(slot & UINT32_MAX); }
+
+  /** @return the home slot of the given page */
+  auto HomeOf(page_id_t page_id) const -> size_t;
+
+  /** The maximum number of entries. */
+  size_t num_frames_;
+  /** Number of slots, a power of two at least twice the number of frames. */
+  size_t capacity_;
+  /** capacity_ - 1, used to wrap probe positions. */
+  size_t mask_;
+  std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+};
+
+}  // namespace bustub
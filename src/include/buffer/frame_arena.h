@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.h
+//
+// Identification: src/include/buffer/frame_arena.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * FrameArena is one contiguous, BUSTUB_PAGE_SIZE-aligned allocation holding the data of every frame of a buffer
+ * pool. The alignment lets a disk manager opened with O_DIRECT read and write frames without a bounce buffer.
+ *
+ * With huge pages requested, the arena is first mapped with MAP_HUGETLB, which needs huge pages reserved by the
+ * administrator; if that fails it falls back to regular pages with a transparent huge page hint.
+ */
+class FrameArena {
+ public:
+  /**
+   * @brief Map and zero an arena for the given number of frames.
+   * @param num_frames the number of frames
+   * @param huge_pages whether to back the arena with huge pages
+   */
+  FrameArena(size_t num_frames, bool huge_pages);
+
+  DISALLOW_COPY_AND_MOVE(FrameArena);
+
+  ~FrameArena();
+
+  /** @return the data of a frame */
+  auto GetFrameData(frame_id_t frame_id) -> char * { return data_ + static_cast<size_t>(frame_id) * BUSTUB_PAGE_SIZE; }
+
+  /**
+   * @brief Return the memory of a frame to the operating system. The frame reads as zeroes when it is next touched.
+   * Arenas mapped with MAP_HUGETLB keep their memory.
+   * @param frame_id the frame
+   */
+  void ReleaseFrameData(frame_id_t frame_id);
+
+  /** @return whether the arena is mapped with MAP_HUGETLB */
+  auto UsesHugeTlb() const -> bool { return huge_tlb_; }
+
+ private:
+  char *data_;
+  size_t size_;
+  bool huge_tlb_{false};
+};
+
+}  // namespace bustub
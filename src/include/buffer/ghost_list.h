@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// ghost_list.h
+//
+// Identification: src/include/buffer/ghost_list.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <iterator>
+#include <list>
+#include <unordered_map>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * GhostList remembers the ids of recently evicted pages in eviction order, so that replacement policies can
+ * recognize a page that is read back soon after its eviction. It holds no frames and no page data.
+ */
+class GhostList {
+ public:
+  /** @return whether the page is remembered */
+  auto Contains(page_id_t page_id) const -> bool { return index_.count(page_id) != 0; }
+
+  /** @return the number of remembered pages */
+  auto Size() const -> size_t { return pages_.size(); }
+
+  /** @brief Remember a page as the most recently evicted one. */
+  void PushBack(page_id_t page_id) {
+    Erase(page_id);
+    pages_.push_back(page_id);
+    index_[page_id] = std::prev(pages_.end());
+  }
+
+  /** @brief Forget the least recently evicted page. The list must not be empty. */
+  void PopFront() {
+    index_.erase(pages_.front());
+    pages_.pop_front();
+  }
+
+  /** @brief Forget a page, if it is remembered. */
+  void Erase(page_id_t page_id) {
+    auto it = index_.find(page_id);
+    if (it != index_.end()) {
+      pages_.erase(it->second);
+      index_.erase(it);
+    }
+  }
+
+ private:
+  /** Remembered pages, least recently evicted first. */
+  std::list<page_id_t> pages_;
+  std::unordered_map<page_id_t, std::list<page_id_t>::iterator> index_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,47 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hot_page_set.h
+//
+// Identification: src/include/buffer/hot_page_set.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * HotPageSet persists the hot pages of a buffer pool in a small sidecar file, so that a restarted buffer pool can be
+ * warmed up with them instead of starting out empty.
+ *
+ * The file starts with an 8-byte magic, followed by the page ids as 4-byte integers, hottest first. It is written to
+ * a temporary file that is renamed over the old one, so a crash never leaves a torn file behind.
+ */
+class HotPageSet {
+ public:
+  /**
+   * @brief Write the hot pages to a file, replacing any existing file.
+   * @param file_name the path of the file
+   * @param page_ids the hot pages, hottest first
+   * @return false if the file could not be written
+   */
+  static auto Save(const std::string &file_name, const std::vector<page_id_t> &page_ids) -> bool;
+
+  /**
+   * @brief Read the hot pages back from a file.
+   * @param file_name the path of the file
+   * @return the hot pages, hottest first; empty if the file does not exist or is not a hot page file
+   */
+  static auto Load(const std::string &file_name) -> std::vector<page_id_t>;
+};
+
+}  // namespace bustub
@@ -12,16 +12,15 @@
 
 #pragma once
 
-#include <limits>
-#include <list>
 #include <mutex>  // NOLINT
-#include <unordered_map>
+#include <set>
+#include <tuple>
 #include <vector>
 
+#include "buffer/replacer.h"
 #include "common/config.h"
 #include "common/macros.h"
 
-
 namespace bustub {
 
 /**
@@ -34,8 +33,15 @@ namespace bustub {
  * A frame with less than k historical references is given
  * +inf as its backward k-distance. When multiple frames have +inf backward k-distance,
  * classical LRU algorithm is used to choose victim.
+ *
+ * Timestamps come from a logical counter that advances on every access. The last k timestamps of each frame are
+ * kept in a preallocated ring, and the evictable frames are kept in an ordered set keyed on their eviction priority,
+ * so every operation runs in O(log n).
+ *
+ * Frames are first ordered by the priority of the page class of their last access (see PageClassPriorities): LRU-K
+ * only picks among the evictable frames of the lowest priority present.
  */
-class LRUKReplacer {
+class LRUKReplacer : public Replacer {
  public:
   /**
    *
@@ -53,7 +59,7 @@ class LRUKReplacer {
    *
    * @brief Destroys the LRUReplacer.
    */
-  ~LRUKReplacer() = default;
+  ~LRUKReplacer() override = default;
 
   /**
    * TODO(P1): Add implementation
@@ -86,6 +92,16 @@ class LRUKReplacer {
    */
   void RecordAccess(frame_id_t frame_id);
 
+  /** @brief Record an access to a frame. LRU-K does not remember evicted pages, so the page id is unused. */
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override { RecordAccess(frame_id); }
+
+  /**
+   * @brief Record an access to a frame, which takes the priority of the page's class until its next access.
+   */
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id, PageClass page_class) override;
+
+  void SetPageClassPriorities(const PageClassPriorities &priorities) override;
+
   /**
    * TODO(P1): Add implementation
    *
@@ -103,26 +119,30 @@ class LRUKReplacer {
    * @param frame_id id of frame whose 'evictable' status will be modified
    * @param set_evictable whether the given frame is evictable or not
    */
-  void SetEvictable(frame_id_t frame_id, bool set_evictable);
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  /** @return whether the frame has an access history */
+  auto IsTracked(frame_id_t frame_id) -> bool override;
 
   /**
    * TODO(P1): Add implementation
    *
-   * @brief Remove an evictable frame from replacer, along with its access history.
-   * This function should also decrement replacer's size if removal is successful.
+   * @brief Remove a frame from replacer, along with its access history.
+   * This function should also decrement replacer's size if the frame was evictable.
    *
    * Note that this is different from evicting a frame, which always remove the frame
    * with largest backward k-distance. This function removes specified frame id,
    * no matter what its backward k-distance is.
    *
-   * If Remove is called on a non-evictable frame, throw an exception or abort the
-   * process.
+   * A non-evictable frame is removed as well: the buffer pool removes the frames of
+   * deleted pages, which may have been made non-evictable, and their history must not
+   * carry over to the next page in the frame.
    *
    * If specified frame is not found, directly return from this function.
    *
    * @param frame_id id of frame to be removed
    */
-  void Remove(frame_id_t frame_id);
+  void Remove(frame_id_t frame_id) override;
 
   /**
    * TODO(P1): Add implementation
@@ -131,18 +151,55 @@ class LRUKReplacer {
    *
    * @return size_t
    */
-  auto Size() -> size_t;
+  auto Size() -> size_t override;
+
+  /** @brief Same as Evict(). */
+  auto Victim(frame_id_t *frame_id) -> bool override { return Evict(frame_id); }
+
+  /** @brief Same as SetEvictable(frame_id, false). */
+  void Pin(frame_id_t frame_id) override { SetEvictable(frame_id, false); }
+
+  /** @brief Same as SetEvictable(frame_id, true). */
+  void Unpin(frame_id_t frame_id) override { SetEvictable(frame_id, true); }
+
+  /**
+   * @brief Order frames by descending eviction key, pinned or not. Frames without any recorded access rank coldest.
+   */
+  void RankByHotness(std::vector<frame_id_t> *frame_ids) override;
+
+  /**
+   * @brief Grow or shrink the access histories. The histories of the remaining frames are kept.
+   */
+  void SetNumFrames(size_t num_frames) override;
 
  private:
-  // TODO(student): implement me! You can replace these member variables as you like.
-  // Remove maybe_unused if you start using them.
-  [[maybe_unused]] size_t current_timestamp_{0};
-  [[maybe_unused]] size_t curr_size_{0};
-  [[maybe_unused]] size_t replacer_size_;
-  [[maybe_unused]] size_t k_;
+  /**
+   * Eviction priority of a frame; the smallest key is evicted first. Frames of a lower class priority come first.
+   * Within a priority, frames with fewer than k accesses (+inf backward k-distance) come first, ordered by their
+   * earliest access, then the others ordered by their kth most recent access. The frame id makes keys unique.
+   */
+  using EvictionKey = std::tuple<uint8_t, bool, size_t, frame_id_t>;
+
+  /** @return the eviction key of a frame with at least one recorded access */
+  auto GetEvictionKey(frame_id_t frame_id) const -> EvictionKey;
+
+  size_t current_timestamp_{0};
+  size_t curr_size_{0};
+  size_t replacer_size_;
+  size_t k_;
   std::mutex latch_;
-  std::unordered_map<frame_id_t, std::vector<std::time_t>> access_history_;
-  std::unordered_map<frame_id_t, bool> is_evicted_;
+  /** The last k access timestamps of every frame, stored in k consecutive slots per frame used as a ring. */
+  std::vector<size_t> history_;
+  /** Slot of the oldest timestamp in the ring of every frame. */
+  std::vector<size_t> history_head_;
+  /** Number of timestamps in the ring of every frame, at most k. Frames without any are not tracked. */
+  std::vector<size_t> history_size_;
+  std::vector<bool> evictable_;
+  /** Class priority of the last access of every frame. */
+  std::vector<uint8_t> class_priority_;
+  PageClassPriorities priorities_{DEFAULT_PAGE_CLASS_PRIORITIES};
+  /** The evictable frames, ordered by eviction priority. */
+  std::set<EvictionKey> evictable_frames_;
 };
 
 }  // namespace bustub
\ No newline at end of file
@@ -0,0 +1,198 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/parallel_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/config.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * ParallelBufferPoolManager partitions the buffer pool into several independent BufferPoolManagerInstances.
+ *
+ * Every page id is owned by exactly one instance (page_id % num_instances), and each instance has its own latch,
+ * page table, replacer and free list. Threads working on pages of different shards therefore never contend
+ * on the same latch.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * @brief Creates a new ParallelBufferPoolManager.
+   * @param num_instances the number of individual BufferPoolManagerInstances to store
+   * @param pool_size the pool size of each BufferPoolManagerInstance
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer of each instance
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy of each instance
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            size_t replacer_k = LRUK_REPLACER_K, LogManager *log_manager = nullptr,
+                            ReplacerType replacer_type = ReplacerType::LRU_K);
+
+  /**
+   * @brief Destroys an existing ParallelBufferPoolManager.
+   */
+  ~ParallelBufferPoolManager() override;
+
+  /** @brief Return the total size (number of frames) of all the BufferPoolManagerInstances. */
+  auto GetPoolSize() -> size_t override;
+
+  /**
+   * @brief Resize every instance, splitting the frames evenly; the first instances get one more frame each if they do
+   * not divide evenly.
+   * @param pool_size the new total number of frames, at least one per instance
+   * @return true if every instance was resized, false otherwise
+   */
+  auto Resize(size_t pool_size) -> bool override;
+
+  /** @brief Return the counters of the victim caches of all the instances, summed up. */
+  auto GetVictimCacheStats() -> VictimCacheStats override;
+
+  /** @brief Return the stats of all the instances, summed up. */
+  auto GetStats() -> BufferPoolStats override;
+
+  /** @brief Return the number of BufferPoolManagerInstances in this pool. */
+  auto GetNumInstances() const -> size_t { return instances_.size(); }
+
+  /**
+   * @brief Return the BufferPoolManagerInstance responsible for handling the given page id.
+   * @param page_id id of page
+   * @return pointer to the BufferPoolManagerInstance that owns the page
+   */
+  auto GetBufferPoolManager(page_id_t page_id) -> BufferPoolManagerInstance *;
+
+  /**
+   * @brief Start one page cleaner per instance. The watermarks apply to each instance separately.
+   * @see BufferPoolManagerInstance::RunPageCleaner
+   */
+  void RunPageCleaner(size_t dirty_low_watermark, size_t dirty_high_watermark,
+                      std::chrono::milliseconds interval = page_cleaner_interval);
+
+  /**
+   * @brief Stop the page cleaners of all instances.
+   */
+  void StopPageCleaner();
+
+  /**
+   * @brief Fetch a page through the instance that owns it, which loads a miss into its share of the strategy's ring.
+   * @see BufferPoolManagerInstance::FetchPageWithStrategy
+   */
+  auto FetchPageWithStrategy(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * override;
+
+  /**
+   * @brief Split the pages by owning instance and queue each group on its instance's prefetcher.
+   * @see BufferPoolManagerInstance::PrefetchPages
+   */
+  void PrefetchPages(const std::vector<page_id_t> &page_ids, BufferAccessStrategy *strategy) override;
+
+  /**
+   * @brief Release the strategy's ring in every instance.
+   */
+  void ReleaseStrategy(BufferAccessStrategy *strategy) override;
+
+  /**
+   * @brief Pass the page's compression opt-in on through the instance that owns it.
+   */
+  void SetPageCompressed(page_id_t page_id, bool compressed) override {
+    GetBufferPoolManager(page_id)->SetPageCompressed(page_id, compressed);
+  }
+
+  /**
+   * @brief Keep a page resident in, or release it from, the instance that owns it. Each instance lets resident pages
+   * take at most half of its own frames.
+   */
+  auto SetPageResident(page_id_t page_id, bool resident) -> bool override {
+    return GetBufferPoolManager(page_id)->SetPageResident(page_id, resident);
+  }
+
+  /**
+   * @brief Interleave the hot pages of the instances. Their rankings are not comparable with each other, so the
+   * hottest pages of every instance come first.
+   */
+  auto GetHotPages() -> std::vector<page_id_t> override;
+
+  /**
+   * @brief Split the pages by owning instance and warm up every instance with its share, keeping their order.
+   * @see BufferPoolManagerInstance::WarmUp
+   */
+  void WarmUp(const std::vector<page_id_t> &page_ids) override;
+
+  /**
+   * @brief Record the requests of every instance to one access trace.
+   * @see BufferPoolManagerInstance::SetAccessTrace
+   */
+  void SetAccessTrace(AccessTraceWriter *trace);
+
+ protected:
+  /**
+   * @brief Fetch the requested page from the instance that owns it.
+   * @param page_id id of page to be fetched
+   * @return the requested page
+   */
+  auto FetchPgImp(page_id_t page_id) -> Page * override;
+
+  /**
+   * @brief Unpin the target page from the instance that owns it.
+   * @param page_id id of page to be unpinned
+   * @param is_dirty true if the page should be marked as dirty, false otherwise
+   * @return false if the page pin count is <= 0 before this call, true otherwise
+   */
+  auto UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool override;
+
+  /**
+   * @brief Flush the target page to disk through the instance that owns it.
+   * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
+   * @return false if the page could not be found in the page table, true otherwise
+   */
+  auto FlushPgImp(page_id_t page_id) -> bool override;
+
+  /**
+   * @brief Create a new page in one of the instances.
+   *
+   * Instances are tried in round-robin order, starting from a different instance on every call so that new pages
+   * are spread evenly over the shards. Each instance is tried at most once; if all of them fail, nullptr is returned.
+   *
+   * @param[out] page_id id of created page
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPgImp(page_id_t *page_id) -> Page * override;
+
+  /**
+   * @brief Delete a page from the instance that owns it.
+   * @param page_id id of page to be deleted
+   * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
+   */
+  auto DeletePgImp(page_id_t page_id) -> bool override;
+
+  /**
+   * @brief Flush all the pages of every instance to disk.
+   */
+  void FlushAllPgsImp() override;
+
+ private:
+  /** The shards, indexed by page_id % num_instances. */
+  std::vector<std::unique_ptr<BufferPoolManagerInstance>> instances_;
+  /** The instance NewPgImp starts searching from on its next call. */
+  std::atomic<size_t> next_instance_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,54 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// read_ahead.h
+//
+// Identification: src/include/buffer/read_ahead.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * ReadAhead drives the prefetching of a single scan over a chain of pages, such as the pages of a TableHeap or the
+ * leaves of a B+ tree.
+ *
+ * The successor of a page in such a chain is only known once the page has been read, so the known successor is
+ * always prefetched while the scan works on the current page. When the chain is laid out in consecutive page ids,
+ * the pages after the successor are predicted as well: the window of predicted pages starts at READ_AHEAD_MIN_PAGES
+ * and doubles on every sequential step, up to READ_AHEAD_MAX_PAGES or a quarter of the pool (half of the ring for a
+ * scan with an access strategy). Any jump in the chain resets the window.
+ */
+class ReadAhead {
+ public:
+  /**
+   * @brief Report that the scan moved onto a page, and prefetch the pages expected to follow it.
+   * @param bpm the buffer pool the scan reads from
+   * @param page_id the page the scan is now on
+   * @param next_page_id the successor of the page in the chain, or INVALID_PAGE_ID at the end of the chain
+   * @param strategy the access strategy the scan fetches its pages with, or nullptr
+   */
+  void OnPage(BufferPoolManager *bpm, page_id_t page_id, page_id_t next_page_id,
+              BufferAccessStrategy *strategy = nullptr);
+
+  /** @return the current number of pages predicted ahead of the scan, 0 if the scan is not sequential */
+  auto GetWindow() const -> size_t { return window_; }
+
+ private:
+  /** The page the scan was on before the current one. */
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+  /** The highest page id already handed to PrefetchPages(). */
+  page_id_t prefetched_until_{INVALID_PAGE_ID};
+  size_t window_{0};
+};
+
+}  // namespace bustub
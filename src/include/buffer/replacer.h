@@ -12,12 +12,32 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <vector>
+
 #include "common/config.h"
 
 namespace bustub {
 
+/** The replacement policies a buffer pool can be created with. */
+enum class ReplacerType { LRU_K, ARC, TWO_Q };
+
+/** Eviction priority of every page class, indexed by PageClass. Frames of a lower priority are evicted first. */
+using PageClassPriorities = std::array<uint8_t, static_cast<size_t>(PageClass::NUM_CLASSES)>;
+
+/**
+ * Index-internal pages, touched by every lookup, are evicted last, then index leaves; untagged and heap pages come
+ * before them, and temporary pages first of all. Index order: UNKNOWN, INDEX_INTERNAL, INDEX_LEAF, HEAP, TEMP.
+ */
+static constexpr PageClassPriorities DEFAULT_PAGE_CLASS_PRIORITIES = {1, 3, 2, 1, 0};
+
 /**
  * Replacer is an abstract class that tracks page usage.
+ *
+ * Besides the classic Victim/Pin/Unpin interface, the buffer pool reports every access to a frame together with the
+ * page it holds, so that policies which remember evicted pages (ARC, 2Q) recognize them when they are read back.
+ * The defaults map these calls onto the classic interface.
  */
 class Replacer {
  public:
@@ -45,6 +65,78 @@ class Replacer {
 
   /** @return the number of elements in the replacer that can be victimized */
   virtual auto Size() -> size_t = 0;
+
+  /**
+   * Record an access to a frame. A frame that is not tracked yet starts being tracked, as non-evictable.
+   * @param frame_id the id of the frame that was accessed
+   * @param page_id the id of the page the frame holds
+   */
+  virtual void RecordAccess(frame_id_t frame_id, page_id_t page_id) {}
+
+  /**
+   * Record an access to a frame whose page was tagged with a class. Policies that honor classes evict frames by the
+   * priority of the class of their last access first; the default ignores the class.
+   * @param frame_id the id of the frame that was accessed
+   * @param page_id the id of the page the frame holds
+   * @param page_class the class of the page
+   */
+  virtual void RecordAccess(frame_id_t frame_id, page_id_t page_id, PageClass page_class) {
+    RecordAccess(frame_id, page_id);
+  }
+
+  /**
+   * Change the eviction priority of the page classes. Frames keep the priority of their last access until they are
+   * accessed again. Policies that ignore classes ignore it.
+   * @param priorities the priority of every class; all equal to disable class priorities
+   */
+  virtual void SetPageClassPriorities(const PageClassPriorities &priorities) {}
+
+  /**
+   * Toggle whether a tracked frame may be victimized. Untracked frames are ignored.
+   * @param frame_id the id of the frame
+   * @param set_evictable whether the frame may be victimized
+   */
+  virtual void SetEvictable(frame_id_t frame_id, bool set_evictable) {
+    if (set_evictable) {
+      Unpin(frame_id);
+    } else {
+      Pin(frame_id);
+    }
+  }
+
+  /**
+   * @return whether the frame is tracked, i.e. whether SetEvictable() has an effect on it. Policies whose Unpin()
+   * starts tracking any frame report every frame as tracked.
+   */
+  virtual auto IsTracked(frame_id_t frame_id) -> bool { return true; }
+
+  /**
+   * Stop tracking an evictable frame whose page was deleted, without remembering the page as evicted.
+   * @param frame_id the id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) { Pin(frame_id); }
+
+  /**
+   * Order frames from the hottest to the coldest, i.e. the reverse of the order the policy would victimize them in
+   * if they were all evictable. Policies that cannot rank frames keep the given order.
+   * @param[in,out] frame_ids the frames to order
+   */
+  virtual void RankByHotness(std::vector<frame_id_t> *frame_ids) {}
+
+  /**
+   * Change the number of frames the replacer may be required to store, when the buffer pool is resized. Frames at or
+   * beyond the new number must not be tracked anymore. Policies without per-frame state ignore it.
+   * @param num_frames the new maximum number of frames
+   */
+  virtual void SetNumFrames(size_t num_frames) {}
 };
 
+/**
+ * Create a replacer of the given policy. The caller owns the result.
+ * @param replacer_type the replacement policy
+ * @param num_frames the maximum number of frames the replacer will be required to store
+ * @param replacer_k the lookback constant k, used by LRU-K only
+ */
+auto MakeReplacer(ReplacerType replacer_type, size_t num_frames, size_t replacer_k) -> Replacer *;
+
 }  // namespace bustub
@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_q_replacer.h
+//
+// Identification: src/include/buffer/two_q_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/ghost_list.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * TwoQReplacer implements the full version of the 2Q policy (Johnson and Shasha, VLDB '94).
+ *
+ * Newly loaded pages enter A1in, a FIFO queue of about a quarter of the frames, and further accesses while they are
+ * in it do not promote them. Pages evicted from A1in are remembered in the ghost queue A1out (about half of the
+ * frames); a page read back while remembered there is hot and enters Am, which is managed as LRU. Pages touched once
+ * by a scan therefore never displace the pages in Am.
+ *
+ * Victim() skips non-evictable frames, so it is linear in the number of pinned frames at the cold end of a queue;
+ * all other operations are O(1).
+ */
+class TwoQReplacer : public Replacer {
+ public:
+  /**
+   * @brief Create a new TwoQReplacer.
+   * @param num_frames the maximum number of frames the TwoQReplacer will be required to store
+   */
+  explicit TwoQReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(TwoQReplacer);
+
+  ~TwoQReplacer() override = default;
+
+  /**
+   * @brief Evict the oldest evictable frame of A1in if A1in exceeds its share, the least recently used evictable frame
+   * of Am otherwise, falling back to the other queue if the chosen one has no evictable frame. Only pages evicted from
+   * A1in are remembered in A1out.
+   */
+  auto Victim(frame_id_t *frame_id) -> bool override;
+
+  void Pin(frame_id_t frame_id) override { SetEvictable(frame_id, false); }
+
+  void Unpin(frame_id_t frame_id) override { SetEvictable(frame_id, true); }
+
+  auto Size() -> size_t override;
+
+  /**
+   * @brief Record an access. A frame already holding the page moves to the most recently used end of Am if it is in
+   * Am, and stays in place if it is in A1in. Otherwise the frame starts tracking the page: in Am if the page is
+   * remembered in A1out, in A1in if it is new.
+   */
+  void RecordAccess(frame_id_t frame_id, page_id_t page_id) override;
+
+  /** Page classes are ignored. */
+  using Replacer::RecordAccess;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  auto IsTracked(frame_id_t frame_id) -> bool override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  /**
+   * @brief Change the number of frames, scaling the shares of A1in and A1out with it.
+   */
+  void SetNumFrames(size_t num_frames) override;
+
+ private:
+  enum class QueueId : uint8_t { NONE, A1IN, AM };
+
+  struct FrameEntry {
+    QueueId queue_{QueueId::NONE};
+    std::list<frame_id_t>::iterator pos_;
+    page_id_t page_id_{INVALID_PAGE_ID};
+    bool evictable_{false};
+  };
+
+  /** @brief Take a tracked frame out of its queue and stop tracking it. */
+  void Untrack(frame_id_t frame_id);
+
+  /** @brief Evict the first evictable frame of a queue, remembering its page in A1out if requested. */
+  auto EvictFrom(std::list<frame_id_t> *queue, bool remember, frame_id_t *frame_id) -> bool;
+
+  size_t num_frames_;
+  /** Share of the frames A1in may keep before it becomes the preferred victim queue. */
+  size_t a1in_size_;
+  /** Number of evicted pages A1out remembers. */
+  size_t a1out_size_;
+  size_t curr_size_{0};
+  std::mutex latch_;
+  std::vector<FrameEntry> frames_;
+  /** Frames of pages seen once, oldest first. */
+  std::list<frame_id_t> a1in_;
+  /** Frames of hot pages, least recently used first. */
+  std::list<frame_id_t> am_;
+  GhostList a1out_;
+};
+
+}  // namespace bustub
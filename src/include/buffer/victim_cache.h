@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// victim_cache.h
+//
+// Identification: src/include/buffer/victim_cache.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/** Counters of a VictimCache. */
+struct VictimCacheStats {
+  /** Misses of the buffer pool that consulted the cache. */
+  uint64_t lookups_{0};
+  /** Lookups that found the page, which is promoted back into the buffer pool and leaves the cache. */
+  uint64_t hits_{0};
+  /** Clean victims of the buffer pool that were stored in the cache. */
+  uint64_t demotions_{0};
+  /** Clean victims that were not stored because they did not compress. */
+  uint64_t rejections_{0};
+  /** Stored pages dropped to make room for newer ones. */
+  uint64_t evictions_{0};
+  /** Uncompressed and compressed size of the demoted pages. */
+  uint64_t logical_bytes_{0};
+  uint64_t compressed_bytes_{0};
+
+  auto operator+=(const VictimCacheStats &other) -> VictimCacheStats & {
+    lookups_ += other.lookups_;
+    hits_ += other.hits_;
+    demotions_ += other.demotions_;
+    rejections_ += other.rejections_;
+    evictions_ += other.evictions_;
+    logical_bytes_ += other.logical_bytes_;
+    compressed_bytes_ += other.compressed_bytes_;
+    return *this;
+  }
+
+  /** @return the fraction of the lookups that were served from the cache */
+  auto GetHitRatio() const -> double {
+    return lookups_ == 0 ? 0.0 : static_cast<double>(hits_) / static_cast<double>(lookups_);
+  }
+
+  /** @return the uncompressed size of the demoted pages divided by the memory they took */
+  auto GetCompressionRatio() const -> double {
+    return compressed_bytes_ == 0 ? 1.0 : static_cast<double>(logical_bytes_) / static_cast<double>(compressed_bytes_);
+  }
+};
+
+/**
+ * VictimCache is a second cache tier behind a buffer pool. It keeps clean pages the buffer pool evicted, compressed
+ * with LzCodec, within a fixed budget of memory, so that a later miss on one of them decompresses it instead of
+ * reading it from disk. For compressible pages, this multiplies the number of pages kept in memory.
+ *
+ * The cache is exclusive: a page is either in the buffer pool or in the cache, never in both. A lookup that hits
+ * removes the page from the cache, so a page the buffer pool modifies never leaves a stale copy behind. Pages that do
+ * not shrink are not stored. When the budget is exhausted, the least recently demoted pages are dropped first; they
+ * are clean, so dropping them loses nothing.
+ */
+class VictimCache {
+ public:
+  /**
+   * @brief Create a new victim cache.
+   * @param capacity_bytes the memory the compressed pages may take
+   */
+  explicit VictimCache(size_t capacity_bytes);
+
+  /**
+   * @brief Store a clean page evicted from the buffer pool, replacing any older copy of it.
+   * @param page_id id of the page
+   * @param page_data the page, BUSTUB_PAGE_SIZE bytes
+   * @return false if the page does not compress and was not stored
+   */
+  auto Insert(page_id_t page_id, const char *page_data) -> bool;
+
+  /**
+   * @brief Move a page out of the cache, on a miss of the buffer pool.
+   * @param page_id id of the page
+   * @param[out] page_data the frame to decompress the page into, BUSTUB_PAGE_SIZE bytes
+   * @return false if the page is not in the cache, true if it was decompressed into page_data and removed
+   */
+  auto Take(page_id_t page_id, char *page_data) -> bool;
+
+  /**
+   * @brief Drop a page, e.g. because it was deleted and its id may be handed out again.
+   * @param page_id id of the page
+   */
+  void Erase(page_id_t page_id);
+
+  /** @return the number of pages in the cache */
+  auto Size() -> size_t;
+
+  /** @return the memory the compressed pages take */
+  auto GetUsedBytes() -> size_t;
+
+  auto GetStats() -> VictimCacheStats;
+
+ private:
+  struct Entry {
+    page_id_t page_id_;
+    std::unique_ptr<char[]> data_;
+    size_t size_;
+  };
+
+  /** @brief Remove an entry and release its memory. Requires latch_. */
+  void RemoveEntry(std::list<Entry>::iterator it);
+
+  const size_t capacity_bytes_;
+  size_t used_bytes_{0};
+  /** The stored pages, most recently demoted first. */
+  std::list<Entry> entries_;
+  std::unordered_map<page_id_t, std::list<Entry>::iterator> index_;
+  VictimCacheStats stats_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -24,6 +24,7 @@
 
 #include "catalog/catalog.h"
 #include "common/config.h"
+#include "common/enums/statement_type.h"
 #include "common/util/string_util.h"
 #include "libfort/lib/fort.hpp"
 #include "type/value.h"
@@ -210,10 +211,41 @@ class BustubInstance {
    */
   auto MakeExecutorContext(Transaction *txn) -> std::unique_ptr<ExecutorContext>;
 
+  /**
+   * Create the buffer pool, sharded over `bpm_instances` instances of `bpm_size` frames each.
+   */
+  auto MakeBufferPoolManager(size_t bpm_size, size_t bpm_instances) -> BufferPoolManager *;
+
+  /**
+   * Whether a statement would modify the database, and is therefore rejected before it runs on a read-only one.
+   */
+  static auto IsModifyingStatement(StatementType type) -> bool;
+
+  /**
+   * Resize the buffer pool for `SET buffer_pool_size = N`. Throws if N is not a number of frames, or if pinned frames
+   * keep the pool from shrinking all the way to it.
+   */
+  void ResizeBufferPool(const std::string &value);
+
+  /** The sidecar file the hot pages are saved to on shutdown and warmed up from on startup; empty if in-memory. */
+  std::string hot_page_file_;
+
  public:
-  explicit BustubInstance(const std::string &db_file_name);
+  /**
+   * Create a BusTub instance backed by a database file. The buffer pool is warmed up in the background with the pages
+   * that were hot when the previous instance on the same file was destroyed.
+   * @param db_file_name the database file
+   * @param bpm_size number of frames in each buffer pool instance
+   * @param bpm_instances number of buffer pool instances; more than one selects a ParallelBufferPoolManager
+   */
+  explicit BustubInstance(const std::string &db_file_name, size_t bpm_size = 128, size_t bpm_instances = 1);
 
-  BustubInstance();
+  /**
+   * Create an in-memory BusTub instance.
+   * @param bpm_size number of frames in each buffer pool instance
+   * @param bpm_instances number of buffer pool instances; more than one selects a ParallelBufferPoolManager
+   */
+  explicit BustubInstance(size_t bpm_size = 128, size_t bpm_instances = 1);
 
   ~BustubInstance();
 
@@ -269,6 +301,9 @@ class BustubInstance {
  private:
   void CmdDisplayTables(ResultWriter &writer);
   void CmdDisplayIndices(ResultWriter &writer);
+  void CmdDisplayBufferPool(ResultWriter &writer);
+  /** Keep the pages of a table or index resident in the buffer pool for `\pin`, or release them for `\unpin`. */
+  void CmdSetResident(const std::string &name, bool resident, ResultWriter &writer);
   void CmdDisplayHelp(ResultWriter &writer);
   void WriteOneCell(const std::string &cell, ResultWriter &writer);
   std::unordered_map<std::string, std::string> session_variables_;
@@ -27,6 +27,46 @@ extern std::atomic<bool> enable_logging;
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/** Buffer pools created while this is true back the data of their frames with huge pages where available. */
+extern std::atomic<bool> buffer_pool_huge_pages;
+
+/** Database files opened while this is true store the pages of tables created WITH (compression) compressed. */
+extern std::atomic<bool> enable_page_compression;
+
+/** Database files opened while this is true are mapped read-only, and statements that would modify them are rejected. */
+extern std::atomic<bool> open_read_only;
+
+/** A running page cleaner checks the dirty frames of its buffer pool at least every PAGE_CLEANER_INTERVAL. */
+extern std::chrono::milliseconds page_cleaner_interval;
+
+/** A buffer pool that is being shrunk waits at most RESIZE_PIN_TIMEOUT for each pinned frame it has to retire. */
+extern std::chrono::milliseconds resize_pin_timeout;
+
+/**
+ * Buffer pools created while this is nonzero keep up to VICTIM_CACHE_SIZE bytes of compressed clean victims in a
+ * second cache tier, split evenly over the instances of a parallel buffer pool.
+ */
+extern std::atomic<size_t> victim_cache_size;
+
+/**
+ * Buffer pools created while this is true evict pages by class priority first (see PageClass), and only then by
+ * their replacement policy. Otherwise, the classes pages are tagged with are ignored. The priorities are strict, so a
+ * working set of index pages larger than the pool starves heap pages of frames; this is off by default.
+ */
+extern std::atomic<bool> page_class_priorities;
+
+/**
+ * While this is true, B+ tree inserts and removes first descend with read latches and write-latch only the leaf; they
+ * retry with write latches from the root only if the leaf has to split or merge.
+ */
+extern std::atomic<bool> b_plus_tree_optimistic_latching;
+
+/**
+ * While this is true, B+ tree point lookups read the nodes on their path without latching them and validate the
+ * versions of the pages instead; they fall back to read latches only after repeated conflicts with writers.
+ */
+extern std::atomic<bool> b_plus_tree_optimistic_reads;
+
 static constexpr int INVALID_PAGE_ID = -1;                                           // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                            // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                               // invalid log sequence number
@@ -36,6 +76,14 @@ static constexpr int BUFFER_POOL_SIZE = 10;
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr int READ_AHEAD_MIN_PAGES = 2;   // read-ahead window of a scan once it is detected as sequential
+static constexpr int READ_AHEAD_MAX_PAGES = 32;  // largest read-ahead window of a sequential scan
+static constexpr int BULK_READ_RING_SIZE = 16;   // frames a scan with a bulk-read access strategy may occupy
+static constexpr double BULK_READ_POOL_FRACTION = 0.25;  // scans estimated to read more of the pool use bulk reads
+static constexpr int DISK_IO_BATCH_SIZE = 16;   // page I/Os the page cleaner and the prefetcher submit at once
+static constexpr int DISK_URING_QUEUE_DEPTH = 128;  // submission queue entries of an io_uring disk manager
+static constexpr int DISK_SECTOR_SIZE = 512;        // allocation unit of the extents of compressed pages
+static constexpr double BULK_LOAD_FILL_FACTOR = 0.9;  // fraction of a B+ tree node a bulk load fills
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -44,6 +92,12 @@ using lsn_t = int32_t;         // log sequence number type
 using slot_offset_t = size_t;  // slot offset type
 using oid_t = uint16_t;
 
+/**
+ * What a page holds, as tagged by the code that fetches it (see Page::SetPageClass()). Replacers that honor classes
+ * evict the pages of a lower-priority class first.
+ */
+enum class PageClass : uint8_t { UNKNOWN, INDEX_INTERNAL, INDEX_LEAF, HEAP, TEMP, NUM_CLASSES };
+
 static constexpr int VARCHAR_DEFAULT_LENGTH = 128;  // default length for varchar when constructing the column
 
 }  // namespace bustub
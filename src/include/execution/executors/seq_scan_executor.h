@@ -12,8 +12,10 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
+#include "buffer/buffer_access_strategy.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/seq_scan_plan.h"
@@ -53,6 +55,9 @@ class SeqScanExecutor : public AbstractExecutor {
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
   TableHeap *table_heap_;
+  /** The ring of frames the scan reads through if the plan asks for a bulk read, nullptr otherwise. Must outlive
+   * iter_. */
+  std::unique_ptr<BufferAccessStrategy> strategy_;
   TableIterator iter_;
 };
 }  // namespace bustub
@@ -35,11 +35,12 @@ class SeqScanPlanNode : public AbstractPlanNode {
    * @param table_oid The identifier of table to be scanned
    */
   SeqScanPlanNode(SchemaRef output, table_oid_t table_oid, std::string table_name,
-                  AbstractExpressionRef filter_predicate = nullptr)
+                  AbstractExpressionRef filter_predicate = nullptr, bool bulk_read = false)
       : AbstractPlanNode(std::move(output), {}),
         table_oid_{table_oid},
         table_name_(std::move(table_name)),
-        filter_predicate_(std::move(filter_predicate)) {}
+        filter_predicate_(std::move(filter_predicate)),
+        bulk_read_(bulk_read) {}
 
   /** @return The type of the plan node */
   auto GetType() const -> PlanType override { return PlanType::SeqScan; }
@@ -62,12 +63,17 @@ class SeqScanPlanNode : public AbstractPlanNode {
   */
   AbstractExpressionRef filter_predicate_;
 
+  /** Whether the scan reads through a small ring of frames instead of the whole buffer pool. Set by the optimizer for
+   * scans of tables estimated to be large compared to the pool. */
+  bool bulk_read_;
+
  protected:
   auto PlanNodeToString() const -> std::string override {
     if (filter_predicate_) {
-      return fmt::format("SeqScan {{ table={}, filter={} }}", table_name_, filter_predicate_);
+      return fmt::format("SeqScan {{ table={}, filter={}{} }}", table_name_, filter_predicate_,
+                         bulk_read_ ? ", bulk_read" : "");
     }
-    return fmt::format("SeqScan {{ table={} }}", table_name_);
+    return fmt::format("SeqScan {{ table={}{} }}", table_name_, bulk_read_ ? ", bulk_read" : "");
   }
 };
 
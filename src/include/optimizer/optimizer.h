@@ -80,6 +80,12 @@ class Optimizer {
   /** @brief check if the predicate is true::boolean */
   auto IsPredicateTrue(const AbstractExpression &expr) -> bool;
 
+  /**
+   * @brief let seq scans of tables estimated to be large compared to the buffer pool read through a small ring of
+   * frames (a bulk-read access strategy), so that they don't evict the working set of other queries.
+   */
+  auto OptimizeSeqScanAsBulkRead(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
   /**
    * @brief optimize order by as index scan if there's an index on a table
    */
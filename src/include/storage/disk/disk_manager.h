@@ -17,14 +17,33 @@
 #include <future>  // NOLINT
 #include <mutex>   // NOLINT
 #include <string>
+#include <vector>
 
 #include "common/config.h"
+#include "storage/disk/free_page_map.h"
 
 namespace bustub {
 
+/**
+ * A page read or write submitted to DiskManager::SubmitRequests().
+ */
+struct DiskRequest {
+  /** Whether the request writes data_ to the page, or reads the page into data_. */
+  bool is_write_;
+  /** Page-sized buffer to write from or read into. It must stay valid until the request completes. */
+  char *data_;
+  /** The page to read or write. */
+  page_id_t page_id_;
+  /** Fulfilled with whether the I/O succeeded once the request completes. */
+  std::promise<bool> callback_;
+};
+
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
+ *
+ * Allocated pages are tracked in a FreePageMap, kept in a ".fsm" file next to the database file so that deallocated
+ * pages are reused across restarts. The map of an empty database file starts out empty.
  */
 class DiskManager {
  public:
@@ -42,7 +61,7 @@ class DiskManager {
   /**
    * Shut down the disk manager and close all the file resources.
    */
-  void ShutDown();
+  virtual void ShutDown();
 
   /**
    * Write a page to the database file.
@@ -58,6 +77,62 @@ class DiskManager {
    */
   virtual void ReadPage(page_id_t page_id, char *page_data);
 
+  /**
+   * Make all the pages written so far durable, along with the free page map. DiskManager flushes its stream after
+   * every write; implementations that buffer writes must override it.
+   */
+  virtual void Sync();
+
+  /**
+   * Submit a batch of page reads and writes. The requests complete in any order, each fulfilling its callback;
+   * requests on the same page must not be in flight at the same time. DiskManager performs them one by one before
+   * returning; asynchronous implementations hand the whole batch to the device at once.
+   * @param requests the requests to submit; their callbacks are moved out
+   */
+  virtual void SubmitRequests(std::vector<DiskRequest> *requests);
+
+  /**
+   * Allocate a page, reusing the lowest deallocated page id before growing the file.
+   * @param stride the number of shards the page ids are split over
+   * @param offset the shard to allocate from; the page id is congruent to it modulo stride
+   * @return the id of the allocated page
+   */
+  auto AllocatePage(uint32_t stride = 1, uint32_t offset = 0) -> page_id_t;
+
+  /**
+   * Return a page to the free page map, so that a later AllocatePage() reuses it. Deallocating a page that is not
+   * allocated has no effect.
+   * @param page_id id of the page
+   */
+  virtual void DeallocatePage(page_id_t page_id);
+
+  /** @return whether the page is allocated */
+  virtual auto IsPageAllocated(page_id_t page_id) -> bool;
+
+  /**
+   * Shrink the database file to its highest allocated page, releasing the free pages at its end to the file system.
+   * @return the number of pages the file shrank by
+   */
+  virtual auto Vacuum() -> size_t;
+
+  /**
+   * Opt a page in or out of compression. DiskManager stores every page as is and ignores it.
+   * @param page_id id of the page
+   * @param compressed whether the page should be compressed when it is written
+   */
+  virtual void SetPageCompressed(__attribute__((unused)) page_id_t page_id, __attribute__((unused)) bool compressed) {}
+
+  /** @return whether the database file is opened read-only, so that pages can be read but never written */
+  virtual auto IsReadOnly() -> bool { return false; }
+
+  /**
+   * Return the page as it is mapped into memory, so that it can be read without copying it. The memory must not be
+   * written to, and stays valid until ShutDown(). DiskManager maps no pages.
+   * @param page_id id of the page
+   * @return the mapped page, or nullptr if the page has to be read with ReadPage()
+   */
+  virtual auto MapPage(__attribute__((unused)) page_id_t page_id) -> const char * { return nullptr; }
+
   /**
    * Flush the entire log buffer into disk.
    * @param log_data raw log data
@@ -94,18 +169,33 @@ class DiskManager {
 
  protected:
   auto GetFileSize(const std::string &file_name) -> int;
+
+  /** @return the size of the database file in pages, rounded up */
+  virtual auto GetNumFilePages() -> size_t;
+
+  /**
+   * Truncate the database file. Called by Vacuum() with the free page map latched, so no page can be allocated in
+   * the truncated range meanwhile.
+   * @param num_pages the number of pages to keep
+   */
+  virtual void TruncateFile(size_t num_pages);
+
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
+  std::string fsm_name_;
   // stream to write db file
   std::fstream db_io_;
   std::string file_name_;
   int num_flushes_{0};
-  int num_writes_{0};
+  std::atomic<int> num_writes_{0};
   bool flush_log_{false};
   std::future<void> *flush_log_f_{nullptr};
   // With multiple buffer pool instances, need to protect file access
   std::mutex db_io_latch_;
+  // the allocated pages of the database file
+  FreePageMap free_page_map_;
+  std::mutex free_page_map_latch_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,186 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_compressed.h
+//
+// Identification: src/include/storage/disk/disk_manager_compressed.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>  // NOLINT
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager_posix.h"
+
+namespace bustub {
+
+/**
+ * Byte counts of the pages a DiskManagerCompressed wrote and read. Logical bytes count whole pages, physical bytes
+ * count the sectors that were transferred.
+ */
+struct CompressionStats {
+  uint64_t pages_written_{0};
+  /** The pages that were stored compressed; the others were opted out or did not shrink by a sector. */
+  uint64_t compressed_pages_written_{0};
+  uint64_t logical_bytes_written_{0};
+  uint64_t physical_bytes_written_{0};
+  uint64_t logical_bytes_read_{0};
+  uint64_t physical_bytes_read_{0};
+
+  /** @return the logical size of the pages written divided by the space they took on disk */
+  auto GetCompressionRatio() const -> double {
+    return physical_bytes_written_ == 0 ? 1.0
+                                        : static_cast<double>(logical_bytes_written_) / physical_bytes_written_;
+  }
+
+  /** @return the fraction of the read bandwidth that compression saved */
+  auto GetReadSavings() const -> double {
+    return logical_bytes_read_ == 0 ? 0.0
+                                    : 1.0 - static_cast<double>(physical_bytes_read_) / logical_bytes_read_;
+  }
+};
+
+/**
+ * DiskManagerCompressed stores the pages that are opted in to compression with LzCodec, so that reading them moves
+ * fewer bytes from disk. Pages are compressed in WritePage() and decompressed straight into the frame in ReadPage();
+ * the buffer pool above only ever sees whole pages.
+ *
+ * Compressed pages have variable sizes, so the database file is no longer an array of pages. It is divided into
+ * sectors of DISK_SECTOR_SIZE bytes, and every page occupies an extent of consecutive sectors. An indirection map,
+ * kept in a ".pmap" file next to the database file, records the extent of each page id. A page that does not shrink
+ * by at least one sector is stored uncompressed. A rewritten page keeps its extent if its size in sectors did not
+ * change; otherwise its old extent is freed and a best-fitting free extent is taken, or the file is extended.
+ * Adjacent free extents are merged, and Vacuum() returns free space at the end of the file to the file system.
+ *
+ * Pages are not opted in by default; see SetPageCompressed(). Direct I/O is not supported, as extents are not
+ * aligned to pages.
+ */
+class DiskManagerCompressed : public DiskManagerPosix {
+ public:
+  /**
+   * Creates a new disk manager that writes to the specified database file.
+   * @param db_file the file name of the database file to write to
+   */
+  explicit DiskManagerCompressed(const std::string &db_file);
+
+  ~DiskManagerCompressed() override;
+
+  /**
+   * Sync and close the database file and the indirection map, then close the log file.
+   */
+  void ShutDown() override;
+
+  /**
+   * Write a page to its extent, compressing it if it is opted in. The page is only guaranteed to be durable after
+   * the next Sync().
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /**
+   * Read a page from its extent, decompressing it if necessary. Pages that were never written read as zeroes.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /**
+   * Wait until all the pages written so far and the indirection map are durable.
+   */
+  void Sync() override;
+
+  /**
+   * Deallocate a page and free its extent.
+   * @param page_id id of the page
+   */
+  void DeallocatePage(page_id_t page_id) override;
+
+  /**
+   * Truncate the free extent at the end of the database file.
+   * @return the number of whole pages the file shrank by
+   */
+  auto Vacuum() -> size_t override;
+
+  /**
+   * Opt a page in or out of compression. It takes effect the next time the page is written.
+   * @param page_id id of the page
+   * @param compressed whether the page should be compressed when it is written
+   */
+  void SetPageCompressed(page_id_t page_id, bool compressed) override;
+
+  /** @return the bytes written and read so far */
+  auto GetCompressionStats() -> CompressionStats;
+
+  /** @return the size of the database file in bytes */
+  auto GetNumFileBytes() -> uint64_t;
+
+ private:
+  /** An entry of the indirection map, stored as is in the ".pmap" file. */
+  struct Extent {
+    /** The first sector of the page. */
+    uint32_t sector_;
+    /** The size of the stored page in bytes, or 0 if the page has no extent. */
+    uint16_t size_;
+    /** EXTENT_OPT_IN | EXTENT_COMPRESSED */
+    uint8_t flags_;
+    uint8_t unused_;
+  };
+  static_assert(sizeof(Extent) == 8, "map entries are persisted as is");
+
+  static constexpr uint8_t EXTENT_OPT_IN = 1;
+  static constexpr uint8_t EXTENT_COMPRESSED = 2;
+
+  /** @return the number of sectors an extent of the given size in bytes takes */
+  static auto NumSectors(size_t size) -> uint32_t {
+    return static_cast<uint32_t>((size + DISK_SECTOR_SIZE - 1) / DISK_SECTOR_SIZE);
+  }
+
+  /** @brief Read the indirection map and rebuild the free extents from the gaps between the pages. */
+  void LoadMap(bool reset);
+
+  /** @return the map entry of a page, growing the map if necessary. Requires map_latch_. */
+  auto GetExtent(page_id_t page_id) -> Extent &;
+
+  /** @brief Write one map entry through to the ".pmap" file. Requires map_latch_. */
+  void PersistExtent(page_id_t page_id);
+
+  /** @return the first sector of a free extent of the given size, taking it from the best fit or the file's end */
+  auto AllocateExtent(uint32_t num_sectors) -> uint32_t;
+
+  /** @brief Return an extent to the free extents, merging it with its free neighbours. Requires map_latch_. */
+  void FreeExtent(uint32_t sector, uint32_t num_sectors);
+
+  std::string map_name_;
+  /** File descriptor of the indirection map. */
+  int map_fd_{-1};
+  /** Protects the indirection map, the free extents and end_sector_. */
+  std::mutex map_latch_;
+  std::vector<Extent> extents_;
+  /** Free extents as first sector -> number of sectors, for merging neighbours. */
+  std::map<uint32_t, uint32_t> free_extents_;
+  /** Free extents as (number of sectors, first sector), for best-fit allocation. */
+  std::set<std::pair<uint32_t, uint32_t>> free_extents_by_size_;
+  /** One past the last sector that belongs to an extent or a free extent. */
+  uint32_t end_sector_{0};
+
+  std::atomic<uint64_t> pages_written_{0};
+  std::atomic<uint64_t> compressed_pages_written_{0};
+  std::atomic<uint64_t> physical_bytes_written_{0};
+  std::atomic<uint64_t> pages_read_{0};
+  std::atomic<uint64_t> physical_bytes_read_{0};
+};
+
+}  // namespace bustub
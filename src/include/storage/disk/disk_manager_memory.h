@@ -9,6 +9,7 @@
 // Copyright (c) 2015-2020, Carnegie Mellon University Database Group
 //
 //===----------------------------------------------------------------------===//
+#include <algorithm>
 #include <array>
 #include <cstring>
 #include <fstream>
@@ -106,6 +107,17 @@ class DiskManagerUnlimitedMemory : public DiskManager {
     memcpy(page_data, ptr->first.data(), BUSTUB_PAGE_SIZE);
   }
 
+ protected:
+  auto GetNumFilePages() -> size_t override {
+    std::unique_lock<std::mutex> l(mutex_);
+    return data_.size();
+  }
+
+  void TruncateFile(size_t num_pages) override {
+    std::unique_lock<std::mutex> l(mutex_);
+    data_.resize(std::min(num_pages, data_.size()));
+  }
+
  private:
   std::mutex mutex_;
   using Page = std::array<char, BUSTUB_PAGE_SIZE>;
@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_mmap.h
+//
+// Identification: src/include/storage/disk/disk_manager_mmap.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * DiskManagerMmap opens an existing database file read-only and maps it into memory, e.g. for an analytic replica
+ * that only scans a copy of the database.
+ *
+ * A buffer pool on top of it points its frames at the mapped pages instead of copying them (see MapPage()), so a miss
+ * costs a page fault at most. The mapping is PROT_READ: writing to a mapped page faults, and every operation that
+ * would change the file is rejected with an exception before it touches anything. The file is mapped as it is when
+ * the disk manager is created; pages beyond its end read as zeroes. No log or free page map files are opened.
+ */
+class DiskManagerMmap : public DiskManager {
+ public:
+  /**
+   * Creates a new disk manager that maps the specified database file.
+   * @param db_file the file name of the database file to map, which must exist
+   */
+  explicit DiskManagerMmap(const std::string &db_file);
+
+  ~DiskManagerMmap() override;
+
+  /**
+   * Unmap and close the database file.
+   */
+  void ShutDown() override;
+
+  /**
+   * Rejected: the database file is read-only.
+   */
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /**
+   * Copy a page out of the mapping. Pages beyond the end of the file read as zeroes.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /**
+   * Nothing is ever written, so there is nothing to sync.
+   */
+  void Sync() override {}
+
+  /**
+   * Rejected: the database file is read-only.
+   */
+  void DeallocatePage(page_id_t page_id) override;
+
+  /** @return whether the page is within the mapped file */
+  auto IsPageAllocated(page_id_t page_id) -> bool override;
+
+  /**
+   * Rejected: the database file is read-only.
+   */
+  auto Vacuum() -> size_t override;
+
+  auto IsReadOnly() -> bool override { return true; }
+
+  /**
+   * @param page_id id of the page
+   * @return the mapped page, or nullptr if the page is not entirely within the file
+   */
+  auto MapPage(page_id_t page_id) -> const char * override;
+
+  /** @return the number of whole pages in the mapped file */
+  auto GetNumPages() const -> size_t { return num_pages_; }
+
+ protected:
+  auto GetNumFilePages() -> size_t override;
+
+  void TruncateFile(size_t num_pages) override;
+
+ private:
+  /** File descriptor of the database file, or -1 once shut down. */
+  int fd_{-1};
+  /** The mapping of the database file, or nullptr if it is empty or shut down. */
+  char *data_{nullptr};
+  /** Size of the mapping in bytes. */
+  size_t size_{0};
+  /** Number of whole pages in the mapping. */
+  size_t num_pages_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_posix.h
+//
+// Identification: src/include/storage/disk/disk_manager_posix.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * DiskManagerPosix reads and writes pages with positional pread()/pwrite() calls on a plain file descriptor.
+ *
+ * Unlike DiskManager, which funnels every page through one latched std::fstream, it keeps no cursor and takes no
+ * latch, so concurrent misses on different pages reach the OS in parallel. Writes are not flushed one by one: the
+ * file size is cached instead of being stat()ed on every read, and Sync() is the explicit durability barrier.
+ * The log file is still handled by DiskManager.
+ *
+ * With direct I/O the file is opened with O_DIRECT, bypassing the kernel page cache so that pages are not cached
+ * twice. O_DIRECT needs BUSTUB_PAGE_SIZE-aligned buffers, which the frames of a buffer pool are; other buffers are
+ * copied through an aligned bounce buffer.
+ */
+class DiskManagerPosix : public DiskManager {
+ public:
+  /**
+   * Creates a new disk manager that writes to the specified database file.
+   * @param db_file the file name of the database file to write to
+   * @param direct_io whether to bypass the page cache with O_DIRECT; ignored if the file system does not support it
+   */
+  explicit DiskManagerPosix(const std::string &db_file, bool direct_io = false);
+
+  ~DiskManagerPosix() override;
+
+  /**
+   * Sync and close the database file, then close the log file.
+   */
+  void ShutDown() override;
+
+  /**
+   * Write a page to the database file. The page is only guaranteed to be durable after the next Sync().
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /**
+   * Read a page from the database file. Pages beyond the end of the file read as zeroes.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /**
+   * Wait until all the pages written so far are durable.
+   */
+  void Sync() override;
+
+  /** @return whether the database file is opened with O_DIRECT */
+  auto IsDirectIO() const -> bool { return direct_io_; }
+
+ protected:
+  /** @return whether a buffer cannot be used for I/O on the database file as it is */
+  auto NeedsBounce(const char *data) const -> bool {
+    return direct_io_ && reinterpret_cast<uintptr_t>(data) % BUSTUB_PAGE_SIZE != 0;
+  }
+
+  auto GetNumFilePages() -> size_t override;
+
+  void TruncateFile(size_t num_pages) override;
+
+  /** @brief Grow the cached file size to cover a page that was just written. */
+  void GrowFileSize(page_id_t page_id);
+
+  /** File descriptor of the database file, or -1 once shut down. */
+  int fd_{-1};
+
+ private:
+  bool direct_io_{false};
+  /** Size of the database file in bytes, maintained by WritePage(). */
+  std::atomic<int64_t> file_size_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_uring.h
+//
+// Identification: src/include/storage/disk/disk_manager_uring.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <mutex>               // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager_posix.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace bustub {
+
+/**
+ * DiskManagerUring submits batches of page I/O through an io_uring instance, set up with raw system calls.
+ *
+ * SubmitRequests() places a whole batch in the submission queue and enters the kernel once, so that the device sees
+ * the batch at full queue depth; a completion thread reaps the completion queue and fulfills the callbacks.
+ * ReadPage() and WritePage() keep the synchronous pread()/pwrite() path of DiskManagerPosix, which has the lowest
+ * latency for a single page. If the kernel does not support io_uring (or forbids it, or cannot time out a wait for
+ * completions), SubmitRequests() falls back to performing the requests synchronously, as it does once submitting to
+ * the ring failed.
+ */
+class DiskManagerUring : public DiskManagerPosix {
+ public:
+  /**
+   * Creates a new disk manager that writes to the specified database file.
+   * @param db_file the file name of the database file to write to
+   * @param queue_depth number of submission queue entries of the ring
+   * @param direct_io whether to bypass the page cache with O_DIRECT
+   */
+  explicit DiskManagerUring(const std::string &db_file, uint32_t queue_depth = DISK_URING_QUEUE_DEPTH,
+                            bool direct_io = false);
+
+  ~DiskManagerUring() override;
+
+  /**
+   * Wait for the requests in flight and tear down the ring, then shut down the database and log files.
+   */
+  void ShutDown() override;
+
+  /**
+   * Submit a batch of page requests to the ring, blocking only while the ring is full. With direct I/O, requests
+   * on unaligned buffers are performed synchronously instead.
+   * @param requests the requests to submit; their callbacks are moved out
+   */
+  void SubmitRequests(std::vector<DiskRequest> *requests) override;
+
+  /** @return whether requests go through io_uring, rather than the synchronous fallback */
+  auto IsAsync() const -> bool { return ring_fd_ >= 0 && !ring_failed_; }
+
+ private:
+  struct PendingRequest;
+
+  /**
+   * @brief Body of the completion thread: reap completions until the stop marker, or a failure of the ring, and all
+   * requests are reaped.
+   */
+  void CompletionLoop();
+
+  /** @brief Fill the next submission queue entry. Called with submit_latch_ held and a free entry available. */
+  void PrepareEntry(uint8_t opcode, PendingRequest *pending);
+
+  /**
+   * @brief Publish the prepared entries and enter the kernel until it has consumed all of them. On an error other
+   * than EINTR, EAGAIN or EBUSY, take back the entries it has not consumed and mark the ring as failed.
+   * @return the requests of the entries taken back, which the caller performs synchronously
+   */
+  auto SubmitPrepared(unsigned num_entries) -> std::vector<PendingRequest *>;
+
+  /** @brief Stop the completion thread and unmap the ring. */
+  void TearDownRing();
+
+  int ring_fd_{-1};
+  unsigned sq_entries_{0};
+  unsigned cq_entries_{0};
+
+  void *sq_ring_{nullptr};
+  size_t sq_ring_size_{0};
+  void *cq_ring_{nullptr};
+  size_t cq_ring_size_{0};
+  io_uring_sqe *sqes_{nullptr};
+  size_t sqes_size_{0};
+
+  unsigned *sq_tail_{nullptr};
+  unsigned *sq_mask_{nullptr};
+  unsigned *sq_array_{nullptr};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned *cq_mask_{nullptr};
+  io_uring_cqe *cqes_{nullptr};
+
+  /** Serializes submitters, and guards in_flight_. */
+  std::mutex submit_latch_;
+  /** Signalled (with submit_latch_) when completions free up room in the ring. */
+  std::condition_variable ring_cv_;
+  /** Submitted requests whose completion has not been reaped yet, including the stop marker. */
+  unsigned in_flight_{0};
+  /** Set once io_uring_enter failed to submit; from then on, requests take the synchronous path. */
+  std::atomic<bool> ring_failed_{false};
+  std::thread *completion_thread_{nullptr};
+};
+
+}  // namespace bustub
@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_page_map.h
+//
+// Identification: src/include/storage/disk/free_page_map.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * FreePageMap tracks which pages of a database file are in use, with one bit per page id that is set while the page
+ * is allocated. Allocation hands out the lowest free page id, so deleted pages are reused before the file grows.
+ *
+ * The map can be backed by a file, which holds the bitmap as is: bit i % 8 of byte i / 8 belongs to page i. A change
+ * only marks its 64-bit word of the bitmap dirty; Sync() writes the dirty words to the file and makes them durable,
+ * so that allocations do not wait for I/O. FreePageMap is not thread-safe; DiskManager serializes access to it.
+ */
+class FreePageMap {
+ public:
+  FreePageMap() = default;
+
+  DISALLOW_COPY_AND_MOVE(FreePageMap);
+
+  ~FreePageMap();
+
+  /**
+   * @brief Load the map from a file, creating the file if it does not exist.
+   * @param file_name the file backing the map
+   * @param reset whether to discard the allocations recorded in the file, e.g. because the database file is empty
+   */
+  void Open(const std::string &file_name, bool reset);
+
+  /** @brief Write the changed words of the map to the backing file and make them durable. */
+  void Sync();
+
+  /** @brief Write the changed words of the map and close the backing file. The map keeps working in memory. */
+  void Close();
+
+  /**
+   * @brief Allocate the lowest free page id that is congruent to offset modulo stride. Buffer pool instances that
+   * shard the page ids use their number of shards as the stride and their index as the offset.
+   * @return the allocated page id
+   */
+  auto Allocate(uint32_t stride, uint32_t offset) -> page_id_t;
+
+  /**
+   * @brief Return a page to the map.
+   * @return false if the page was not allocated
+   */
+  auto Deallocate(page_id_t page_id) -> bool;
+
+  /** @return whether the page is allocated */
+  auto IsAllocated(page_id_t page_id) const -> bool;
+
+  /** @return the number of allocated pages */
+  auto GetNumAllocated() const -> size_t { return num_allocated_; }
+
+  /** @return one past the highest allocated page id, i.e. the number of pages the database file needs */
+  auto GetAllocatedEnd() const -> page_id_t;
+
+ private:
+  /** @brief Mark the word of the bitmap that holds a byte as changed since the last write to the backing file. */
+  void MarkDirty(size_t byte);
+
+  /** @brief Write the dirty words to the backing file, coalescing adjacent ones into one write. */
+  void WriteDirtyWords();
+
+  std::vector<uint8_t> bits_;
+  size_t num_allocated_{0};
+  /** The stride of the last allocation; the search hints are only valid for it. */
+  uint32_t stride_{0};
+  /** Per offset, a page id below which every congruent page is allocated. */
+  std::vector<page_id_t> search_start_;
+  /** The words of bits_ changed since they were last written, by index. */
+  std::set<size_t> dirty_words_;
+  int fd_{-1};
+};
+
+}  // namespace bustub
@@ -0,0 +1,52 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lz_codec.h
+//
+// Identification: src/include/storage/disk/lz_codec.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+namespace bustub {
+
+/**
+ * LzCodec is a small LZ77 block codec in the style of LZ4, fast enough to compress pages on their way to disk.
+ *
+ * A block is a series of sequences. Each sequence starts with a token byte whose high nibble is the number of
+ * literals and whose low nibble is the match length minus four; a nibble of 15 is continued by bytes that are added
+ * to it until one is below 255. The literals follow, then the two-byte little-endian offset of the match. The last
+ * sequence has literals only. Matches are found through a hash table of four-byte prefixes, so compression takes one
+ * pass over the input and decompression is a plain copy loop.
+ */
+class LzCodec {
+ public:
+  /**
+   * @brief Compress a block.
+   * @param src the data to compress
+   * @param src_size the size of the data, at most 64 KB
+   * @param[out] dst the buffer to compress into
+   * @param dst_capacity the size of dst
+   * @return the size of the compressed block, or 0 if it does not fit into dst
+   */
+  static auto Compress(const char *src, size_t src_size, char *dst, size_t dst_capacity) -> size_t;
+
+  /**
+   * @brief Decompress a block produced by Compress(). Malformed blocks are rejected rather than read or written out
+   * of bounds.
+   * @param src the compressed block
+   * @param src_size the size of the compressed block
+   * @param[out] dst the buffer to decompress into
+   * @param dst_capacity the size of dst
+   * @return the size of the decompressed data, or 0 if the block is malformed or does not fit into dst
+   */
+  static auto Decompress(const char *src, size_t src_size, char *dst, size_t dst_capacity) -> size_t;
+};
+
+}  // namespace bustub
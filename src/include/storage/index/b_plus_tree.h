@@ -10,8 +10,10 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <atomic>
 #include <queue>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "concurrency/transaction.h"
@@ -42,6 +44,9 @@ class BPlusTree {
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
                      int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
 
+  // Deletes the pages of removed nodes that were still pinned when they were removed.
+  ~BPlusTree();
+
   // Returns true if this B+ tree has no keys and values.
   auto IsEmpty() const -> bool;
 
@@ -51,12 +56,18 @@ class BPlusTree {
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
+  // build an empty tree bottom-up from unsorted key/value pairs
+  auto BulkLoad(std::vector<std::pair<KeyType, ValueType>> pairs, double fill_factor = BULK_LOAD_FILL_FACTOR) -> bool;
+
   // return the value associated with a given key
   auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr) -> bool;
 
   // return the page id of the root node
   auto GetRootPageId() -> page_id_t;
 
+  // return the page ids of all the nodes, root first
+  auto GetPageIds() -> std::vector<page_id_t>;
+
   // index iterator
   auto Begin() -> INDEXITERATOR_TYPE;
   auto Begin(const KeyType &key) -> INDEXITERATOR_TYPE;
@@ -79,18 +90,37 @@ class BPlusTree {
 
   auto Split(BPlusTreePage *page) -> BPlusTreePage*;
   auto InsertToParent(BPlusTreePage *old_page, BPlusTreePage *split_page, const KeyType &split_key, std::queue<Page *>& locks) -> void;
-  void RedistributeOrMerge(BPlusTreePage *node, std::queue<Page *>& locks);
+  void RedistributeOrMerge(BPlusTreePage *node, std::queue<Page *>& locks, std::vector<page_id_t> &deleted_pages);
   template <typename Node>
   auto RedistributeLeft(Node *sibling_node, Node *target_node, InternalPage *parent, int index)->void;
    template <typename Node>
   auto RedistributeRight(Node *sibling_node, Node *target_node, InternalPage *parent, int index) -> void;
   template <typename Node>
-  auto Merge(Node *dst_node, Node *src_node, InternalPage *parent, int index, std::queue<Page *>& locks) -> void;
+  auto Merge(Node *dst_node, Node *src_node, InternalPage *parent, int index, std::queue<Page *>& locks,
+             std::vector<page_id_t> &deleted_pages) -> void;
   auto CheckEmpty() -> bool;
   
  private:
   void UpdateRootPageId(int insert_record = 0);
 
+  // fetch a node and tag its page with its page class
+  auto FetchNode(page_id_t page_id) -> Page *;
+
+  // delete the pages of removed nodes, and retry those that failed to delete before
+  void DeletePages(std::vector<page_id_t> page_ids);
+
+  // fetch and latch the root, retrying if it changes before it is latched
+  auto LatchRoot(bool exclusive) -> Page *;
+
+  // find the leaf of a key with read latches and write-latch only the leaf
+  auto FindLeafOptimistic(const KeyType &key) -> Page *;
+
+  // look a key up without latching, return false if a concurrent writer got in the way
+  auto TryGetValueOptimistic(const KeyType &key, ValueType *value, bool *found) -> bool;
+
+  // optimistic lookups that fail validation before a lookup takes read latches instead
+  static constexpr int OPTIMISTIC_READ_ATTEMPTS = 4;
+
   /* Debug Routines for FREE!! */
   void ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstream &out) const;
 
@@ -98,12 +128,17 @@ class BPlusTree {
 
   // member variable
   std::string index_name_;
-  page_id_t root_page_id_;
+  // Written under root_lock_, read without it by lookups.
+  std::atomic<page_id_t> root_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
   std::mutex root_lock_;
+  // Pages of removed nodes that were pinned by a reader when they were to be deleted.
+  std::vector<page_id_t> pending_deletes_;
+  std::atomic<size_t> num_pending_deletes_{0};
+  std::mutex pending_deletes_lock_;
 };
 
 }  // namespace bustub
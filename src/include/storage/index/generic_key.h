@@ -13,7 +13,10 @@
 #pragma once
 
 #include <cstring>
+#include <string>
+#include <type_traits>
 
+#include "common/exception.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -25,42 +28,70 @@ namespace bustub {
  * This key type uses an fixed length array to hold data for indexing
  * purposes, the actual size of which is specified and instantiated
  * with a template argument.
+ *
+ * The array holds the columns of the key in a normalized encoding, in
+ * which memcmp orders two keys the way their values compare:
+ * - integer types are stored big-endian with their sign bit flipped; their
+ *   null values are the type's minimum, so nulls sort first
+ * - timestamps are stored big-endian plus one, so that the null timestamp
+ *   (the maximum) wraps around to zero and sorts first as well
+ * - decimals are stored big-endian with their sign bit flipped, and all of
+ *   their bits flipped if they are negative; -0.0 is stored as 0.0
+ * - varchars are prefixed with 0 if null and 1 otherwise, followed by their
+ *   bytes in the binary collation VarlenType compares with, 0 bytes escaped
+ *   as 0 0xFF, and terminated by 0 0
+ * A key whose encoding does not fit into KeySize bytes is refused with an
+ * OUT_OF_RANGE exception, as a prefix of it would compare equal to other keys.
  */
 template <size_t KeySize>
 class GenericKey {
  public:
-  inline void SetFromKey(const Tuple &tuple) {
+  inline void SetFromKey(const Tuple &tuple, Schema *key_schema) {
     // intialize to 0
     memset(data_, 0, KeySize);
-    memcpy(data_, tuple.GetData(), tuple.GetLength());
+    size_t pos = 0;
+    for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+      pos = EncodeValue(tuple.GetValue(key_schema, i), pos);
+    }
   }
 
   // NOTE: for test purpose only
+  // encode the key of a one column bigint schema, or integer if a bigint does not fit
   inline void SetFromInteger(int64_t key) {
     memset(data_, 0, KeySize);
-    memcpy(data_, &key, sizeof(int64_t));
+    if constexpr (KeySize >= sizeof(int64_t)) {
+      EncodeInteger(key, 0);
+    } else {
+      EncodeInteger(static_cast<int32_t>(key), 0);
+    }
   }
 
   inline auto ToValue(Schema *schema, uint32_t column_idx) const -> Value {
-    const char *data_ptr;
-    const auto &col = schema->GetColumn(column_idx);
-    const TypeId column_type = col.GetType();
-    const bool is_inlined = col.IsInlined();
-    if (is_inlined) {
-      data_ptr = (data_ + col.GetOffset());
-    } else {
-      int32_t offset = *reinterpret_cast<int32_t *>(const_cast<char *>(data_ + col.GetOffset()));
-      data_ptr = (data_ + offset);
+    // the encoding is variable-length, so decode the columns in front of the requested one as well
+    size_t pos = 0;
+    Value value;
+    for (uint32_t i = 0; i <= column_idx; i++) {
+      pos = DecodeValue(schema->GetColumn(i).GetType(), pos, &value);
     }
-    return Value::DeserializeFrom(data_ptr, column_type);
+    return value;
   }
 
   // NOTE: for test purpose only
-  // interpret the first 8 bytes as int64_t from data vector
-  inline auto ToString() const -> int64_t { return *reinterpret_cast<int64_t *>(const_cast<char *>(data_)); }
+  // decode the key that SetFromInteger encoded
+  inline auto ToString() const -> int64_t {
+    if constexpr (KeySize >= sizeof(int64_t)) {
+      int64_t key;
+      DecodeInteger(0, &key);
+      return key;
+    } else {
+      int32_t key;
+      DecodeInteger(0, &key);
+      return key;
+    }
+  }
 
   // NOTE: for test purpose only
-  // interpret the first 8 bytes as int64_t from data vector
+  // print the key that SetFromInteger encoded
   friend auto operator<<(std::ostream &os, const GenericKey &key) -> std::ostream & {
     os << key.ToString();
     return os;
@@ -68,30 +99,177 @@ class GenericKey {
 
   // actual location of data, extends past the end.
   char data_[KeySize];
+
+ private:
+  /** Throw if size more bytes do not fit into the key at pos. */
+  inline void CheckFits(size_t pos, size_t size) const {
+    if (pos + size > KeySize) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "index key does not fit into " + std::to_string(KeySize) + " bytes");
+    }
+  }
+
+  /** Write the big-endian bytes of bits at pos and return the position after them. */
+  template <typename T>
+  inline auto PutBigEndian(T bits, size_t pos) -> size_t {
+    CheckFits(pos, sizeof(T));
+    for (size_t i = 0; i < sizeof(T); i++) {
+      data_[pos++] = static_cast<char>(bits >> (8 * (sizeof(T) - 1 - i)));
+    }
+    return pos;
+  }
+
+  /** Read big-endian bytes at pos and return the position after them. */
+  template <typename T>
+  inline auto GetBigEndian(size_t pos, T *bits) const -> size_t {
+    *bits = 0;
+    for (size_t i = 0; i < sizeof(T); i++, pos++) {
+      *bits = (*bits << 8) | static_cast<uint8_t>(data_[pos]);
+    }
+    return pos;
+  }
+
+  template <typename T>
+  inline auto EncodeInteger(T value, size_t pos) -> size_t {
+    using Bits = std::make_unsigned_t<T>;
+    return PutBigEndian(static_cast<Bits>(static_cast<Bits>(value) ^ (Bits{1} << (8 * sizeof(T) - 1))), pos);
+  }
+
+  template <typename T>
+  inline auto DecodeInteger(size_t pos, T *value) const -> size_t {
+    using Bits = std::make_unsigned_t<T>;
+    Bits bits;
+    pos = GetBigEndian(pos, &bits);
+    *value = static_cast<T>(static_cast<Bits>(bits ^ (Bits{1} << (8 * sizeof(T) - 1))));
+    return pos;
+  }
+
+  inline auto EncodeValue(const Value &value, size_t pos) -> size_t {
+    switch (value.GetTypeId()) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        return EncodeInteger(value.GetAs<int8_t>(), pos);
+      case TypeId::SMALLINT:
+        return EncodeInteger(value.GetAs<int16_t>(), pos);
+      case TypeId::INTEGER:
+        return EncodeInteger(value.GetAs<int32_t>(), pos);
+      case TypeId::BIGINT:
+        return EncodeInteger(value.GetAs<int64_t>(), pos);
+      case TypeId::TIMESTAMP:
+        return PutBigEndian(static_cast<uint64_t>(value.GetAs<uint64_t>() + 1), pos);
+      case TypeId::DECIMAL: {
+        auto decimal = value.GetAs<double>();
+        if (decimal == 0) {
+          // -0.0 equals 0.0, but has the sign bit set
+          decimal = 0;
+        }
+        uint64_t bits;
+        memcpy(&bits, &decimal, sizeof(bits));
+        return PutBigEndian((bits >> 63) != 0 ? ~bits : bits | (uint64_t{1} << 63), pos);
+      }
+      case TypeId::VARCHAR: {
+        CheckFits(pos, 1);
+        if (value.IsNull()) {
+          return pos + 1;
+        }
+        data_[pos++] = 1;
+        const char *str = value.GetData();
+        // the length of a varchar counts its terminating '\0'
+        for (uint32_t i = 0; i + 1 < value.GetLength(); i++) {
+          CheckFits(pos, str[i] == '\0' ? 2 : 1);
+          data_[pos++] = str[i];
+          if (str[i] == '\0') {
+            data_[pos++] = static_cast<char>(0xFF);
+          }
+        }
+        CheckFits(pos, 2);
+        return pos + 2;
+      }
+      default:
+        throw Exception(ExceptionType::INCOMPATIBLE_TYPE, "Invalid type for an index key column");
+    }
+  }
+
+  inline auto DecodeValue(TypeId type, size_t pos, Value *value) const -> size_t {
+    switch (type) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT: {
+        int8_t i;
+        pos = DecodeInteger(pos, &i);
+        *value = Value(type, i);
+        return pos;
+      }
+      case TypeId::SMALLINT: {
+        int16_t i;
+        pos = DecodeInteger(pos, &i);
+        *value = Value(type, i);
+        return pos;
+      }
+      case TypeId::INTEGER: {
+        int32_t i;
+        pos = DecodeInteger(pos, &i);
+        *value = Value(type, i);
+        return pos;
+      }
+      case TypeId::BIGINT: {
+        int64_t i;
+        pos = DecodeInteger(pos, &i);
+        *value = Value(type, i);
+        return pos;
+      }
+      case TypeId::TIMESTAMP: {
+        uint64_t bits;
+        pos = GetBigEndian(pos, &bits);
+        *value = Value(type, static_cast<uint64_t>(bits - 1));
+        return pos;
+      }
+      case TypeId::DECIMAL: {
+        uint64_t bits;
+        pos = GetBigEndian(pos, &bits);
+        bits = (bits >> 63) != 0 ? bits ^ (uint64_t{1} << 63) : ~bits;
+        double decimal;
+        memcpy(&decimal, &bits, sizeof(decimal));
+        *value = Value(type, decimal);
+        return pos;
+      }
+      case TypeId::VARCHAR: {
+        if (pos >= KeySize || data_[pos] == 0) {
+          *value = Value(type, nullptr, BUSTUB_VALUE_NULL, false);
+          return pos + 1;
+        }
+        std::string str;
+        for (pos++; pos < KeySize; pos++) {
+          if (data_[pos] == 0) {
+            if (pos + 1 >= KeySize || data_[pos + 1] == 0) {
+              break;
+            }
+            // an escaped 0 byte
+            pos++;
+            str.push_back('\0');
+          } else {
+            str.push_back(data_[pos]);
+          }
+        }
+        *value = Value(type, str);
+        return pos + 2;
+      }
+      default:
+        throw Exception(ExceptionType::INCOMPATIBLE_TYPE, "Invalid type for an index key column");
+    }
+  }
 };
 
 /**
  * Function object returns true if lhs < rhs, used for trees
+ *
+ * Both keys are normalized (see GenericKey), so one memcmp compares all of
+ * their columns.
  */
 template <size_t KeySize>
 class GenericComparator {
  public:
   inline auto operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const -> int {
-    uint32_t column_count = key_schema_->GetColumnCount();
-
-    for (uint32_t i = 0; i < column_count; i++) {
-      Value lhs_value = (lhs.ToValue(key_schema_, i));
-      Value rhs_value = (rhs.ToValue(key_schema_, i));
-
-      if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
-        return -1;
-      }
-      if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) {
-        return 1;
-      }
-    }
-    // equals
-    return 0;
+    int cmp = memcmp(lhs.data_, rhs.data_, KeySize);
+    return (cmp > 0) - (cmp < 0);
   }
 
   GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
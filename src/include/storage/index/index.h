@@ -175,6 +175,25 @@ class Index {
    */
   virtual void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) = 0;
 
+  /**
+   * Fill an empty index with many entries at once, e.g. when it is created over an existing table. The default
+   * implementation inserts the entries one by one.
+   * @param entries The index keys and their RIDs, in any order
+   * @param transaction The transaction context
+   */
+  virtual void BulkLoad(std::vector<std::pair<Tuple, RID>> entries, Transaction *transaction) {
+    for (const auto &[key, rid] : entries) {
+      InsertEntry(key, rid, transaction);
+    }
+  }
+
+  /**
+   * Collect the ids of the pages the index is stored in, e.g. to keep them resident in the buffer pool. The default
+   * implementation knows no pages.
+   * @return the page ids
+   */
+  virtual auto GetPageIds() -> std::vector<page_id_t> { return {}; }
+
  private:
   /** The Index structure owns its metadata */
   std::unique_ptr<IndexMetadata> metadata_;
@@ -14,6 +14,7 @@
  */
 #pragma once
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/read_ahead.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
@@ -48,6 +49,8 @@ class IndexIterator {
   BufferPoolManager *bpm_;
   LeafPage *leaf_;
   int index_;
+  /** Prefetches the leaves ahead of the scan. */
+  ReadAhead read_ahead_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search.h
+//
+// Identification: src/include/storage/page/b_plus_tree_key_search.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+/** The instruction sets the search over 4-byte keys can use, fastest first. */
+enum class KeySearchIsa : uint8_t { AVX2, SCALAR };
+
+/** @return the fastest instruction set the CPU supports, detected once */
+auto GetKeySearchIsa() -> KeySearchIsa;
+
+/**
+ * Find the lower bound of a 4-byte key among the sorted keys of a B+ tree page, i.e. the index of the first key that
+ * is not less than it, in the memcmp order of GenericComparator<4>.
+ *
+ * The keys are stride bytes apart, as in an array of key/value pairs. A binary search narrows them down to a few
+ * dozen, among which a loop then counts the keys less than the search key, without a branch per key and with AVX2
+ * gathers if the CPU supports them.
+ * @param keys the first key
+ * @param stride the distance between two keys in bytes; AVX2 is only used if it is a multiple of 4
+ * @param size the number of keys
+ * @param key the search key
+ * @param isa the instruction set to use, which the CPU must support; the default is the fastest one
+ */
+auto LowerBoundKey32(const char *keys, size_t stride, int size, const char *key,
+                     KeySearchIsa isa = GetKeySearchIsa()) -> int;
+
+/**
+ * @return the index of the first of the size key/value pairs at items whose key is not less than key. 4-byte
+ * GenericKeys, e.g. the keys of BPlusTreeIndexForOneIntegerColumn, are searched with LowerBoundKey32.
+ */
+template <typename Item, typename KeyType, typename KeyComparator>
+inline auto KeyLowerBound(const Item *items, int size, const KeyType &key, const KeyComparator &comparator) -> int {
+  if constexpr (std::is_same_v<KeyType, GenericKey<4>> && std::is_same_v<KeyComparator, GenericComparator<4>>) {
+    return LowerBoundKey32(items[0].first.data_, sizeof(Item), size, key.data_);
+  } else {
+    auto iter = std::lower_bound(items, items + size, key, [&comparator](const Item &item, const KeyType &key) {
+      return comparator(item.first, key) < 0;
+    });
+    return static_cast<int>(iter - items);
+  }
+}
+
+}  // namespace bustub
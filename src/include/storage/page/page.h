@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
 
@@ -30,11 +32,17 @@ class Page {
   friend class BufferPoolManagerInstance;
 
  public:
-  /** Constructor. Zeros out the page data. */
-  Page() { ResetMemory(); }
-
-  /** Default destructor. */
-  ~Page() = default;
+  /** Constructor. Allocates page data of its own, aligned to BUSTUB_PAGE_SIZE, and zeros it out. */
+  Page() : data_(static_cast<char *>(std::aligned_alloc(BUSTUB_PAGE_SIZE, BUSTUB_PAGE_SIZE))), owns_data_(true) {
+    ResetMemory();
+  }
+
+  /** Destructor. Frees the page data if the page owns it. */
+  ~Page() {
+    if (owns_data_) {
+      std::free(data_);
+    }
+  }
 
   /** @return the actual data contained within this page */
   inline auto GetData() -> char * { return data_; }
@@ -48,11 +56,40 @@ class Page {
   /** @return true if the page in memory has been modified from the page on disk, false otherwise */
   inline auto IsDirty() -> bool { return is_dirty_; }
 
-  /** Acquire the page write latch. */
-  inline void WLatch() { rwlatch_.WLock(); }
+  /** @return the class the page was last tagged with, UNKNOWN if it was not tagged since it was loaded */
+  inline auto GetPageClass() -> PageClass { return page_class_.load(std::memory_order_relaxed); }
+
+  /**
+   * Tag the page with what it holds. The buffer pool passes the class on to its replacer when the page is unpinned
+   * for the last time, so only call it while holding a pin.
+   */
+  inline void SetPageClass(PageClass page_class) { page_class_.store(page_class, std::memory_order_relaxed); }
+
+  /** Acquire the page write latch. The version of the page is odd until it is released, see ReadVersion(). */
+  inline void WLatch() {
+    rwlatch_.WLock();
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
 
   /** Release the page write latch. */
-  inline void WUnlatch() { rwlatch_.WUnlock(); }
+  inline void WUnlatch() {
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    rwlatch_.WUnlock();
+  }
+
+  /**
+   * Start an optimistic read, which takes no latch and so does not write to the page's shared state. Whatever is read
+   * from the page may be torn by a concurrent writer and must not be trusted until ValidateVersion() succeeds.
+   * @return the version of the page, odd while a writer holds the write latch
+   */
+  inline auto ReadVersion() -> uint64_t { return version_.load(std::memory_order_acquire); }
+
+  /** @return true if the page has not been write-latched since ReadVersion() returned version, an even number */
+  inline auto ValidateVersion(uint64_t version) -> bool {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return version % 2 == 0 && version_.load(std::memory_order_relaxed) == version;
+  }
 
   /** Acquire the page read latch. */
   inline void RLatch() { rwlatch_.RLock(); }
@@ -75,19 +112,31 @@ class Page {
   static constexpr size_t OFFSET_LSN = 4;
 
  private:
+  /**
+   * Constructor for the frames of a buffer pool, whose data lives in the pool's frame arena.
+   * @param data zeroed, page-sized data the page does not own
+   */
+  explicit Page(char *data) : data_(data), owns_data_(false) {}
+
   /** Zeroes out the data that is held within the page. */
   inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, BUSTUB_PAGE_SIZE); }
 
   /** The actual data that is stored within a page. */
-  char data_[BUSTUB_PAGE_SIZE]{};
-  /** The ID of this page. */
-  page_id_t page_id_ = INVALID_PAGE_ID;
-  /** The pin count of this page. */
-  int pin_count_ = 0;
+  char *data_;
+  /** Whether data_ was allocated by this page, rather than taken from a frame arena. */
+  bool owns_data_;
+  /** The ID of this page. Read without the buffer pool latch by the page-table hit path. */
+  std::atomic<page_id_t> page_id_ = INVALID_PAGE_ID;
+  /** The pin count of this page, or -1 while the buffer pool is recycling the frame for another page. */
+  std::atomic<int> pin_count_ = 0;
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
-  bool is_dirty_ = false;
+  std::atomic<bool> is_dirty_ = false;
+  /** The class the page was tagged with. Reset whenever the frame is recycled. */
+  std::atomic<PageClass> page_class_ = PageClass::UNKNOWN;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
+  /** Bumped when the write latch is acquired and when it is released, to validate optimistic reads. */
+  std::atomic<uint64_t> version_ = 0;
 };
 
 }  // namespace bustub
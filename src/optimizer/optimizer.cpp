@@ -14,10 +14,11 @@ auto Optimizer::Optimize(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef
     p = OptimizeNLJAsIndexJoin(p);
     p = OptimizeOrderByAsIndexScan(p);
     p = OptimizeSortLimitAsTopN(p);
+    p = OptimizeSeqScanAsBulkRead(p);
     return p;
   }
   // By default, use user-defined rules.
-  return OptimizeCustom(plan);
+  return OptimizeSeqScanAsBulkRead(OptimizeCustom(plan));
 }
 
 auto Optimizer::EstimatedCardinality(const std::string &table_name) -> std::optional<size_t> {
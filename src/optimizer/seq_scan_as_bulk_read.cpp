@@ -0,0 +1,35 @@
+#include <memory>
+#include <vector>
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+auto Optimizer::OptimizeSeqScanAsBulkRead(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeSeqScanAsBulkRead(child));
+  }
+
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() == PlanType::SeqScan) {
+    const auto &seq_scan_plan = dynamic_cast<const SeqScanPlanNode &>(*optimized_plan);
+    auto *bpm = catalog_.GetBufferPoolManager();
+    const auto cardinality = EstimatedCardinality(seq_scan_plan.table_name_);
+    if (bpm == nullptr || !cardinality.has_value() || seq_scan_plan.bulk_read_) {
+      return optimized_plan;
+    }
+    // Every tuple also takes an 8-byte slot in the header of its table page.
+    const size_t tuple_size = seq_scan_plan.OutputSchema().GetLength() + 8;
+    const size_t estimated_pages = (*cardinality * tuple_size + BUSTUB_PAGE_SIZE - 1) / BUSTUB_PAGE_SIZE;
+    if (static_cast<double>(estimated_pages) > BULK_READ_POOL_FRACTION * static_cast<double>(bpm->GetPoolSize())) {
+      return std::make_shared<SeqScanPlanNode>(seq_scan_plan.output_schema_, seq_scan_plan.table_oid_,
+                                               seq_scan_plan.table_name_, seq_scan_plan.filter_predicate_, true);
+    }
+  }
+
+  return optimized_plan;
+}
+
+}  // namespace bustub
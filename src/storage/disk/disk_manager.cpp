@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <sys/stat.h>
+#include <unistd.h>
 #include <cassert>
 #include <cstring>
 #include <iostream>
@@ -37,6 +38,7 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
     return;
   }
   log_name_ = file_name_.substr(0, n) + ".log";
+  fsm_name_ = file_name_.substr(0, n) + ".fsm";
 
   log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::app | std::ios::out);
   // directory or file does not exist
@@ -61,6 +63,9 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
     }
   }
   buffer_used = nullptr;
+
+  // Allocations recorded for a file that has no pages (anymore) are stale.
+  free_page_map_.Open(fsm_name_, GetFileSize(db_file) <= 0);
 }
 
 /**
@@ -72,6 +77,9 @@ void DiskManager::ShutDown() {
     db_io_.close();
   }
   log_io_.close();
+  std::scoped_lock scoped_free_page_map_latch(free_page_map_latch_);
+  free_page_map_.Sync();
+  free_page_map_.Close();
 }
 
 /**
@@ -122,6 +130,71 @@ void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
   }
 }
 
+/**
+ * Make the free page map durable; pages are flushed as they are written
+ */
+void DiskManager::Sync() {
+  std::scoped_lock scoped_free_page_map_latch(free_page_map_latch_);
+  free_page_map_.Sync();
+}
+
+/**
+ * Perform a batch of page requests synchronously, in order
+ */
+void DiskManager::SubmitRequests(std::vector<DiskRequest> *requests) {
+  for (auto &request : *requests) {
+    if (request.is_write_) {
+      WritePage(request.page_id_, request.data_);
+    } else {
+      ReadPage(request.page_id_, request.data_);
+    }
+    request.callback_.set_value(true);
+  }
+}
+
+auto DiskManager::AllocatePage(uint32_t stride, uint32_t offset) -> page_id_t {
+  std::scoped_lock scoped_free_page_map_latch(free_page_map_latch_);
+  return free_page_map_.Allocate(stride, offset);
+}
+
+void DiskManager::DeallocatePage(page_id_t page_id) {
+  std::scoped_lock scoped_free_page_map_latch(free_page_map_latch_);
+  free_page_map_.Deallocate(page_id);
+}
+
+auto DiskManager::IsPageAllocated(page_id_t page_id) -> bool {
+  std::scoped_lock scoped_free_page_map_latch(free_page_map_latch_);
+  return free_page_map_.IsAllocated(page_id);
+}
+
+/**
+ * Truncate the free pages at the end of the database file
+ */
+auto DiskManager::Vacuum() -> size_t {
+  std::scoped_lock scoped_free_page_map_latch(free_page_map_latch_);
+  const auto num_pages = static_cast<size_t>(free_page_map_.GetAllocatedEnd());
+  const auto num_file_pages = GetNumFilePages();
+  if (num_file_pages <= num_pages) {
+    return 0;
+  }
+  TruncateFile(num_pages);
+  return num_file_pages - num_pages;
+}
+
+auto DiskManager::GetNumFilePages() -> size_t {
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  const int file_size = GetFileSize(file_name_);
+  return file_size <= 0 ? 0 : (static_cast<size_t>(file_size) + BUSTUB_PAGE_SIZE - 1) / BUSTUB_PAGE_SIZE;
+}
+
+void DiskManager::TruncateFile(size_t num_pages) {
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  db_io_.flush();
+  if (truncate(file_name_.c_str(), static_cast<off_t>(num_pages * BUSTUB_PAGE_SIZE)) != 0) {
+    LOG_DEBUG("I/O error while truncating");
+  }
+}
+
 /**
  * Write the contents of the log into disk file
  * Only return when sync is done, and only perform sequence write
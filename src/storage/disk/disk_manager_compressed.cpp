@@ -0,0 +1,349 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_compressed.cpp
+//
+// Identification: src/storage/disk/disk_manager_compressed.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_compressed.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "storage/disk/lz_codec.h"
+
+namespace bustub {
+
+static constexpr auto PAGE_SIZE_BYTES = static_cast<size_t>(BUSTUB_PAGE_SIZE);
+static constexpr auto SECTOR_SIZE_BYTES = static_cast<size_t>(DISK_SECTOR_SIZE);
+
+/** @return this thread's buffer for compressed pages */
+static auto CompressionBuffer() -> char * {
+  static thread_local char compression_buffer[BUSTUB_PAGE_SIZE];
+  return compression_buffer;
+}
+
+DiskManagerCompressed::DiskManagerCompressed(const std::string &db_file) : DiskManagerPosix(db_file) {
+  std::string::size_type n = file_name_.rfind('.');
+  map_name_ = file_name_.substr(0, n) + ".pmap";
+  // Like the free page map, the extents recorded for a file that has no data (anymore) are stale.
+  LoadMap(DiskManagerPosix::GetNumFilePages() == 0);
+}
+
+DiskManagerCompressed::~DiskManagerCompressed() {
+  if (map_fd_ >= 0) {
+    close(map_fd_);
+  }
+}
+
+void DiskManagerCompressed::LoadMap(bool reset) {
+  map_fd_ = open(map_name_.c_str(), O_RDWR | O_CREAT | (reset ? O_TRUNC : 0), 0644);
+  if (map_fd_ < 0) {
+    throw Exception("can't open page map file");
+  }
+
+  struct stat stat_buf;
+  if (fstat(map_fd_, &stat_buf) == 0 && stat_buf.st_size > 0) {
+    extents_.resize(static_cast<size_t>(stat_buf.st_size) / sizeof(Extent));
+    auto *data = reinterpret_cast<char *>(extents_.data());
+    const size_t size = extents_.size() * sizeof(Extent);
+    size_t read_count = 0;
+    while (read_count < size) {
+      ssize_t rc = pread(map_fd_, data + read_count, size - read_count, read_count);
+      if (rc < 0 && errno == EINTR) {
+        continue;
+      }
+      if (rc <= 0) {
+        break;
+      }
+      read_count += rc;
+    }
+    extents_.resize(read_count / sizeof(Extent));
+  }
+
+  // The free extents are not persisted: they are the gaps between the extents of the pages.
+  std::vector<std::pair<uint32_t, uint32_t>> used;
+  for (const auto &extent : extents_) {
+    if (extent.size_ != 0) {
+      used.emplace_back(extent.sector_, NumSectors(extent.size_));
+    }
+  }
+  std::sort(used.begin(), used.end());
+  end_sector_ = 0;
+  for (const auto &[sector, num_sectors] : used) {
+    if (sector > end_sector_) {
+      FreeExtent(end_sector_, sector - end_sector_);
+    }
+    end_sector_ = std::max(end_sector_, sector + num_sectors);
+  }
+}
+
+void DiskManagerCompressed::ShutDown() {
+  DiskManagerPosix::ShutDown();
+  if (map_fd_ >= 0) {
+    close(map_fd_);
+    map_fd_ = -1;
+  }
+}
+
+void DiskManagerCompressed::WritePage(page_id_t page_id, const char *page_data) {
+  bool opt_in;
+  {
+    std::scoped_lock scoped_map_latch(map_latch_);
+    opt_in = (GetExtent(page_id).flags_ & EXTENT_OPT_IN) != 0;
+  }
+
+  // Compression happens outside the latch; it only pays off if it saves at least one sector.
+  const char *data = page_data;
+  size_t size = PAGE_SIZE_BYTES;
+  if (opt_in) {
+    char *buffer = CompressionBuffer();
+    const size_t compressed_size = LzCodec::Compress(page_data, PAGE_SIZE_BYTES, buffer,
+                                                     PAGE_SIZE_BYTES - SECTOR_SIZE_BYTES);
+    if (compressed_size > 0) {
+      memset(buffer + compressed_size, 0, NumSectors(compressed_size) * SECTOR_SIZE_BYTES - compressed_size);
+      data = buffer;
+      size = compressed_size;
+    }
+  }
+  const uint32_t num_sectors = NumSectors(size);
+
+  // A page that still takes as many sectors is overwritten in place. Otherwise the data goes to a new extent first,
+  // and the map only points at it, and frees the old extent, once the data is written: at no point does the map hold
+  // an extent that does not contain the page's data, or that another page may have been given.
+  uint32_t sector;
+  bool relocate;
+  {
+    std::scoped_lock scoped_map_latch(map_latch_);
+    Extent &extent = GetExtent(page_id);
+    relocate = NumSectors(extent.size_) != num_sectors;
+    sector = relocate ? AllocateExtent(num_sectors) : extent.sector_;
+  }
+
+  num_writes_ += 1;
+  const size_t num_bytes = num_sectors * SECTOR_SIZE_BYTES;
+  const auto offset = static_cast<off_t>(sector) * DISK_SECTOR_SIZE;
+  size_t written = 0;
+  while (written < num_bytes) {
+    ssize_t rc = pwrite(fd_, data + written, num_bytes - written, offset + written);
+    if (rc < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG_DEBUG("I/O error while writing");
+      if (relocate) {
+        std::scoped_lock scoped_map_latch(map_latch_);
+        FreeExtent(sector, num_sectors);
+      }
+      return;
+    }
+    written += rc;
+  }
+
+  {
+    // An extent overwritten in place may still have changed its size, or whether it is compressed.
+    std::scoped_lock scoped_map_latch(map_latch_);
+    Extent &extent = GetExtent(page_id);
+    const Extent old_extent = extent;
+    extent.sector_ = sector;
+    extent.size_ = static_cast<uint16_t>(size);
+    extent.flags_ = static_cast<uint8_t>((extent.flags_ & EXTENT_OPT_IN) |
+                                         (size < PAGE_SIZE_BYTES ? EXTENT_COMPRESSED : 0));
+    if (relocate || extent.size_ != old_extent.size_ || extent.flags_ != old_extent.flags_) {
+      PersistExtent(page_id);
+    }
+    if (relocate && old_extent.size_ != 0) {
+      FreeExtent(old_extent.sector_, NumSectors(old_extent.size_));
+    }
+  }
+  pages_written_ += 1;
+  compressed_pages_written_ += size < PAGE_SIZE_BYTES ? 1 : 0;
+  physical_bytes_written_ += num_bytes;
+}
+
+void DiskManagerCompressed::ReadPage(page_id_t page_id, char *page_data) {
+  Extent extent{};
+  {
+    std::scoped_lock scoped_map_latch(map_latch_);
+    if (static_cast<size_t>(page_id) < extents_.size()) {
+      extent = extents_[page_id];
+    }
+  }
+  if (extent.size_ == 0) {
+    memset(page_data, 0, BUSTUB_PAGE_SIZE);
+    return;
+  }
+
+  const bool compressed = (extent.flags_ & EXTENT_COMPRESSED) != 0;
+  char *data = compressed ? CompressionBuffer() : page_data;
+  const size_t num_bytes = NumSectors(extent.size_) * SECTOR_SIZE_BYTES;
+  const auto offset = static_cast<off_t>(extent.sector_) * DISK_SECTOR_SIZE;
+  size_t read_count = 0;
+  while (read_count < num_bytes) {
+    ssize_t rc = pread(fd_, data + read_count, num_bytes - read_count, offset + read_count);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      LOG_DEBUG("I/O error while reading");
+      break;
+    }
+    read_count += rc;
+  }
+  if (read_count < num_bytes) {
+    memset(data + read_count, 0, num_bytes - read_count);
+  }
+  pages_read_ += 1;
+  physical_bytes_read_ += num_bytes;
+
+  if (compressed && LzCodec::Decompress(data, extent.size_, page_data, PAGE_SIZE_BYTES) != PAGE_SIZE_BYTES) {
+    LOG_DEBUG("corrupt compressed page");
+    memset(page_data, 0, BUSTUB_PAGE_SIZE);
+  }
+}
+
+void DiskManagerCompressed::Sync() {
+  if (map_fd_ >= 0) {
+#ifdef __APPLE__
+    fsync(map_fd_);
+#else
+    fdatasync(map_fd_);
+#endif
+  }
+  DiskManagerPosix::Sync();
+}
+
+void DiskManagerCompressed::DeallocatePage(page_id_t page_id) {
+  DiskManager::DeallocatePage(page_id);
+  std::scoped_lock scoped_map_latch(map_latch_);
+  if (static_cast<size_t>(page_id) >= extents_.size()) {
+    return;
+  }
+  Extent &extent = extents_[page_id];
+  if (extent.size_ != 0) {
+    FreeExtent(extent.sector_, NumSectors(extent.size_));
+  }
+  // The page id may be reused by another table, which has to opt in itself.
+  extent = Extent{};
+  PersistExtent(page_id);
+}
+
+auto DiskManagerCompressed::Vacuum() -> size_t {
+  std::scoped_lock scoped_map_latch(map_latch_);
+  struct stat stat_buf;
+  if (fstat(fd_, &stat_buf) != 0) {
+    return 0;
+  }
+  const auto file_size = static_cast<uint64_t>(stat_buf.st_size);
+  const uint64_t end = static_cast<uint64_t>(end_sector_) * DISK_SECTOR_SIZE;
+  if (file_size <= end) {
+    return 0;
+  }
+  if (ftruncate(fd_, static_cast<off_t>(end)) != 0) {
+    LOG_DEBUG("I/O error while truncating");
+    return 0;
+  }
+  return (file_size - end) / PAGE_SIZE_BYTES;
+}
+
+void DiskManagerCompressed::SetPageCompressed(page_id_t page_id, bool compressed) {
+  std::scoped_lock scoped_map_latch(map_latch_);
+  Extent &extent = GetExtent(page_id);
+  const auto flags = static_cast<uint8_t>(compressed ? extent.flags_ | EXTENT_OPT_IN : extent.flags_ & ~EXTENT_OPT_IN);
+  if (flags != extent.flags_) {
+    extent.flags_ = flags;
+    PersistExtent(page_id);
+  }
+}
+
+auto DiskManagerCompressed::GetCompressionStats() -> CompressionStats {
+  CompressionStats stats;
+  stats.pages_written_ = pages_written_.load();
+  stats.compressed_pages_written_ = compressed_pages_written_.load();
+  stats.logical_bytes_written_ = stats.pages_written_ * PAGE_SIZE_BYTES;
+  stats.physical_bytes_written_ = physical_bytes_written_.load();
+  stats.logical_bytes_read_ = pages_read_.load() * PAGE_SIZE_BYTES;
+  stats.physical_bytes_read_ = physical_bytes_read_.load();
+  return stats;
+}
+
+auto DiskManagerCompressed::GetNumFileBytes() -> uint64_t {
+  struct stat stat_buf;
+  return fstat(fd_, &stat_buf) == 0 ? static_cast<uint64_t>(stat_buf.st_size) : 0;
+}
+
+auto DiskManagerCompressed::GetExtent(page_id_t page_id) -> Extent & {
+  if (static_cast<size_t>(page_id) >= extents_.size()) {
+    extents_.resize(static_cast<size_t>(page_id) + 1, Extent{});
+  }
+  return extents_[page_id];
+}
+
+void DiskManagerCompressed::PersistExtent(page_id_t page_id) {
+  if (map_fd_ < 0) {
+    return;
+  }
+  const auto offset = static_cast<off_t>(page_id) * static_cast<off_t>(sizeof(Extent));
+  ssize_t rc;
+  do {
+    rc = pwrite(map_fd_, &extents_[page_id], sizeof(Extent), offset);
+  } while (rc < 0 && errno == EINTR);
+  if (rc != static_cast<ssize_t>(sizeof(Extent))) {
+    LOG_DEBUG("I/O error while writing the page map");
+  }
+}
+
+auto DiskManagerCompressed::AllocateExtent(uint32_t num_sectors) -> uint32_t {
+  auto best_fit = free_extents_by_size_.lower_bound({num_sectors, 0});
+  if (best_fit == free_extents_by_size_.end()) {
+    const uint32_t sector = end_sector_;
+    end_sector_ += num_sectors;
+    return sector;
+  }
+  const auto [size, sector] = *best_fit;
+  free_extents_by_size_.erase(best_fit);
+  free_extents_.erase(sector);
+  if (size > num_sectors) {
+    free_extents_.emplace(sector + num_sectors, size - num_sectors);
+    free_extents_by_size_.emplace(size - num_sectors, sector + num_sectors);
+  }
+  return sector;
+}
+
+void DiskManagerCompressed::FreeExtent(uint32_t sector, uint32_t num_sectors) {
+  auto next = free_extents_.lower_bound(sector);
+  if (next != free_extents_.begin()) {
+    auto prev = std::prev(next);
+    if (prev->first + prev->second == sector) {
+      sector = prev->first;
+      num_sectors += prev->second;
+      free_extents_by_size_.erase({prev->second, prev->first});
+      free_extents_.erase(prev);
+    }
+  }
+  if (next != free_extents_.end() && sector + num_sectors == next->first) {
+    num_sectors += next->second;
+    free_extents_by_size_.erase({next->second, next->first});
+    free_extents_.erase(next);
+  }
+  if (sector + num_sectors == end_sector_) {
+    // Free space at the end of the file is handed out by extending the file again, and Vacuum() truncates it.
+    end_sector_ = sector;
+    return;
+  }
+  free_extents_.emplace(sector, num_sectors);
+  free_extents_by_size_.emplace(num_sectors, sector);
+}
+
+}  // namespace bustub
@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_mmap.cpp
+//
+// Identification: src/storage/disk/disk_manager_mmap.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_mmap.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+static constexpr auto PAGE_SIZE_BYTES = static_cast<size_t>(BUSTUB_PAGE_SIZE);
+
+DiskManagerMmap::DiskManagerMmap(const std::string &db_file) {
+  file_name_ = db_file;
+  fd_ = open(db_file.c_str(), O_RDONLY);
+  if (fd_ < 0) {
+    throw Exception("can't open db file");
+  }
+  struct stat stat_buf;
+  if (fstat(fd_, &stat_buf) != 0) {
+    close(fd_);
+    throw Exception("can't stat db file");
+  }
+  size_ = static_cast<size_t>(stat_buf.st_size);
+  num_pages_ = size_ / PAGE_SIZE_BYTES;
+  if (size_ == 0) {
+    return;
+  }
+  void *data = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+  if (data == MAP_FAILED) {
+    close(fd_);
+    throw Exception("can't map db file");
+  }
+  data_ = static_cast<char *>(data);
+}
+
+DiskManagerMmap::~DiskManagerMmap() { ShutDown(); }
+
+void DiskManagerMmap::ShutDown() {
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+    data_ = nullptr;
+  }
+  if (fd_ >= 0) {
+    close(fd_);
+    fd_ = -1;
+  }
+}
+
+void DiskManagerMmap::WritePage(page_id_t page_id, __attribute__((unused)) const char *page_data) {
+  throw Exception(fmt::format("can't write page {}: the database file is read-only", page_id));
+}
+
+void DiskManagerMmap::ReadPage(page_id_t page_id, char *page_data) {
+  const auto offset = static_cast<size_t>(page_id) * PAGE_SIZE_BYTES;
+  size_t read_count = 0;
+  if (data_ != nullptr && offset < size_) {
+    read_count = std::min(PAGE_SIZE_BYTES, size_ - offset);
+    memcpy(page_data, data_ + offset, read_count);
+  } else {
+    LOG_DEBUG("I/O error reading past end of file");
+  }
+  if (read_count < PAGE_SIZE_BYTES) {
+    memset(page_data + read_count, 0, PAGE_SIZE_BYTES - read_count);
+  }
+}
+
+void DiskManagerMmap::DeallocatePage(page_id_t page_id) {
+  throw Exception(fmt::format("can't deallocate page {}: the database file is read-only", page_id));
+}
+
+auto DiskManagerMmap::IsPageAllocated(page_id_t page_id) -> bool {
+  return page_id >= 0 && static_cast<size_t>(page_id) < GetNumFilePages();
+}
+
+auto DiskManagerMmap::Vacuum() -> size_t { throw Exception("can't vacuum: the database file is read-only"); }
+
+auto DiskManagerMmap::MapPage(page_id_t page_id) -> const char * {
+  if (data_ == nullptr || page_id < 0 || static_cast<size_t>(page_id) >= num_pages_) {
+    return nullptr;
+  }
+  return data_ + static_cast<size_t>(page_id) * PAGE_SIZE_BYTES;
+}
+
+auto DiskManagerMmap::GetNumFilePages() -> size_t { return (size_ + PAGE_SIZE_BYTES - 1) / PAGE_SIZE_BYTES; }
+
+void DiskManagerMmap::TruncateFile(__attribute__((unused)) size_t num_pages) {
+  throw Exception("can't truncate: the database file is read-only");
+}
+
+}  // namespace bustub
@@ -0,0 +1,161 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_posix.cpp
+//
+// Identification: src/storage/disk/disk_manager_posix.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_posix.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+static constexpr auto PAGE_SIZE_BYTES = static_cast<size_t>(BUSTUB_PAGE_SIZE);
+
+/** @return this thread's aligned buffer for O_DIRECT I/O on unaligned pages */
+static auto BounceBuffer() -> char * {
+  alignas(BUSTUB_PAGE_SIZE) static thread_local char bounce_buffer[BUSTUB_PAGE_SIZE];
+  return bounce_buffer;
+}
+
+DiskManagerPosix::DiskManagerPosix(const std::string &db_file, bool direct_io) : DiskManager(db_file) {
+  // DiskManager has created the file if it did not exist; pages go through the descriptor instead of its stream.
+  {
+    std::scoped_lock scoped_db_io_latch(db_io_latch_);
+    db_io_.close();
+  }
+#ifdef O_DIRECT
+  if (direct_io) {
+    fd_ = open(db_file.c_str(), O_RDWR | O_CREAT | O_DIRECT, 0644);
+    direct_io_ = fd_ >= 0;
+    if (fd_ < 0 && errno == EINVAL) {
+      LOG_DEBUG("the file system does not support O_DIRECT, falling back to buffered I/O");
+    }
+  }
+#endif
+  if (fd_ < 0) {
+    fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+  }
+  if (fd_ < 0) {
+    throw Exception("can't open db file");
+  }
+  struct stat stat_buf;
+  if (fstat(fd_, &stat_buf) == 0) {
+    file_size_ = static_cast<int64_t>(stat_buf.st_size);
+  }
+}
+
+DiskManagerPosix::~DiskManagerPosix() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+void DiskManagerPosix::ShutDown() {
+  if (fd_ >= 0) {
+    Sync();
+    close(fd_);
+    fd_ = -1;
+  }
+  DiskManager::ShutDown();
+}
+
+void DiskManagerPosix::WritePage(page_id_t page_id, const char *page_data) {
+  const auto offset = static_cast<off_t>(page_id) * BUSTUB_PAGE_SIZE;
+  if (NeedsBounce(page_data)) {
+    page_data = static_cast<const char *>(memcpy(BounceBuffer(), page_data, BUSTUB_PAGE_SIZE));
+  }
+  num_writes_ += 1;
+  size_t written = 0;
+  while (written < PAGE_SIZE_BYTES) {
+    ssize_t rc = pwrite(fd_, page_data + written, PAGE_SIZE_BYTES - written, offset + written);
+    if (rc < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG_DEBUG("I/O error while writing");
+      return;
+    }
+    written += rc;
+  }
+  GrowFileSize(page_id);
+}
+
+void DiskManagerPosix::GrowFileSize(page_id_t page_id) {
+  // Concurrent writers of later pages may have grown it further already.
+  const auto end = (static_cast<int64_t>(page_id) + 1) * BUSTUB_PAGE_SIZE;
+  auto file_size = file_size_.load();
+  while (file_size < end && !file_size_.compare_exchange_weak(file_size, end)) {
+  }
+}
+
+void DiskManagerPosix::ReadPage(page_id_t page_id, char *page_data) {
+  if (NeedsBounce(page_data)) {
+    ReadPage(page_id, BounceBuffer());
+    memcpy(page_data, BounceBuffer(), BUSTUB_PAGE_SIZE);
+    return;
+  }
+  const auto offset = static_cast<off_t>(page_id) * BUSTUB_PAGE_SIZE;
+  size_t read_count = 0;
+  if (offset < file_size_.load()) {
+    while (read_count < PAGE_SIZE_BYTES) {
+      ssize_t rc = pread(fd_, page_data + read_count, PAGE_SIZE_BYTES - read_count, offset + read_count);
+      if (rc < 0 && errno == EINTR) {
+        continue;
+      }
+      if (rc < 0) {
+        LOG_DEBUG("I/O error while reading");
+        return;
+      }
+      if (rc == 0) {
+        break;
+      }
+      read_count += rc;
+    }
+  } else {
+    LOG_DEBUG("I/O error reading past end of file");
+  }
+  if (read_count < PAGE_SIZE_BYTES) {
+    memset(page_data + read_count, 0, PAGE_SIZE_BYTES - read_count);
+  }
+}
+
+void DiskManagerPosix::Sync() {
+  if (fd_ < 0) {
+    return;
+  }
+#ifdef __APPLE__
+  fsync(fd_);
+#else
+  fdatasync(fd_);
+#endif
+  DiskManager::Sync();
+}
+
+auto DiskManagerPosix::GetNumFilePages() -> size_t {
+  return (static_cast<size_t>(file_size_.load()) + PAGE_SIZE_BYTES - 1) / PAGE_SIZE_BYTES;
+}
+
+void DiskManagerPosix::TruncateFile(size_t num_pages) {
+  const auto file_size = static_cast<int64_t>(num_pages * PAGE_SIZE_BYTES);
+  if (ftruncate(fd_, static_cast<off_t>(file_size)) != 0) {
+    LOG_DEBUG("I/O error while truncating");
+    return;
+  }
+  file_size_ = file_size;
+}
+
+}  // namespace bustub
@@ -0,0 +1,323 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_uring.cpp
+//
+// Identification: src/storage/disk/disk_manager_uring.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_uring.h"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "common/logger.h"
+
+namespace bustub {
+
+/** A request the kernel owns until its completion is reaped. */
+struct DiskManagerUring::PendingRequest {
+  bool is_write_;
+  page_id_t page_id_;
+  iovec iov_;
+  std::promise<bool> callback_;
+};
+
+namespace {
+
+/** user_data of the no-op that tells the completion thread to stop. */
+constexpr uint64_t STOP_MARKER = 0;
+
+/** How long the completion thread waits for a completion before it checks whether the ring failed. */
+constexpr int64_t COMPLETION_WAIT_NS = 100'000'000;
+
+auto IoUringSetup(unsigned entries, io_uring_params *params) -> int {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+auto IoUringEnter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags, void *arg = nullptr,
+                  size_t arg_size = 0) -> int {
+  return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, arg, arg_size));
+}
+
+template <typename T>
+auto RingField(void *ring, uint32_t offset) -> T * {
+  return reinterpret_cast<T *>(static_cast<char *>(ring) + offset);
+}
+
+}  // namespace
+
+DiskManagerUring::DiskManagerUring(const std::string &db_file, uint32_t queue_depth, bool direct_io)
+    : DiskManagerPosix(db_file, direct_io) {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring_fd_ = IoUringSetup(queue_depth, &params);
+  if (ring_fd_ < 0) {
+    LOG_DEBUG("io_uring is unavailable, falling back to synchronous I/O");
+    return;
+  }
+  // The completion thread must be able to wait with a timeout, see CompletionLoop().
+  if ((params.features & IORING_FEAT_EXT_ARG) == 0) {
+    LOG_DEBUG("io_uring cannot wait with a timeout, falling back to synchronous I/O");
+    close(ring_fd_);
+    ring_fd_ = -1;
+    return;
+  }
+  sq_entries_ = params.sq_entries;
+  cq_entries_ = params.cq_entries;
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                  IORING_OFF_SQ_RING);
+  cq_ring_ = single_mmap ? sq_ring_
+                         : mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                                IORING_OFF_CQ_RING);
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  void *sqes =
+      mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes == MAP_FAILED) {
+    LOG_DEBUG("cannot map the io_uring queues, falling back to synchronous I/O");
+    if (sq_ring_ != MAP_FAILED) {
+      munmap(sq_ring_, sq_ring_size_);
+    }
+    if (!single_mmap && cq_ring_ != MAP_FAILED) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sqes != MAP_FAILED) {
+      munmap(sqes, sqes_size_);
+    }
+    close(ring_fd_);
+    ring_fd_ = -1;
+    return;
+  }
+  sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+  sq_tail_ = RingField<unsigned>(sq_ring_, params.sq_off.tail);
+  sq_mask_ = RingField<unsigned>(sq_ring_, params.sq_off.ring_mask);
+  sq_array_ = RingField<unsigned>(sq_ring_, params.sq_off.array);
+  cq_head_ = RingField<unsigned>(cq_ring_, params.cq_off.head);
+  cq_tail_ = RingField<unsigned>(cq_ring_, params.cq_off.tail);
+  cq_mask_ = RingField<unsigned>(cq_ring_, params.cq_off.ring_mask);
+  cqes_ = RingField<io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+
+  completion_thread_ = new std::thread([this] { CompletionLoop(); });
+}
+
+DiskManagerUring::~DiskManagerUring() { TearDownRing(); }
+
+void DiskManagerUring::ShutDown() {
+  TearDownRing();
+  DiskManagerPosix::ShutDown();
+}
+
+void DiskManagerUring::SubmitRequests(std::vector<DiskRequest> *requests) {
+  if (ring_fd_ < 0) {
+    DiskManager::SubmitRequests(requests);
+    return;
+  }
+
+  auto perform_sync = [this](DiskRequest *request) {
+    if (request->is_write_) {
+      WritePage(request->page_id_, request->data_);
+    } else {
+      ReadPage(request->page_id_, request->data_);
+    }
+    request->callback_.set_value(true);
+  };
+
+  // The kernel rejects unaligned O_DIRECT buffers; the synchronous path bounces them.
+  std::vector<DiskRequest *> ring_requests;
+  ring_requests.reserve(requests->size());
+  for (auto &request : *requests) {
+    if (!NeedsBounce(request.data_)) {
+      ring_requests.push_back(&request);
+      continue;
+    }
+    perform_sync(&request);
+  }
+
+  std::unique_lock<std::mutex> lock(submit_latch_);
+  std::vector<PendingRequest *> taken_back;
+  size_t next = 0;
+  while (next < ring_requests.size() && !ring_failed_) {
+    // Never have more requests in flight than the completion queue can hold.
+    ring_cv_.wait(lock, [&] { return in_flight_ < std::min(sq_entries_, cq_entries_); });
+    const auto room = static_cast<size_t>(std::min(sq_entries_, cq_entries_) - in_flight_);
+    const auto num_entries = static_cast<unsigned>(std::min(room, ring_requests.size() - next));
+    for (unsigned i = 0; i < num_entries; i++, next++) {
+      auto &request = *ring_requests[next];
+      if (request.is_write_) {
+        num_writes_ += 1;
+      }
+      auto *pending = new PendingRequest{request.is_write_, request.page_id_,
+                                         iovec{request.data_, static_cast<size_t>(BUSTUB_PAGE_SIZE)},
+                                         std::move(request.callback_)};
+      PrepareEntry(request.is_write_ ? IORING_OP_WRITEV : IORING_OP_READV, pending);
+    }
+    in_flight_ += num_entries;
+    taken_back = SubmitPrepared(num_entries);
+  }
+  lock.unlock();
+
+  // Once the ring failed, the requests it did not take and the rest of the batch take the synchronous path.
+  for (auto *pending : taken_back) {
+    if (pending->is_write_) {
+      num_writes_ -= 1;
+      WritePage(pending->page_id_, static_cast<const char *>(pending->iov_.iov_base));
+    } else {
+      ReadPage(pending->page_id_, static_cast<char *>(pending->iov_.iov_base));
+    }
+    pending->callback_.set_value(true);
+    delete pending;
+  }
+  for (; next < ring_requests.size(); next++) {
+    perform_sync(ring_requests[next]);
+  }
+}
+
+void DiskManagerUring::PrepareEntry(uint8_t opcode, PendingRequest *pending) {
+  const unsigned tail = *sq_tail_;
+  const unsigned index = tail & *sq_mask_;
+  io_uring_sqe *sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = opcode;
+  if (pending != nullptr) {
+    sqe->fd = fd_;
+    sqe->addr = reinterpret_cast<uint64_t>(&pending->iov_);
+    sqe->len = 1;
+    sqe->off = static_cast<uint64_t>(pending->page_id_) * BUSTUB_PAGE_SIZE;
+    sqe->user_data = reinterpret_cast<uint64_t>(pending);
+  } else {
+    sqe->fd = -1;
+    sqe->user_data = STOP_MARKER;
+  }
+  sq_array_[index] = index;
+  // The kernel may only see the new tail once the entry is complete.
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+}
+
+auto DiskManagerUring::SubmitPrepared(unsigned num_entries) -> std::vector<PendingRequest *> {
+  std::vector<PendingRequest *> taken_back;
+  while (num_entries > 0) {
+    int rc = IoUringEnter(ring_fd_, num_entries, 0, 0);
+    if (rc >= 0) {
+      num_entries -= static_cast<unsigned>(rc);
+      continue;
+    }
+    if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+      continue;
+    }
+    LOG_DEBUG("io_uring_enter failed while submitting, falling back to synchronous I/O");
+    // Without SQPOLL the kernel only consumes entries inside io_uring_enter, which submitters call with
+    // submit_latch_ held, so the entries it has not consumed can be taken back from the tail.
+    const unsigned tail = *sq_tail_ - num_entries;
+    for (unsigned i = 0; i < num_entries; i++) {
+      const uint64_t user_data = sqes_[(tail + i) & *sq_mask_].user_data;
+      if (user_data != STOP_MARKER) {
+        taken_back.push_back(reinterpret_cast<PendingRequest *>(user_data));
+      }
+    }
+    __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+    in_flight_ -= num_entries;
+    ring_failed_ = true;
+    ring_cv_.notify_all();
+    break;
+  }
+  return taken_back;
+}
+
+void DiskManagerUring::CompletionLoop() {
+  // Nothing may ever complete once the ring failed, not even the stop marker, so the wait times out to check for it.
+  __kernel_timespec timeout{0, COMPLETION_WAIT_NS};
+  io_uring_getevents_arg arg;
+  memset(&arg, 0, sizeof(arg));
+  arg.ts = reinterpret_cast<uint64_t>(&timeout);
+  bool stopping = false;
+  while (true) {
+    if (IoUringEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg)) < 0 &&
+        errno != EINTR && errno != ETIME) {
+      LOG_DEBUG("io_uring_enter failed while waiting for completions");
+    }
+
+    unsigned head = *cq_head_;
+    const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    unsigned num_reaped = 0;
+    for (; head != tail; head++, num_reaped++) {
+      const io_uring_cqe &cqe = cqes_[head & *cq_mask_];
+      if (cqe.user_data == STOP_MARKER) {
+        stopping = true;
+        continue;
+      }
+      auto *pending = reinterpret_cast<PendingRequest *>(cqe.user_data);
+      bool success;
+      if (pending->is_write_) {
+        success = cqe.res == BUSTUB_PAGE_SIZE;
+        if (success) {
+          GrowFileSize(pending->page_id_);
+        }
+      } else {
+        // Like DiskManagerPosix, the part of a page beyond the end of the file reads as zeroes.
+        success = cqe.res >= 0;
+        if (success && cqe.res < BUSTUB_PAGE_SIZE) {
+          memset(static_cast<char *>(pending->iov_.iov_base) + cqe.res, 0, BUSTUB_PAGE_SIZE - cqe.res);
+        }
+      }
+      if (!success) {
+        LOG_DEBUG("I/O error in io_uring request");
+      }
+      pending->callback_.set_value(success);
+      delete pending;
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+
+    std::scoped_lock<std::mutex> lock(submit_latch_);
+    in_flight_ -= num_reaped;
+    ring_cv_.notify_all();
+    if ((stopping || ring_failed_) && in_flight_ == 0) {
+      return;
+    }
+  }
+}
+
+void DiskManagerUring::TearDownRing() {
+  if (ring_fd_ < 0) {
+    return;
+  }
+  {
+    std::unique_lock<std::mutex> lock(submit_latch_);
+    ring_cv_.wait(lock, [&] { return in_flight_ < std::min(sq_entries_, cq_entries_); });
+    PrepareEntry(IORING_OP_NOP, nullptr);
+    in_flight_++;
+    // If the ring failed, the stop marker is taken back, and the completion thread stops on its own once the
+    // requests in flight are reaped or, if there are none, its wait times out.
+    SubmitPrepared(1);
+  }
+  completion_thread_->join();
+  delete completion_thread_;
+  completion_thread_ = nullptr;
+
+  munmap(sqes_, sqes_size_);
+  if (cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  munmap(sq_ring_, sq_ring_size_);
+  close(ring_fd_);
+  ring_fd_ = -1;
+}
+
+}  // namespace bustub
@@ -0,0 +1,170 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_page_map.cpp
+//
+// Identification: src/storage/disk/free_page_map.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/free_page_map.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+namespace {
+
+/** The bytes of the bitmap that are marked dirty and written out together. */
+constexpr size_t WORD_SIZE = sizeof(uint64_t);
+
+}  // namespace
+
+FreePageMap::~FreePageMap() { Close(); }
+
+void FreePageMap::Open(const std::string &file_name, bool reset) {
+  Close();
+  fd_ = open(file_name.c_str(), O_RDWR | O_CREAT | (reset ? O_TRUNC : 0), 0644);
+  if (fd_ < 0) {
+    throw Exception("can't open free page map file");
+  }
+
+  bits_.clear();
+  struct stat stat_buf;
+  if (fstat(fd_, &stat_buf) == 0 && stat_buf.st_size > 0) {
+    bits_.resize(static_cast<size_t>(stat_buf.st_size));
+    size_t read_count = 0;
+    while (read_count < bits_.size()) {
+      ssize_t rc = pread(fd_, bits_.data() + read_count, bits_.size() - read_count, read_count);
+      if (rc < 0 && errno == EINTR) {
+        continue;
+      }
+      if (rc <= 0) {
+        break;
+      }
+      read_count += rc;
+    }
+    bits_.resize(read_count);
+  }
+  num_allocated_ = 0;
+  for (auto byte : bits_) {
+    num_allocated_ += __builtin_popcount(byte);
+  }
+  stride_ = 0;
+  search_start_.clear();
+  dirty_words_.clear();
+}
+
+void FreePageMap::Sync() {
+  WriteDirtyWords();
+  if (fd_ >= 0 && fsync(fd_) != 0) {
+    LOG_DEBUG("I/O error while syncing the free page map");
+  }
+}
+
+void FreePageMap::Close() {
+  if (fd_ >= 0) {
+    WriteDirtyWords();
+    close(fd_);
+    fd_ = -1;
+  }
+}
+
+auto FreePageMap::Allocate(uint32_t stride, uint32_t offset) -> page_id_t {
+  BUSTUB_ASSERT(stride > 0 && offset < stride, "offset must be below the stride");
+  if (stride != stride_) {
+    stride_ = stride;
+    search_start_.resize(stride);
+    for (uint32_t i = 0; i < stride; i++) {
+      search_start_[i] = static_cast<page_id_t>(i);
+    }
+  }
+
+  auto page_id = search_start_[offset];
+  while (IsAllocated(page_id)) {
+    page_id += static_cast<page_id_t>(stride);
+  }
+  const auto byte = static_cast<size_t>(page_id) / 8;
+  if (byte >= bits_.size()) {
+    bits_.resize(std::max(byte + 1, bits_.size() * 2));
+  }
+  bits_[byte] |= 1U << (page_id % 8);
+  num_allocated_ += 1;
+  search_start_[offset] = page_id + static_cast<page_id_t>(stride);
+  MarkDirty(byte);
+  return page_id;
+}
+
+auto FreePageMap::Deallocate(page_id_t page_id) -> bool {
+  if (page_id < 0 || !IsAllocated(page_id)) {
+    return false;
+  }
+  const auto byte = static_cast<size_t>(page_id) / 8;
+  bits_[byte] &= ~(1U << (page_id % 8));
+  num_allocated_ -= 1;
+  if (stride_ > 0) {
+    auto &search_start = search_start_[page_id % stride_];
+    search_start = std::min(search_start, page_id);
+  }
+  MarkDirty(byte);
+  return true;
+}
+
+auto FreePageMap::IsAllocated(page_id_t page_id) const -> bool {
+  const auto byte = static_cast<size_t>(page_id) / 8;
+  return page_id >= 0 && byte < bits_.size() && (bits_[byte] & (1U << (page_id % 8))) != 0;
+}
+
+auto FreePageMap::GetAllocatedEnd() const -> page_id_t {
+  for (size_t byte = bits_.size(); byte > 0; byte--) {
+    if (bits_[byte - 1] != 0) {
+      // The highest set bit of the last non-empty byte is the highest allocated page.
+      return static_cast<page_id_t>((byte - 1) * 8 + (32 - __builtin_clz(bits_[byte - 1])));
+    }
+  }
+  return 0;
+}
+
+void FreePageMap::MarkDirty(size_t byte) {
+  if (fd_ >= 0) {
+    dirty_words_.insert(byte / WORD_SIZE);
+  }
+}
+
+void FreePageMap::WriteDirtyWords() {
+  for (auto it = dirty_words_.begin(); it != dirty_words_.end();) {
+    // A run of consecutive dirty words is one write.
+    const size_t first_word = *it;
+    size_t end_word = first_word + 1;
+    for (++it; it != dirty_words_.end() && *it == end_word; ++it) {
+      end_word++;
+    }
+    const size_t begin = first_word * WORD_SIZE;
+    const size_t end = std::min(end_word * WORD_SIZE, bits_.size());
+    size_t written = 0;
+    while (begin + written < end) {
+      ssize_t rc = pwrite(fd_, &bits_[begin + written], end - begin - written, static_cast<off_t>(begin + written));
+      if (rc < 0 && errno == EINTR) {
+        continue;
+      }
+      if (rc <= 0) {
+        LOG_DEBUG("I/O error while writing the free page map");
+        break;
+      }
+      written += rc;
+    }
+  }
+  dirty_words_.clear();
+}
+
+}  // namespace bustub
@@ -0,0 +1,182 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lz_codec.cpp
+//
+// Identification: src/storage/disk/lz_codec.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/lz_codec.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace bustub {
+
+static constexpr size_t MIN_MATCH = 4;
+/** The last bytes of a block are always literals, so that a match never runs up to the end of the input. */
+static constexpr size_t LAST_LITERALS = 5;
+/** No match starts this close to the end of the input. */
+static constexpr size_t MATCH_FIND_LIMIT = 12;
+static constexpr size_t MAX_OFFSET = 65535;
+static constexpr size_t HASH_LOG = 12;
+static constexpr uint8_t NIBBLE_MAX = 15;
+
+static inline auto Read32(const uint8_t *p) -> uint32_t {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+static inline auto Hash(uint32_t sequence) -> uint32_t { return (sequence * 2654435761U) >> (32 - HASH_LOG); }
+
+/** @return the number of bytes needed to extend a length nibble of 15 by the rest of the length */
+static inline auto ExtensionSize(size_t length) -> size_t {
+  return length < NIBBLE_MAX ? 0 : (length - NIBBLE_MAX) / 255 + 1;
+}
+
+static inline void WriteExtension(size_t length, uint8_t **op) {
+  if (length < NIBBLE_MAX) {
+    return;
+  }
+  length -= NIBBLE_MAX;
+  while (length >= 255) {
+    *(*op)++ = 255;
+    length -= 255;
+  }
+  *(*op)++ = static_cast<uint8_t>(length);
+}
+
+/**
+ * Write a sequence of literals followed by a match, or by nothing if match_length is 0.
+ * @return false if the sequence does not fit before end
+ */
+static auto WriteSequence(const uint8_t *literals, size_t num_literals, size_t offset, size_t match_length,
+                          uint8_t **op, const uint8_t *end) -> bool {
+  size_t size = 1 + ExtensionSize(num_literals) + num_literals;
+  if (match_length > 0) {
+    size += 2 + ExtensionSize(match_length - MIN_MATCH);
+  }
+  if (size > static_cast<size_t>(end - *op)) {
+    return false;
+  }
+  auto literal_nibble = static_cast<uint8_t>(num_literals < NIBBLE_MAX ? num_literals : NIBBLE_MAX);
+  uint8_t match_nibble = 0;
+  if (match_length > 0) {
+    match_nibble = static_cast<uint8_t>(match_length - MIN_MATCH < NIBBLE_MAX ? match_length - MIN_MATCH : NIBBLE_MAX);
+  }
+  *(*op)++ = static_cast<uint8_t>(literal_nibble << 4 | match_nibble);
+  WriteExtension(num_literals, op);
+  memcpy(*op, literals, num_literals);
+  *op += num_literals;
+  if (match_length > 0) {
+    *(*op)++ = static_cast<uint8_t>(offset & 0xff);
+    *(*op)++ = static_cast<uint8_t>(offset >> 8);
+    WriteExtension(match_length - MIN_MATCH, op);
+  }
+  return true;
+}
+
+auto LzCodec::Compress(const char *src, size_t src_size, char *dst, size_t dst_capacity) -> size_t {
+  const auto *in = reinterpret_cast<const uint8_t *>(src);
+  auto *op = reinterpret_cast<uint8_t *>(dst);
+  const uint8_t *end = op + dst_capacity;
+
+  size_t anchor = 0;
+  if (src_size >= MATCH_FIND_LIMIT) {
+    // Positions are offsets into the block; a stale or empty slot is caught by comparing the bytes.
+    uint16_t table[1 << HASH_LOG] = {};
+    const size_t match_limit = src_size - LAST_LITERALS;
+    const size_t search_limit = src_size - MATCH_FIND_LIMIT;
+    size_t pos = 0;
+    while (pos <= search_limit) {
+      const uint32_t sequence = Read32(in + pos);
+      const uint32_t hash = Hash(sequence);
+      size_t candidate = table[hash];
+      table[hash] = static_cast<uint16_t>(pos);
+      if (candidate >= pos || pos - candidate > MAX_OFFSET || Read32(in + candidate) != sequence) {
+        // Skip ahead faster the longer nothing matched, so that incompressible pages are given up on quickly.
+        pos += 1 + ((pos - anchor) >> 6);
+        continue;
+      }
+      while (pos > anchor && candidate > 0 && in[pos - 1] == in[candidate - 1]) {
+        pos--;
+        candidate--;
+      }
+      size_t match_length = MIN_MATCH;
+      while (pos + match_length < match_limit && in[pos + match_length] == in[candidate + match_length]) {
+        match_length++;
+      }
+      if (!WriteSequence(in + anchor, pos - anchor, pos - candidate, match_length, &op, end)) {
+        return 0;
+      }
+      pos += match_length;
+      anchor = pos;
+    }
+  }
+  if (!WriteSequence(in + anchor, src_size - anchor, 0, 0, &op, end)) {
+    return 0;
+  }
+  return static_cast<size_t>(op - reinterpret_cast<uint8_t *>(dst));
+}
+
+/** @return false if the block ends in the middle of the extension */
+static inline auto ReadExtension(const uint8_t *in, size_t size, size_t *ip, size_t *length) -> bool {
+  uint8_t byte;
+  do {
+    if (*ip >= size) {
+      return false;
+    }
+    byte = in[(*ip)++];
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+auto LzCodec::Decompress(const char *src, size_t src_size, char *dst, size_t dst_capacity) -> size_t {
+  const auto *in = reinterpret_cast<const uint8_t *>(src);
+  auto *out = reinterpret_cast<uint8_t *>(dst);
+  size_t ip = 0;
+  size_t op = 0;
+  while (ip < src_size) {
+    const uint8_t token = in[ip++];
+    size_t num_literals = token >> 4;
+    if (num_literals == NIBBLE_MAX && !ReadExtension(in, src_size, &ip, &num_literals)) {
+      return 0;
+    }
+    if (num_literals > src_size - ip || num_literals > dst_capacity - op) {
+      return 0;
+    }
+    memcpy(out + op, in + ip, num_literals);
+    ip += num_literals;
+    op += num_literals;
+    if (ip == src_size) {
+      break;
+    }
+
+    if (src_size - ip < 2) {
+      return 0;
+    }
+    const size_t offset = in[ip] | static_cast<size_t>(in[ip + 1]) << 8;
+    ip += 2;
+    size_t match_length = token & NIBBLE_MAX;
+    if (match_length == NIBBLE_MAX && !ReadExtension(in, src_size, &ip, &match_length)) {
+      return 0;
+    }
+    match_length += MIN_MATCH;
+    if (offset == 0 || offset > op || match_length > dst_capacity - op) {
+      return 0;
+    }
+    // The match may overlap the bytes it produces, which repeats them; copy byte by byte.
+    for (size_t i = 0; i < match_length; i++, op++) {
+      out[op] = out[op - offset];
+    }
+  }
+  return op;
+}
+
+}  // namespace bustub
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstddef>
 #include <mutex>
 #include <queue>
@@ -28,6 +29,13 @@ BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manag
       leaf_max_size_(leaf_max_size),
       internal_max_size_(internal_max_size) {}
 
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TYPE::~BPlusTree() {
+  if (!pending_deletes_.empty()) {
+    DeletePages({});
+  }
+}
+
 /*
  * Helper function to decide whether current b+tree is empty
  */
@@ -50,8 +58,18 @@ auto BPLUSTREE_TYPE::IsEmpty() const -> bool {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) -> bool {
-  
-  std::cout << "Get value, key: " << key << std::endl;
+  if (b_plus_tree_optimistic_reads.load(std::memory_order_relaxed)) {
+    for (int attempt = 0; attempt < OPTIMISTIC_READ_ATTEMPTS; attempt++) {
+      ValueType value;
+      bool found;
+      if (TryGetValueOptimistic(key, &value, &found)) {
+        if (found) {
+          result->push_back(value);
+        }
+        return found;
+      }
+    }
+  }
   std::queue<Page *> locks;
   Page *page = FindLeaf(key, 1,locks);
   page->RUnlatch();
@@ -65,6 +83,78 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
   return is_exist;
 }
 
+/*
+ * Look a key up with optimistic lock coupling: every node on the path is read
+ * without latching it and then validated against the version of its page. A
+ * child is only fetched once its parent validates, so the page id it is
+ * fetched by is never torn, and the parent is validated again after the
+ * child's version is read, so the child was still its child by then. Writers
+ * keep the size of a node within its bounds, so a node that is being changed
+ * yields garbage rather than a read beyond its page, and the garbage is
+ * discarded by the validation.
+ * @return : false if a concurrent writer changed a node on the path and the
+ * lookup has to be retried
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::TryGetValueOptimistic(const KeyType &key, ValueType *value, bool *found) -> bool {
+  page_id_t page_id = GetRootPageId();
+  if (page_id == INVALID_PAGE_ID) {
+    *found = false;
+    return true;
+  }
+  Page *page = FetchNode(page_id);
+  if (page == nullptr) {
+    return false;
+  }
+  uint64_t version = page->ReadVersion();
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  // A split or a merge of the root may have replaced it before it was fetched.
+  bool valid = node->IsRootPage() && node->GetPageId() == page_id;
+  while (valid && !node->IsLeafPage()) {
+    page_id_t child_id = reinterpret_cast<InternalPage *>(node)->Lookup(key, comparator_);
+    if (!page->ValidateVersion(version)) {
+      valid = false;
+      break;
+    }
+    Page *child = FetchNode(child_id);
+    if (child == nullptr) {
+      valid = false;
+      break;
+    }
+    uint64_t child_version = child->ReadVersion();
+    valid = page->ValidateVersion(version);
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page = child;
+    page_id = child_id;
+    version = child_version;
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  }
+  if (valid) {
+    *found = reinterpret_cast<LeafPage *>(node)->Lookup(key, value, comparator_);
+    valid = page->ValidateVersion(version);
+  }
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return valid;
+}
+
+/*
+ * Fetch a node of the tree and tag its page as an internal or a leaf page, so
+ * that the buffer pool favors the nodes every lookup goes through.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchNode(page_id_t page_id) -> Page * {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page != nullptr) {
+    // Only store a class that changed, so that lookups do not write to the shared state of the upper levels.
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    auto page_class = node->IsLeafPage() ? PageClass::INDEX_LEAF : PageClass::INDEX_INTERNAL;
+    if (page->GetPageClass() != page_class) {
+      page->SetPageClass(page_class);
+    }
+  }
+  return page;
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -78,17 +168,23 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::InsertToParent(BPlusTreePage *old_page, BPlusTreePage *split_page, const KeyType &split_key, std::queue<Page *>& locks) -> void{
 if (old_page->IsRootPage()) {
-    Page *page = buffer_pool_manager_->NewPage(&root_page_id_);
+    // Publish the new root only once it is complete, readers do not wait for its latch.
+    page_id_t new_root_id;
+    Page *page = buffer_pool_manager_->NewPage(&new_root_id);
+    page->SetPageClass(PageClass::INDEX_INTERNAL);
     auto *root = reinterpret_cast<InternalPage *>(page->GetData());
-    root->Init(root_page_id_, INVALID_PAGE_ID, internal_max_size_);
+    root->Init(new_root_id, INVALID_PAGE_ID, internal_max_size_);
 
     root->SetKeyAt(1, split_key);
     root->SetValueAt(0, old_page->GetPageId());
     root->SetValueAt(1, split_page->GetPageId());
     root->SetSize(2);
 
-    old_page->SetParentPageId(root_page_id_);
-    split_page->SetParentPageId(root_page_id_);
+    old_page->SetParentPageId(new_root_id);
+    split_page->SetParentPageId(new_root_id);
+    root_lock_.lock();
+    root_page_id_.store(new_root_id, std::memory_order_release);
+    root_lock_.unlock();
     UpdateRootPageId(0);
 
 
@@ -98,14 +194,14 @@ if (old_page->IsRootPage()) {
       buffer_pool_manager_->UnpinPage(locks.front()->GetPageId(), true);
       locks.pop();
     }
-
-    // buffer_pool_manager_->UnpinPage(root_page_id_, true);
+    // A pinned root could never be deleted once the tree shrinks back below it.
+    buffer_pool_manager_->UnpinPage(new_root_id, true);
     return;
   }
 
   // Insert the split page into parent page directly when parent page is not full.
   int parent_id = old_page->GetParentPageId();
-  Page *root_page = buffer_pool_manager_->FetchPage(parent_id);
+  Page *root_page = FetchNode(parent_id);
   auto *root = reinterpret_cast<InternalPage *>(root_page->GetData());
   if (root->GetSize() < internal_max_size_) {
     root->InsertNodeAfter(split_page->GetPageId(), split_key, old_page->GetPageId());
@@ -131,8 +227,7 @@ INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::FindLeaf(const KeyType &key, int mode, std::queue<Page *>& locks) -> Page*{
   
   if(mode == search_mode){
-    Page *page = buffer_pool_manager_->FetchPage(GetRootPageId());
-    page->RLatch();
+    Page *page = LatchRoot(false);
     locks.push(page);
     auto *tree_page = reinterpret_cast<BPlusTreePage *>(page->GetData());
     
@@ -141,7 +236,7 @@ auto BPLUSTREE_TYPE::FindLeaf(const KeyType &key, int mode, std::queue<Page *>&
     while(!tree_page->IsLeafPage()){
       auto *internal_page = reinterpret_cast<InternalPage *>(tree_page);
       auto page_id = internal_page->Lookup(key, comparator_);
-      page = buffer_pool_manager_->FetchPage(page_id);
+      page = FetchNode(page_id);
       tree_page = reinterpret_cast<BPlusTreePage *>(page->GetData());
       page->RLatch();
       locks.push(page);
@@ -152,8 +247,7 @@ auto BPLUSTREE_TYPE::FindLeaf(const KeyType &key, int mode, std::queue<Page *>&
     return page;
   }
   if(mode == insert_mode){
-    Page *page = buffer_pool_manager_->FetchPage(GetRootPageId());
-    page->WLatch();
+    Page *page = LatchRoot(true);
     locks.push(page);
     auto *tree_page = reinterpret_cast<BPlusTreePage *>(page->GetData());
     
@@ -162,7 +256,7 @@ auto BPLUSTREE_TYPE::FindLeaf(const KeyType &key, int mode, std::queue<Page *>&
     while(!tree_page->IsLeafPage()){
       auto *internal_page = reinterpret_cast<InternalPage *>(tree_page);
       auto page_id = internal_page->Lookup(key, comparator_);
-      page = buffer_pool_manager_->FetchPage(page_id);
+      page = FetchNode(page_id);
       tree_page = reinterpret_cast<BPlusTreePage *>(page->GetData());
       page->WLatch();
       
@@ -179,15 +273,14 @@ auto BPLUSTREE_TYPE::FindLeaf(const KeyType &key, int mode, std::queue<Page *>&
     return page;
   }
   //Delete mode
-  Page *page = buffer_pool_manager_->FetchPage(GetRootPageId());
-  page->WLatch();
+  Page *page = LatchRoot(true);
   locks.push(page);
   auto *tree_page = reinterpret_cast<BPlusTreePage *>(page->GetData());
   
   while(!tree_page->IsLeafPage()){
     auto *internal_page = reinterpret_cast<InternalPage *>(tree_page);
     auto page_id = internal_page->Lookup(key, comparator_);
-    page = buffer_pool_manager_->FetchPage(page_id);
+    page = FetchNode(page_id);
     tree_page = reinterpret_cast<BPlusTreePage *>(page->GetData());
     page->WLatch();
     
@@ -205,29 +298,143 @@ auto BPLUSTREE_TYPE::FindLeaf(const KeyType &key, int mode, std::queue<Page *>&
 
 
 }
+
+/*
+ * Fetch and latch the root. A split or a merge of the root may replace it
+ * between reading its page id and latching it, in which case the new root is
+ * latched instead.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::LatchRoot(bool exclusive) -> Page * {
+  while (true) {
+    page_id_t root_page_id = GetRootPageId();
+    Page *page = FetchNode(root_page_id);
+    if (exclusive) {
+      page->WLatch();
+    } else {
+      page->RLatch();
+    }
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    if (node->IsRootPage() && node->GetPageId() == root_page_id) {
+      return page;
+    }
+    if (exclusive) {
+      page->WUnlatch();
+    } else {
+      page->RUnlatch();
+    }
+    buffer_pool_manager_->UnpinPage(root_page_id, false);
+  }
+}
+
+/*
+ * Find the leaf of a key for a writer that most likely changes only the leaf:
+ * descend with read latches like a search, and write-latch only the leaf. The
+ * root and the upper levels stay shared between writers; a writer that turns
+ * out to need a split or a merge gives the leaf up and retries with FindLeaf.
+ * The type of a node only changes while its parent is latched, so it is read
+ * before the node is latched to pick the latch mode.
+ * @return : the pinned, write-latched leaf, or nullptr if the root changed
+ * before it was latched
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafOptimistic(const KeyType &key) -> Page * {
+  page_id_t root_page_id = GetRootPageId();
+  Page *page = FetchNode(root_page_id);
+  if (page == nullptr) {
+    return nullptr;
+  }
+  auto *tree_page = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  bool is_leaf = tree_page->IsLeafPage();
+  if (is_leaf) {
+    page->WLatch();
+  } else {
+    page->RLatch();
+  }
+  // A split or a merge of the root may have replaced it in the meantime.
+  if (tree_page->IsLeafPage() != is_leaf || !tree_page->IsRootPage() || tree_page->GetPageId() != root_page_id) {
+    if (is_leaf) {
+      page->WUnlatch();
+    } else {
+      page->RUnlatch();
+    }
+    buffer_pool_manager_->UnpinPage(root_page_id, false);
+    return nullptr;
+  }
+
+  while (!is_leaf) {
+    auto *internal_page = reinterpret_cast<InternalPage *>(tree_page);
+    Page *child = FetchNode(internal_page->Lookup(key, comparator_));
+    tree_page = reinterpret_cast<BPlusTreePage *>(child->GetData());
+    is_leaf = tree_page->IsLeafPage();
+    if (is_leaf) {
+      child->WLatch();
+    } else {
+      child->RLatch();
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = child;
+  }
+  return page;
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) -> bool {
   // std::cout << "Insert operation, " << key << std::endl;
   if(CheckEmpty()){
     root_lock_.lock();
     // std::cout << "Entering root page id " << root_page_id_ << " " << key << std::endl;
-    Page *new_page = buffer_pool_manager_->NewPage(&root_page_id_);
+    // Another writer may have started the tree while this one waited.
+    if (root_page_id_ != INVALID_PAGE_ID) {
+      root_lock_.unlock();
+      return Insert(key, value, transaction);
+    }
+    page_id_t root_page_id;
+    Page *new_page = buffer_pool_manager_->NewPage(&root_page_id);
     if(new_page == nullptr){
       std::cout << "Error "  << std::endl;
       root_lock_.unlock();
       return false;
     }
+    new_page->SetPageClass(PageClass::INDEX_LEAF);
     auto *new_leaf= reinterpret_cast<LeafPage *>(new_page->GetData());
     
-    new_leaf->Init(root_page_id_, INVALID_PAGE_ID, leaf_max_size_);
+    new_leaf->Init(root_page_id, INVALID_PAGE_ID, leaf_max_size_);
     
     new_page->WLatch();
     new_leaf->Insert(key, value, comparator_);
     new_page->WUnlatch();
+    // Lookups read the root page id without root_lock_, so the leaf is only
+    // published once it is initialized.
+    root_page_id_.store(root_page_id, std::memory_order_release);
     buffer_pool_manager_->UnpinPage(new_page->GetPageId(), true);
     UpdateRootPageId(1);
     // std::cout << "Created root page id " << root_page_id_ << std::endl;
     root_lock_.unlock();
+    return true;
+  }
+  // Most inserts do not split their leaf and only need to write-latch it.
+  if (b_plus_tree_optimistic_latching.load(std::memory_order_relaxed)) {
+    Page *page = FindLeafOptimistic(key);
+    if (page != nullptr) {
+      auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+      int old_size = leaf->GetSize();
+      if (old_size < leaf_max_size_) {
+        bool inserted = leaf->Insert(key, value, comparator_) != old_size;
+        page->WUnlatch();
+        buffer_pool_manager_->UnpinPage(page->GetPageId(), inserted);
+        return inserted;
+      }
+      // A full leaf splits, unless it already holds the key.
+      ValueType old_value;
+      bool is_duplicate = leaf->Lookup(key, &old_value, comparator_);
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      if (is_duplicate) {
+        return false;
+      }
+    }
   }
   // std::cout << "Firing findleaf key for root" << key << " " << root_page_id_ << std::endl;
   std::queue<Page *> ancestor_locks;
@@ -266,10 +473,11 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
   auto *new_leaf = reinterpret_cast<LeafPage *>(Split(leaf));
   new_leaf->SetNextPageId(leaf->GetNextPageId());
   leaf->SetNextPageId(new_leaf->GetPageId());
+  // InsertToParent releases the latches and the pins of the leaf and its ancestors.
+  page_id_t new_leaf_id = new_leaf->GetPageId();
   InsertToParent(leaf, new_leaf, new_leaf->KeyAt(0), ancestor_locks);
-  buffer_pool_manager_->UnpinPage(leaf->GetPageId(), true);
-  buffer_pool_manager_->UnpinPage(new_leaf->GetPageId(), true);
-  return false;
+  buffer_pool_manager_->UnpinPage(new_leaf_id, true);
+  return true;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -279,6 +487,7 @@ page_id_t page_id;
   if (new_page == nullptr) {
     // throw Exception(ExceptionType::OUT_OF_MEMORY, "New page failed.");
   }
+  new_page->SetPageClass(page->IsLeafPage() ? PageClass::INDEX_LEAF : PageClass::INDEX_INTERNAL);
   if (page->IsLeafPage()) {
     auto *leaf_page = reinterpret_cast<LeafPage *>(page);
     auto *new_leaf = reinterpret_cast<LeafPage *>(new_page->GetData());
@@ -293,6 +502,129 @@ page_id_t page_id;
   return reinterpret_cast<BPlusTreePage *>(new_page->GetData());
 }
 
+/*****************************************************************************
+ * BULK LOADING
+ *****************************************************************************/
+/*
+ * Build the tree bottom-up from key/value pairs instead of inserting them one
+ * by one: sort the pairs, pack them into leaves filled to fill_factor of their
+ * max size, then build each level of internal pages over the one below, up to
+ * the root. The pages of a level are allocated one after the other, so they
+ * end up next to each other on disk. Nodes of a level share their entries
+ * evenly, so that the last one is not left nearly empty.
+ * Only an empty tree can be bulk loaded, and there must be no concurrent
+ * writers while it is. Of several pairs with the same key, the first one is
+ * kept, as Insert would. If the buffer pool runs out of frames, the pages
+ * built so far are deleted and an OUT_OF_MEMORY Exception is thrown, leaving
+ * the tree empty.
+ * @return : false if the tree is not empty and was left unchanged
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BulkLoad(std::vector<std::pair<KeyType, ValueType>> pairs, double fill_factor) -> bool {
+  std::scoped_lock<std::mutex> lock(root_lock_);
+  if (root_page_id_ != INVALID_PAGE_ID) {
+    return false;
+  }
+  if (pairs.empty()) {
+    return true;
+  }
+  std::stable_sort(pairs.begin(), pairs.end(),
+                   [this](const auto &a, const auto &b) { return comparator_(a.first, b.first) < 0; });
+  pairs.erase(std::unique(pairs.begin(), pairs.end(),
+                          [this](const auto &a, const auto &b) { return comparator_(a.first, b.first) == 0; }),
+              pairs.end());
+
+  // Nodes filled below their min size would underflow on their first remove.
+  fill_factor = std::clamp(fill_factor, 0.5, 1.0);
+  const int leaf_capacity = std::max({1, leaf_max_size_ / 2, static_cast<int>(leaf_max_size_ * fill_factor)});
+  const int internal_capacity =
+      std::max({2, (internal_max_size_ + 1) / 2, static_cast<int>(internal_max_size_ * fill_factor)});
+  // Split count entries evenly over as few nodes of at most capacity entries as possible.
+  auto node_sizes = [](size_t count, int capacity) {
+    size_t num_nodes = (count + capacity - 1) / capacity;
+    std::vector<int> sizes(num_nodes, static_cast<int>(count / num_nodes));
+    for (size_t i = 0; i < count % num_nodes; i++) {
+      sizes[i]++;
+    }
+    return sizes;
+  };
+  // The pages built so far, and the last leaf, which stays pinned until the next one is linked to it. If the buffer
+  // pool runs out of frames, they are given back rather than left allocated without a tree to reach them.
+  std::vector<page_id_t> built;
+  LeafPage *prev_leaf = nullptr;
+  auto give_up = [&]() {
+    if (prev_leaf != nullptr) {
+      buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
+    }
+    for (page_id_t page_id : built) {
+      buffer_pool_manager_->DeletePage(page_id);
+    }
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame for a B+ tree page while bulk loading");
+  };
+  auto new_node = [&](PageClass page_class, page_id_t *page_id) {
+    Page *page = buffer_pool_manager_->NewPage(page_id);
+    if (page == nullptr) {
+      give_up();
+    }
+    built.push_back(*page_id);
+    page->SetPageClass(page_class);
+    return page->GetData();
+  };
+
+  // The first key and the page id of every node of the level built last.
+  std::vector<std::pair<KeyType, page_id_t>> level;
+  size_t offset = 0;
+  for (int size : node_sizes(pairs.size(), leaf_capacity)) {
+    page_id_t page_id;
+    auto *leaf = reinterpret_cast<LeafPage *>(new_node(PageClass::INDEX_LEAF, &page_id));
+    leaf->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+    leaf->SetNextPageId(INVALID_PAGE_ID);
+    leaf->CopyData(pairs.data() + offset, size);
+    offset += size;
+    if (prev_leaf != nullptr) {
+      prev_leaf->SetNextPageId(page_id);
+      buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
+    }
+    prev_leaf = leaf;
+    level.emplace_back(leaf->KeyAt(0), page_id);
+  }
+  buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
+  prev_leaf = nullptr;
+  pairs.clear();
+  pairs.shrink_to_fit();
+
+  while (level.size() > 1) {
+    std::vector<std::pair<KeyType, page_id_t>> parent_level;
+    size_t first_child = 0;
+    for (int size : node_sizes(level.size(), internal_capacity)) {
+      page_id_t page_id;
+      auto *internal = reinterpret_cast<InternalPage *>(new_node(PageClass::INDEX_INTERNAL, &page_id));
+      internal->Init(page_id, INVALID_PAGE_ID, internal_max_size_);
+      for (int i = 0; i < size; i++) {
+        internal->SetKeyAt(i, level[first_child + i].first);
+        internal->SetValueAt(i, level[first_child + i].second);
+      }
+      internal->SetSize(size);
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      for (int i = 0; i < size; i++) {
+        Page *child = FetchNode(level[first_child + i].second);
+        if (child == nullptr) {
+          give_up();
+        }
+        reinterpret_cast<BPlusTreePage *>(child->GetData())->SetParentPageId(page_id);
+        buffer_pool_manager_->UnpinPage(child->GetPageId(), true);
+      }
+      parent_level.emplace_back(level[first_child].first, page_id);
+      first_child += size;
+    }
+    level = std::move(parent_level);
+  }
+
+  root_page_id_.store(level[0].second, std::memory_order_release);
+  UpdateRootPageId(1);
+  return true;
+}
+
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
@@ -305,105 +637,118 @@ page_id_t page_id;
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
-  // std::cout << "Remove operation, key: " << GetRootPageId() << " "  << key.ToString() << " " << std::this_thread::get_id() << std::endl;
+  if (num_pending_deletes_.load(std::memory_order_relaxed) > 0) {
+    DeletePages({});
+  }
   // Return immediately if current tree is empty.
   if (IsEmpty()) {
     return;
   }
+  // Most removes leave their leaf at least half full and only need to write-latch it.
+  if (b_plus_tree_optimistic_latching.load(std::memory_order_relaxed)) {
+    Page *page = FindLeafOptimistic(key);
+    if (page != nullptr) {
+      auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+      if (leaf->IsRootPage() || leaf->GetSize() > leaf->GetMinSize()) {
+        bool removed = leaf->Remove(key, comparator_);
+        page->WUnlatch();
+        buffer_pool_manager_->UnpinPage(page->GetPageId(), removed);
+        return;
+      }
+      // A leaf at its min size underflows, unless it does not hold the key.
+      ValueType value;
+      bool exists = leaf->Lookup(key, &value, comparator_);
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      if (!exists) {
+        return;
+      }
+    }
+  }
   std::queue<Page *> locks;
+  std::vector<page_id_t> deleted_pages;
   Page *page = FindLeaf(key,3, locks);
-  // page->WUnlatch();
   auto *tree_page = reinterpret_cast<LeafPage *>(page->GetData());
-  std::cout << "Tree has key: " << tree_page->GetSize() << std::endl;
 
   bool result = tree_page->Remove(key, comparator_);
-  // Return immediately if key is not find.
-  if (!result) {
-    while(!locks.empty()){
-      locks.front()->WUnlatch();
-      buffer_pool_manager_->UnpinPage(locks.front()->GetPageId(), true);
-      locks.pop();
-    }
-    std::cout << "Already Removed operation, key: " << tree_page->GetSize() << " " << key.ToString() << " " << std::this_thread::get_id() << std::endl;
-    return;
+  // The leaf underflows only if the key was found; the latches and pins of the
+  // leaf and of its ancestors are released together either way.
+  if (result && tree_page->GetSize() < tree_page->GetMinSize()) {
+    RedistributeOrMerge(tree_page, locks, deleted_pages);
+  }
+  while(!locks.empty()){
+    locks.front()->WUnlatch();
+    buffer_pool_manager_->UnpinPage(locks.front()->GetPageId(), result);
+    locks.pop();
+  }
+  // The pages of merged-away and collapsed nodes go back to the free page map once this remove no longer pins them.
+  if (!deleted_pages.empty()) {
+    DeletePages(std::move(deleted_pages));
   }
-  // If tree page size is ok after removal.
-  if (tree_page->GetSize() >= tree_page->GetMinSize()) {
+}
 
-    while(!locks.empty()){
-      locks.front()->WUnlatch();
-      buffer_pool_manager_->UnpinPage(locks.front()->GetPageId(), true);
-      locks.pop();
+/*
+ * Delete the pages of removed nodes. A page that a concurrent reader still
+ * pins fails to delete; rather than being reused under the reader or leaked,
+ * it is kept and retried by later removes and by the destructor.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::DeletePages(std::vector<page_id_t> page_ids) {
+  std::scoped_lock<std::mutex> lock(pending_deletes_lock_);
+  page_ids.insert(page_ids.end(), pending_deletes_.begin(), pending_deletes_.end());
+  pending_deletes_.clear();
+  for (page_id_t page_id : page_ids) {
+    if (!buffer_pool_manager_->DeletePage(page_id)) {
+      pending_deletes_.push_back(page_id);
     }
-    std::cout << "Successful operation, key: " << key.ToString() << " " << std::this_thread::get_id() << std::endl;
-    return;
-  }
-  std::cout << "Redistribute Remove operation, key: " << key.ToString() << " " << std::this_thread::get_id() << std::endl;
-  RedistributeOrMerge(tree_page, locks);
-  buffer_pool_manager_->UnpinPage(tree_page->GetPageId(), true);
-  while(!locks.empty()){
-      locks.front()->WUnlatch();
-      buffer_pool_manager_->UnpinPage(locks.front()->GetPageId(), true);
-      locks.pop();
   }
-  
+  num_pending_deletes_.store(pending_deletes_.size(), std::memory_order_relaxed);
 }
 
+/*
+ * Fix an underflowing node by borrowing from or merging with a sibling. The
+ * node and its parent are write-latched by the caller; the siblings are
+ * latched here, since writers that only change a leaf may have reached one of
+ * them through the parent before the caller latched it.
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::RedistributeOrMerge(BPlusTreePage *node, std::queue<Page *>& locks){
-  std::cout << "Remove operation parent" << node->GetPageId() << " " << std::this_thread::get_id() << std::endl;
+void BPLUSTREE_TYPE::RedistributeOrMerge(BPlusTreePage *node, std::queue<Page *>& locks,
+                                         std::vector<page_id_t> &deleted_pages){
   if (node->IsRootPage() || node->GetPageId() == INVALID_PAGE_ID) {
     return;
   }
   // The size is smaller than the min size, try to borrow from siblings.
-  Page *parent = buffer_pool_manager_->FetchPage(node->GetParentPageId());
+  Page *parent = FetchNode(node->GetParentPageId());
   auto *parent_page = reinterpret_cast<InternalPage *>(parent->GetData());
   int index = parent_page->ValueIndex(node->GetPageId());
-  int left_sibling_id = parent_page->ValueAt(index - 1);
-  if (index > 0) {
-    Page *left_sibling = buffer_pool_manager_->FetchPage(left_sibling_id);
-    auto *left_sibling_page = reinterpret_cast<BPlusTreePage *>(left_sibling->GetData());
-    if (left_sibling_page->GetSize() > left_sibling_page->GetMinSize()) {
-      RedistributeLeft(left_sibling_page, node, parent_page, index);
-      buffer_pool_manager_->UnpinPage(left_sibling_id, true);
-      buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), true);
-
-      
-      return;
-    }
-    buffer_pool_manager_->UnpinPage(left_sibling_id, false);
+  Page *left_sibling = index > 0 ? FetchNode(parent_page->ValueAt(index - 1)) : nullptr;
+  Page *right_sibling = index < parent_page->GetSize() - 1 ? FetchNode(parent_page->ValueAt(index + 1)) : nullptr;
+  BPlusTreePage *left_sibling_page = nullptr;
+  BPlusTreePage *right_sibling_page = nullptr;
+  if (left_sibling != nullptr) {
+    left_sibling->WLatch();
+    left_sibling_page = reinterpret_cast<BPlusTreePage *>(left_sibling->GetData());
   }
-  int right_sibling_id = parent_page->ValueAt(index + 1);
-  if (index < parent_page->GetSize() - 1) {
-    Page *right_sibling = buffer_pool_manager_->FetchPage(right_sibling_id);
-    auto *right_sibling_page = reinterpret_cast<BPlusTreePage *>(right_sibling->GetData());
-    if (right_sibling_page->GetSize() > right_sibling_page->GetMinSize()) {
-      RedistributeRight(right_sibling_page, node, parent_page, index);
-      buffer_pool_manager_->UnpinPage(right_sibling_id, true);
-      buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), true);
-
-      
-      return;
-    }
-    buffer_pool_manager_->UnpinPage(right_sibling_id, false);
+  if (right_sibling != nullptr) {
+    right_sibling->WLatch();
+    right_sibling_page = reinterpret_cast<BPlusTreePage *>(right_sibling->GetData());
   }
-  if (index > 0) {
-    Page *left = buffer_pool_manager_->FetchPage(left_sibling_id);
-    auto *left_page = reinterpret_cast<BPlusTreePage *>(left->GetData());
-    Merge(left_page, node, parent_page, index, locks);
-    buffer_pool_manager_->UnpinPage(left_sibling_id, true);
-    buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), true);
-
-    
-    return;
+  if (left_sibling_page != nullptr && left_sibling_page->GetSize() > left_sibling_page->GetMinSize()) {
+    RedistributeLeft(left_sibling_page, node, parent_page, index);
+  } else if (right_sibling_page != nullptr && right_sibling_page->GetSize() > right_sibling_page->GetMinSize()) {
+    RedistributeRight(right_sibling_page, node, parent_page, index);
+  } else if (left_sibling_page != nullptr) {
+    Merge(left_sibling_page, node, parent_page, index, locks, deleted_pages);
+  } else if (right_sibling_page != nullptr) {
+    Merge(node, right_sibling_page, parent_page, index + 1, locks, deleted_pages);
   }
-  if (index < parent_page->GetSize() - 1) {
-    Page *right = buffer_pool_manager_->FetchPage(right_sibling_id);
-    auto *right_page = reinterpret_cast<BPlusTreePage *>(right->GetData());
-    Merge(node, right_page, parent_page, index + 1, locks);
-    buffer_pool_manager_->UnpinPage(right_sibling_id, true);
-    buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), true);
+  for (Page *sibling : {left_sibling, right_sibling}) {
+    if (sibling != nullptr) {
+      sibling->WUnlatch();
+      buffer_pool_manager_->UnpinPage(sibling->GetPageId(), true);
+    }
   }
+  buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -418,11 +763,13 @@ void BPLUSTREE_TYPE::RedistributeLeft(Node *sibling_node, Node *target_node, Int
     target_page->Insert(key, sibling_page->ValueAt(left_index), comparator_);
     sibling_page->IncreaseSize(-1);
   } else {
+    // The last child of the sibling moves over, and the separator in the parent rotates down to the old first child.
     auto *sibling_internal = reinterpret_cast<InternalPage *>(sibling_node);
     auto *target_internal = reinterpret_cast<InternalPage *>(target_node);
     int left_index = sibling_internal->GetSize() - 1;
     key = sibling_internal->KeyAt(left_index);
-    target_internal->InsertToStart(key, sibling_internal->ValueAt(index), buffer_pool_manager_);
+    target_internal->InsertToStart(key, sibling_internal->ValueAt(left_index), buffer_pool_manager_);
+    target_internal->SetKeyAt(1, parent->KeyAt(index));
     sibling_internal->IncreaseSize(-1);
   }
   parent->SetKeyAt(index, key);
@@ -435,44 +782,49 @@ void BPLUSTREE_TYPE::RedistributeRight(Node *sibling_node, Node *target_node, In
   if (sibling_node->IsLeafPage()) {
     auto *sibling_page = reinterpret_cast<LeafPage *>(sibling_node);
     auto *target_page = reinterpret_cast<LeafPage *>(target_node);
+    target_page->Insert(sibling_page->KeyAt(0), sibling_page->ValueAt(0), comparator_);
+    sibling_page->Remove(sibling_page->KeyAt(0), comparator_);
     key = sibling_page->KeyAt(0);
-    target_page->Insert(key, sibling_page->ValueAt(0), comparator_);
-    sibling_page->IncreaseSize(-1);
   } else {
+    // The first child of the sibling moves over under the separator in the parent, and the next key of the sibling
+    // becomes the separator.
     auto *sibling_internal = reinterpret_cast<InternalPage *>(sibling_node);
     auto *target_internal = reinterpret_cast<InternalPage *>(target_node);
     key = sibling_internal->KeyAt(1);
-    target_internal->InsertToEnd(key, sibling_internal->ValueAt(1), buffer_pool_manager_);
-    sibling_internal->IncreaseSize(-1);
+    target_internal->InsertToEnd(parent->KeyAt(index + 1), sibling_internal->ValueAt(0), buffer_pool_manager_);
+    sibling_internal->Remove(0);
   }
   parent->SetKeyAt(index + 1, key);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 template <typename Node>
-void BPLUSTREE_TYPE::Merge(Node *dst_node, Node *src_node, InternalPage *parent, int index, std::queue<Page *>& locks) {
+void BPLUSTREE_TYPE::Merge(Node *dst_node, Node *src_node, InternalPage *parent, int index, std::queue<Page *>& locks,
+                           std::vector<page_id_t> &deleted_pages) {
   if (dst_node->IsLeafPage()) {
     auto *src_page = reinterpret_cast<LeafPage *>(src_node);
     auto *dst_page = reinterpret_cast<LeafPage *>(dst_node);
     src_page->MoveAllTo(dst_page);
   } else {
+    // The separator in the parent becomes the key of the first child of the source.
     auto *src_page = reinterpret_cast<InternalPage *>(src_node);
     auto *dst_page = reinterpret_cast<InternalPage *>(dst_node);
+    src_page->SetKeyAt(0, parent->KeyAt(index));
     src_page->MoveAllTo(dst_page, buffer_pool_manager_);
   }
-  std::cout << "size coalesing parent" << dst_node->GetSize() << std::endl; 
+  deleted_pages.push_back(src_node->GetPageId());
   parent->Remove(index);
-  if(parent->GetSize() == 1){
-    std::cout << "changing root " << dst_node->GetPageId() << std::endl; 
+  if(parent->IsRootPage() && parent->GetSize() == 1){
+    deleted_pages.push_back(parent->GetPageId());
     parent->SetPageId(INVALID_PAGE_ID);
     root_lock_.lock();
-    root_page_id_ = dst_node->GetPageId();
+    root_page_id_.store(dst_node->GetPageId(), std::memory_order_release);
     root_lock_.unlock();
     UpdateRootPageId(0);
     dst_node->SetParentPageId(INVALID_PAGE_ID);
   }
   if (parent->GetSize() < parent->GetMinSize()) {
-    RedistributeOrMerge(parent, locks);
+    RedistributeOrMerge(parent, locks, deleted_pages);
   }
 }
 /*****************************************************************************
@@ -485,12 +837,12 @@ void BPLUSTREE_TYPE::Merge(Node *dst_node, Node *src_node, InternalPage *parent,
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE { 
-  Page *root_page = buffer_pool_manager_->FetchPage(root_page_id_);
+  Page *root_page = FetchNode(root_page_id_);
   auto *tree_page = reinterpret_cast<BPlusTreePage *>(root_page->GetData());
   while (!tree_page->IsLeafPage()) {
     auto *internal_page = reinterpret_cast<InternalPage *>(tree_page);
     page_id_t page_id = internal_page->ValueAt(0);
-    tree_page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    tree_page = reinterpret_cast<BPlusTreePage *>(FetchNode(page_id)->GetData());
   }
   auto *leaf = reinterpret_cast<LeafPage *>(tree_page);
   return INDEXITERATOR_TYPE(buffer_pool_manager_, leaf, 0);
@@ -519,28 +871,57 @@ auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE { 
   
-  Page *root_page = buffer_pool_manager_->FetchPage(root_page_id_);
+  Page *root_page = FetchNode(root_page_id_);
   auto *tree_page = reinterpret_cast<BPlusTreePage *>(root_page->GetData());
   while (!tree_page->IsLeafPage()) {
     auto *internal_page = reinterpret_cast<InternalPage *>(tree_page);
     int index = internal_page->GetSize() - 1;
     page_id_t page_id = internal_page->ValueAt(index);
-    tree_page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    tree_page = reinterpret_cast<BPlusTreePage *>(FetchNode(page_id)->GetData());
   }
   auto *leaf = reinterpret_cast<LeafPage *>(tree_page);
   return INDEXITERATOR_TYPE(buffer_pool_manager_, leaf, leaf->GetSize());
 }
 
 /**
- * @return Page id of the root of this tree
+ * @return Page id of the root of this tree. It is read without root_lock_;
+ * callers validate that the page they fetch by it is still the root.
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { 
-  std::scoped_lock<std::mutex> lock(root_lock_);
-  return root_page_id_; 
-  
+auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { return root_page_id_.load(std::memory_order_acquire); }
+
+/*
+ * Collect the page ids of all the nodes, root first, e.g. to keep the index
+ * resident in the buffer pool. Nodes are read-latched one at a time, so the
+ * result is a snapshot that concurrent splits and merges may outdate.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetPageIds() -> std::vector<page_id_t> {
+  std::vector<page_id_t> page_ids;
+  page_id_t root_page_id = GetRootPageId();
+  if (root_page_id != INVALID_PAGE_ID) {
+    page_ids.push_back(root_page_id);
+  }
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    Page *page = FetchNode(page_ids[i]);
+    if (page == nullptr) {
+      break;
+    }
+    page->RLatch();
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    if (!node->IsLeafPage()) {
+      auto *internal = reinterpret_cast<InternalPage *>(node);
+      for (int j = 0; j < internal->GetSize(); j++) {
+        page_ids.push_back(internal->ValueAt(j));
+      }
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_ids[i], false);
+  }
+  return page_ids;
 }
 
+
 /*****************************************************************************
  * UTILITIES AND DEBUG
  *****************************************************************************/
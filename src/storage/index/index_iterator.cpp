@@ -41,8 +41,9 @@ auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
   if (index_ == leaf_->GetSize() && leaf_->GetNextPageId() != INVALID_PAGE_ID) {
     page_id_t page_id = leaf_->GetNextPageId();
     bpm_->UnpinPage(leaf_->GetPageId(), false);
-    Page *page = bpm_->FetchPage(page_id);
+    Page *page = bpm_->FetchPageWithClass(page_id, PageClass::INDEX_LEAF);
     leaf_ = reinterpret_cast<LeafPage *>(page->GetData());
+    read_ahead_.OnPage(bpm_, page_id, leaf_->GetNextPageId());
     
   } else {
     index_++;
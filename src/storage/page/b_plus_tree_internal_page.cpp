@@ -20,6 +20,7 @@
 #include "common/exception.h"
 #include "storage/index/generic_key.h"
 #include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/page/b_plus_tree_key_search.h"
 #include "storage/page/b_plus_tree_page.h"
 
 namespace bustub {
@@ -64,10 +65,8 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &valu
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType& key,  KeyComparator &comparator)->page_id_t{
-  auto iter = std::lower_bound(array_+1, array_ + GetSize(), key,
-  [comparator](const MappingType p, const KeyType key){
-  return comparator(p.first, key) < 0;
-  });
+  // the first key is invalid, search the ones after it
+  auto iter = array_ + 1 + KeyLowerBound(array_ + 1, GetSize() - 1, key, comparator);
 
   if(iter == array_+GetSize()){
     return ValueAt(GetSize()-1);
@@ -90,9 +89,10 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage *dst_page,
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyData(MappingType *items, int size, BufferPoolManager *bpm) ->void {
-  std::copy(items, items + size, array_);
+  int old_size = GetSize();
+  std::copy(items, items + size, array_ + old_size);
   IncreaseSize(size);
-  for (int index = 0; index < size; index++) {
+  for (int index = old_size; index < GetSize(); index++) {
     Page *page = bpm->FetchPage(ValueAt(index));
     auto *internal = reinterpret_cast<BPlusTreeInternalPage *>(page->GetData());
     internal->SetParentPageId(GetPageId());
@@ -125,7 +125,7 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *dst_page,
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertToStart(const KeyType &key, const ValueType &value, BufferPoolManager *bpm) {
   int size = GetSize();
-  std::move_backward(array_, array_ + size, array_ + 1);
+  std::move_backward(array_, array_ + size, array_ + size + 1);
   array_[0] = {key, value};
   IncreaseSize(1);
   auto page_id = reinterpret_cast<page_id_t>(value);
@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search.cpp
+//
+// Identification: src/storage/page/b_plus_tree_key_search.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_plus_tree_key_search.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BUSTUB_KEY_SEARCH_X86
+#endif
+
+namespace bustub {
+
+namespace {
+
+/** The number of keys left to the linear loop once the binary search narrowed them down. */
+constexpr int LINEAR_SEARCH_KEYS = 32;
+
+/**
+ * @return a key as an integer whose unsigned order is the memcmp order of its bytes, with its top bit flipped so that
+ * the signed compares of AVX2 order it the same way
+ */
+inline auto LoadKey(const char *key) -> int32_t {
+  uint32_t word;
+  memcpy(&word, key, sizeof(word));
+  return static_cast<int32_t>(__builtin_bswap32(word) ^ 0x80000000U);
+}
+
+/** @return the number of the size keys starting at keys that are less than key */
+auto CountLessScalar(const char *keys, size_t stride, int size, int32_t key) -> int {
+  int count = 0;
+  for (int i = 0; i < size; i++) {
+    count += static_cast<int>(LoadKey(keys + i * stride) < key);
+  }
+  return count;
+}
+
+#ifdef BUSTUB_KEY_SEARCH_X86
+
+__attribute__((target("avx2"))) auto CountLessAvx2(const char *keys, size_t stride, int size, int32_t key) -> int {
+  const auto step = static_cast<int32_t>(stride / sizeof(int32_t));
+  const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(step));
+  const __m256i bswap = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0, 7, 6, 5, 4,
+                                         11, 10, 9, 8, 15, 14, 13, 12);
+  const __m256i flip = _mm256_set1_epi32(static_cast<int32_t>(0x80000000U));
+  const __m256i search_key = _mm256_set1_epi32(key);
+  int count = 0;
+  int i = 0;
+  for (; i + 8 <= size; i += 8) {
+    __m256i vec = _mm256_i32gather_epi32(reinterpret_cast<const int *>(keys + i * stride), offsets, 4);
+    vec = _mm256_xor_si256(_mm256_shuffle_epi8(vec, bswap), flip);
+    count += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(search_key, vec))));
+  }
+  return count + CountLessScalar(keys + i * stride, stride, size - i, key);
+}
+
+#endif
+
+}  // namespace
+
+auto GetKeySearchIsa() -> KeySearchIsa {
+#ifdef BUSTUB_KEY_SEARCH_X86
+  static const KeySearchIsa isa = [] {
+    // Without a gather, loading the keys one by one costs more than the compares save, so there is no SSE loop.
+    return __builtin_cpu_supports("avx2") ? KeySearchIsa::AVX2 : KeySearchIsa::SCALAR;
+  }();
+  return isa;
+#else
+  return KeySearchIsa::SCALAR;
+#endif
+}
+
+auto LowerBoundKey32(const char *keys, size_t stride, int size, const char *key, KeySearchIsa isa) -> int {
+  const int32_t search_key = LoadKey(key);
+  int first = 0;
+  while (size > LINEAR_SEARCH_KEYS) {
+    int half = size / 2;
+    if (LoadKey(keys + (first + half) * stride) < search_key) {
+      first += half + 1;
+      size -= half + 1;
+    } else {
+      size = half;
+    }
+  }
+
+  const char *window = keys + first * stride;
+#ifdef BUSTUB_KEY_SEARCH_X86
+  // The gather of the AVX2 loop takes offsets in 4-byte units.
+  if (isa == KeySearchIsa::AVX2 && stride % sizeof(int32_t) == 0) {
+    return first + CountLessAvx2(window, stride, size, search_key);
+  }
+#endif
+  return first + CountLessScalar(window, stride, size, search_key);
+}
+
+}  // namespace bustub
@@ -14,6 +14,7 @@
 
 #include "common/exception.h"
 #include "common/rid.h"
+#include "storage/page/b_plus_tree_key_search.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 #include "storage/page/b_plus_tree_page.h"
 
@@ -109,11 +110,7 @@ KeyComparator &comparator) -> int{
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key,const KeyComparator &comparator) -> int {
-auto iter = std::lower_bound(array_, array_ + GetSize(), key,
-[comparator](const MappingType p, const KeyType key){
-  return comparator(p.first, key) < 0;
-});
-  return iter-array_;
+  return KeyLowerBound(array_, GetSize(), key, comparator);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -141,11 +138,6 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::CopyData(MappingType *items, int size) -> void{
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::Remove(const KeyType &key, const KeyComparator &comparator) -> bool {
-  std::cout << "Searching for key " << key.ToString() << std::endl;
-  for(int i = 0;i < GetSize();i++){
-    std::cout << array_[i].first.ToString() << " ";
-  }
-  
   int index = KeyIndex(key, comparator);
   // std::cout << "index " << index << std::endl;
   if(index == GetSize()){
@@ -0,0 +1,86 @@
+/**
+ * access_trace_test.cpp
+ */
+
+#include "buffer/access_trace.h"
+
+#include <cstdio>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(AccessTraceTest, RoundTripTest) {
+  const std::string trace_name = "access_trace_test.trace";
+  {
+    AccessTraceWriter writer(trace_name);
+    writer.Record(AccessTraceOp::FETCH, 0);
+    writer.Record(AccessTraceOp::NEW, 1);
+    writer.Record(AccessTraceOp::UNPIN, 0x7fffffff);
+    writer.Record(AccessTraceOp::DELETE, INVALID_PAGE_ID);
+    EXPECT_EQ(4, writer.GetNumRecords());
+  }
+
+  AccessTraceReader reader(trace_name);
+  AccessTraceRecord record;
+  ASSERT_TRUE(reader.Next(&record));
+  EXPECT_EQ(AccessTraceOp::FETCH, record.op_);
+  EXPECT_EQ(0, record.page_id_);
+  ASSERT_TRUE(reader.Next(&record));
+  EXPECT_EQ(AccessTraceOp::NEW, record.op_);
+  EXPECT_EQ(1, record.page_id_);
+  ASSERT_TRUE(reader.Next(&record));
+  EXPECT_EQ(AccessTraceOp::UNPIN, record.op_);
+  EXPECT_EQ(0x7fffffff, record.page_id_);
+  ASSERT_TRUE(reader.Next(&record));
+  EXPECT_EQ(AccessTraceOp::DELETE, record.op_);
+  EXPECT_EQ(INVALID_PAGE_ID, record.page_id_);
+  EXPECT_FALSE(reader.Next(&record));
+
+  remove(trace_name.c_str());
+  EXPECT_THROW(AccessTraceReader{trace_name}, Exception);
+}
+
+// NOLINTNEXTLINE
+TEST(AccessTraceTest, BufferPoolTraceTest) {
+  const std::string trace_name = "access_trace_test.trace";
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(4, disk_manager);
+  auto *writer = new AccessTraceWriter(trace_name);
+  bpm->SetAccessTrace(writer);
+
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  // A failed unpin is not recorded.
+  EXPECT_FALSE(bpm->UnpinPage(page_id, false));
+  ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  EXPECT_TRUE(bpm->DeletePage(page_id));
+
+  // Requests after the trace is detached are not recorded.
+  bpm->SetAccessTrace(nullptr);
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  delete writer;
+
+  std::vector<AccessTraceOp> expected_ops{AccessTraceOp::NEW, AccessTraceOp::UNPIN, AccessTraceOp::FETCH,
+                                          AccessTraceOp::UNPIN, AccessTraceOp::DELETE};
+  AccessTraceReader reader(trace_name);
+  AccessTraceRecord record;
+  for (auto op : expected_ops) {
+    ASSERT_TRUE(reader.Next(&record));
+    EXPECT_EQ(op, record.op_);
+    EXPECT_EQ(0, record.page_id_);
+  }
+  EXPECT_FALSE(reader.Next(&record));
+
+  remove(trace_name.c_str());
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
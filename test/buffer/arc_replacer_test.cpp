@@ -0,0 +1,125 @@
+/**
+ * arc_replacer_test.cpp
+ */
+
+#include "buffer/arc_replacer.h"
+
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(ARCReplacerTest, SampleTest) {
+  ARCReplacer arc_replacer(4);
+
+  // Scenario: load pages 10..13 into frames 0..3. They are all in T1.
+  for (frame_id_t frame_id = 0; frame_id < 4; frame_id++) {
+    arc_replacer.RecordAccess(frame_id, 10 + frame_id);
+    arc_replacer.SetEvictable(frame_id, true);
+  }
+  ASSERT_EQ(4, arc_replacer.Size());
+  ASSERT_EQ(0, arc_replacer.GetTarget());
+
+  // Scenario: a second access to page 10 promotes frame 0 to T2, so T1 loses its oldest frame first.
+  arc_replacer.RecordAccess(0, 10);
+  frame_id_t value;
+  ASSERT_TRUE(arc_replacer.Victim(&value));
+  ASSERT_EQ(1, value);
+  ASSERT_EQ(3, arc_replacer.Size());
+
+  // Scenario: page 11 is read back while remembered in B1. T1 was too small, so its target grows and the page
+  // goes straight to T2.
+  arc_replacer.RecordAccess(1, 11);
+  arc_replacer.SetEvictable(1, true);
+  ASSERT_EQ(1, arc_replacer.GetTarget());
+  ASSERT_EQ(4, arc_replacer.Size());
+
+  // Scenario: T1 = [2, 3] is larger than its target, so it keeps losing frames before T2 = [0, 1] does.
+  ASSERT_TRUE(arc_replacer.Victim(&value));
+  ASSERT_EQ(2, value);
+  arc_replacer.RecordAccess(2, 20);
+  arc_replacer.SetEvictable(2, true);
+  ASSERT_TRUE(arc_replacer.Victim(&value));
+  ASSERT_EQ(3, value);
+
+  // Scenario: T1 = [2] is now at its target, so the least recently used frame of T2 goes next.
+  ASSERT_TRUE(arc_replacer.Victim(&value));
+  ASSERT_EQ(0, value);
+
+  // Scenario: non-evictable frames are skipped, falling back to the other list.
+  arc_replacer.SetEvictable(1, false);
+  ASSERT_TRUE(arc_replacer.Victim(&value));
+  ASSERT_EQ(2, value);
+  ASSERT_FALSE(arc_replacer.Victim(&value));
+  ASSERT_EQ(0, arc_replacer.Size());
+
+  // Scenario: page 10 is read back while remembered in B2, which shrinks the target of T1 again.
+  arc_replacer.RecordAccess(0, 10);
+  ASSERT_EQ(0, arc_replacer.GetTarget());
+
+  // Scenario: removing a frame stops tracking it.
+  arc_replacer.SetEvictable(0, true);
+  ASSERT_EQ(1, arc_replacer.Size());
+  arc_replacer.Remove(0);
+  ASSERT_EQ(0, arc_replacer.Size());
+  ASSERT_FALSE(arc_replacer.Victim(&value));
+}
+
+TEST(ARCReplacerTest, ScanResistanceTest) {
+  const size_t num_frames = 16;
+  ARCReplacer arc_replacer(num_frames);
+
+  // Scenario: a hot set of 8 pages is accessed twice and lives in T2.
+  for (frame_id_t frame_id = 0; frame_id < 8; frame_id++) {
+    arc_replacer.RecordAccess(frame_id, frame_id);
+    arc_replacer.RecordAccess(frame_id, frame_id);
+    arc_replacer.SetEvictable(frame_id, true);
+  }
+
+  // Scenario: a long scan streams pages through the remaining frames. It must only ever evict its own frames.
+  page_id_t next_page_id = 1000;
+  for (frame_id_t frame_id = 8; frame_id < static_cast<frame_id_t>(num_frames); frame_id++) {
+    arc_replacer.RecordAccess(frame_id, next_page_id++);
+    arc_replacer.SetEvictable(frame_id, true);
+  }
+  for (int i = 0; i < 100; i++) {
+    frame_id_t value;
+    ASSERT_TRUE(arc_replacer.Victim(&value));
+    ASSERT_GE(value, 8);
+    arc_replacer.RecordAccess(value, next_page_id++);
+    arc_replacer.SetEvictable(value, true);
+  }
+}
+
+TEST(ARCReplacerTest, ConcurrencyTest) {
+  const size_t num_threads = 4;
+  const size_t num_frames = 64;
+  ARCReplacer arc_replacer(num_frames);
+
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&arc_replacer, tid] {
+      for (int round = 0; round < 100; round++) {
+        for (size_t i = tid; i < num_frames; i += num_threads) {
+          auto frame_id = static_cast<frame_id_t>(i);
+          arc_replacer.RecordAccess(frame_id, static_cast<page_id_t>(round * num_frames + i));
+          arc_replacer.SetEvictable(frame_id, true);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(num_frames, arc_replacer.Size());
+  frame_id_t value;
+  for (size_t i = 0; i < num_frames; i++) {
+    ASSERT_TRUE(arc_replacer.Victim(&value));
+  }
+  ASSERT_FALSE(arc_replacer.Victim(&value));
+}
+
+}  // namespace bustub
@@ -12,12 +12,24 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <future>  // NOLINT
 #include <random>
+#include <set>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/hot_page_set.h"
+#include "buffer/read_ahead.h"
+#include "common/exception.h"
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_manager_mmap.h"
+#include "storage/disk/disk_manager_posix.h"
 
 namespace bustub {
 
@@ -145,4 +157,867 @@ TEST(BufferPoolManagerInstanceTest, SampleTest) {
   delete disk_manager;
 }
 
+/** An in-memory disk manager whose reads of one page block until the test releases them. */
+class BlockingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  explicit BlockingDiskManager(page_id_t blocked_page_id) : blocked_page_id_(blocked_page_id) {}
+
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    if (page_id == blocked_page_id_) {
+      read_started_.set_value();
+      release_future_.wait();
+    }
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+
+  page_id_t blocked_page_id_;
+  std::promise<void> read_started_;
+  std::promise<void> release_;
+  std::shared_future<void> release_future_{release_.get_future()};
+};
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, IOOutsideLatchTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t k = 2;
+
+  auto *disk_manager = new BlockingDiskManager(0);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, k);
+
+  // Page 0 is written to disk and evicted by the pages after it, which stay resident.
+  page_id_t page_id_temp;
+  auto *page0 = bpm->NewPage(&page_id_temp);
+  snprintf(page0->GetData(), BUSTUB_PAGE_SIZE, "Hello");
+  EXPECT_EQ(true, bpm->UnpinPage(0, true));
+  for (page_id_t page_id = 1; page_id <= static_cast<page_id_t>(buffer_pool_size); ++page_id) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(page_id, page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+
+  // Scenario: a miss on page 0 blocks inside the disk manager.
+  auto read_started = disk_manager->read_started_.get_future();
+  std::thread first_reader([bpm] {
+    auto *page = bpm->FetchPage(0);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), "Hello"));
+  });
+  read_started.wait();
+
+  // Scenario: while the read is in flight, hits and new pages do not wait for it.
+  const auto resident_page_id = static_cast<page_id_t>(buffer_pool_size);
+  EXPECT_NE(nullptr, bpm->FetchPage(resident_page_id));
+  EXPECT_EQ(true, bpm->UnpinPage(resident_page_id, false));
+  EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+
+  // Scenario: a second requester of the loading page waits for the same frame instead of reading it again.
+  std::thread second_reader([bpm] {
+    auto *page = bpm->FetchPage(0);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), "Hello"));
+  });
+  disk_manager->release_.set_value();
+  first_reader.join();
+  second_reader.join();
+
+  page0 = bpm->FetchPage(0);
+  EXPECT_EQ(3, page0->GetPinCount());
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(true, bpm->UnpinPage(0, false));
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, PageCleanerTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t k = 2;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, k);
+  bpm->RunPageCleaner(0, 1, std::chrono::milliseconds(10));
+
+  // Scenario: fill the pool with dirty, unpinned pages. The cleaner writes all of them back.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  for (int i = 0; i < 500 && bpm->GetNumCleanerWriteBacks() < buffer_pool_size; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(buffer_pool_size, bpm->GetNumCleanerWriteBacks());
+  bpm->StopPageCleaner();
+
+  // Scenario: evicting the cleaned pages does not write anything in the foreground.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+  EXPECT_EQ(0, bpm->GetNumForegroundWriteBacks());
+  EXPECT_EQ(buffer_pool_size, bpm->GetNumAvoidedWriteBacks());
+
+  // Scenario: the cleaned pages can be read back.
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size); ++page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+/** An in-memory disk manager whose batched writes take a while, as the page cleaner's do on a real disk. */
+class SlowBatchDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  void SubmitRequests(std::vector<DiskRequest> *requests) override {
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+    DiskManager::SubmitRequests(requests);
+  }
+};
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, PageCleanerUnpinRaceTest) {
+  const size_t buffer_pool_size = 8;
+  const size_t k = 2;
+  const int num_threads = 4;
+  const int num_pages = 16;
+
+  auto *disk_manager = new SlowBatchDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, k);
+  page_id_t page_id_temp;
+  for (int i = 0; i < num_pages; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: unpins of dirty pages race with the cleaner pinning them, while misses evict frames during its writes.
+  bpm->RunPageCleaner(0, 1, std::chrono::milliseconds(0));
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([bpm, t] {
+      std::default_random_engine rng(t);
+      std::uniform_int_distribution<page_id_t> page_dist(0, num_pages - 1);
+      for (int i = 0; i < 5000; ++i) {
+        const page_id_t page_id = page_dist(rng);
+        if (bpm->FetchPage(page_id) != nullptr) {
+          bpm->UnpinPage(page_id, true);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  bpm->StopPageCleaner();
+
+  // Every frame is back in the replacer or on the free list, so the whole pool can be pinned by new pages.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp)) << i;
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerInstanceTest, PrefetchTest) {
+  const size_t buffer_pool_size = 16;
+  const size_t k = 2;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, k);
+
+  // Scenario: create twice as many pages as there are frames, so that the first half is evicted.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < 2 * buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: resident and unallocated pages are skipped, evicted ones are read in the background.
+  bpm->PrefetchPages({0, 1, 2, 3, static_cast<page_id_t>(2 * buffer_pool_size - 1), 1000}, nullptr);
+  for (int i = 0; i < 500 && bpm->GetNumPrefetchedPages() < 4; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(4, bpm->GetNumPrefetchedPages());
+
+  // Scenario: prefetched pages are unpinned and hold the data that was written out.
+  for (page_id_t page_id = 0; page_id < 4; ++page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(1, page->GetPinCount());
+    EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(4, bpm->GetNumPrefetchedPages());
+
+  // Scenario: a sequential chain grows the read-ahead window, a jump resets it.
+  ReadAhead read_ahead;
+  read_ahead.OnPage(bpm, 4, 5);
+  EXPECT_EQ(0, read_ahead.GetWindow());
+  read_ahead.OnPage(bpm, 5, 6);
+  EXPECT_EQ(READ_AHEAD_MIN_PAGES, read_ahead.GetWindow());
+  read_ahead.OnPage(bpm, 6, 7);
+  EXPECT_EQ(buffer_pool_size / 4, read_ahead.GetWindow());
+  read_ahead.OnPage(bpm, 7, 20);
+  EXPECT_EQ(0, read_ahead.GetWindow());
+
+  delete bpm;
+  delete disk_manager;
+}
+
+/** An in-memory disk manager whose batched I/Os fail on the pages the test picks. */
+class FailingBatchDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  void SubmitRequests(std::vector<DiskRequest> *requests) override {
+    for (auto &request : *requests) {
+      if ((request.is_write_ ? failed_writes_ : failed_reads_).count(request.page_id_) > 0) {
+        request.callback_.set_value(false);
+      } else if (request.is_write_) {
+        WritePage(request.page_id_, request.data_);
+        request.callback_.set_value(true);
+      } else {
+        ReadPage(request.page_id_, request.data_);
+        request.callback_.set_value(true);
+      }
+    }
+    num_batches_++;
+  }
+
+  std::set<page_id_t> failed_writes_;
+  std::set<page_id_t> failed_reads_;
+  std::atomic<int> num_batches_{0};
+};
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, PrefetchFailureTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t k = 2;
+
+  auto *disk_manager = new FailingBatchDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, k);
+
+  // Pages [0, 4) are written out on eviction; pages [4, 8) stay resident and dirty.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < 2 * buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: the victims whose write-back fails stay in their frames, dirty, and nothing is prefetched.
+  for (page_id_t page_id = 4; page_id < 8; ++page_id) {
+    disk_manager->failed_writes_.insert(page_id);
+  }
+  bpm->PrefetchPages({0, 1}, nullptr);
+  for (int i = 0; i < 500 && disk_manager->num_batches_ < 1; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  for (page_id_t page_id = 4; page_id < 8; ++page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_TRUE(page->IsDirty());
+    EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(0, bpm->GetNumPrefetchedPages());
+
+  // Scenario: a page whose read fails is dropped, and the next fetch reads it again.
+  disk_manager->failed_writes_.clear();
+  disk_manager->failed_reads_.insert(2);
+  bpm->PrefetchPages({2, 3}, nullptr);
+  for (int i = 0; i < 500 && bpm->GetNumPrefetchedPages() < 1; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(1, bpm->GetNumPrefetchedPages());
+  for (page_id_t page_id = 2; page_id < 4; ++page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(1, page->GetPinCount());
+    EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+/** An in-memory disk manager that counts the pages read from it. */
+class CountingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    num_reads_++;
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+
+  std::atomic<int> num_reads_{0};
+};
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, BufferAccessStrategyTest) {
+  const size_t buffer_pool_size = 16;
+  const size_t k = 2;
+  const size_t ring_size = 4;
+
+  auto *disk_manager = new CountingDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, k);
+
+  // Scenario: create 40 pages. Pages [24, 40) stay in the pool, and the last four are used once more.
+  page_id_t page_id_temp;
+  for (int i = 0; i < 40; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  for (page_id_t page_id = 36; page_id < 40; ++page_id) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: a scan of the evicted pages only recycles the frames of its ring.
+  auto *strategy = new BufferAccessStrategy(bpm, ring_size);
+  disk_manager->num_reads_ = 0;
+  for (page_id_t page_id = 0; page_id < 24; ++page_id) {
+    auto *page = bpm->FetchPageWithStrategy(page_id, strategy);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(24, disk_manager->num_reads_);
+  for (page_id_t page_id = 24 + static_cast<page_id_t>(ring_size); page_id < 40; ++page_id) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+  }
+  EXPECT_EQ(24, disk_manager->num_reads_);
+
+  // Scenario: once the strategy is gone, its frames are the only unpinned ones and can be evicted.
+  delete strategy;
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(ring_size); ++page_id) {
+    EXPECT_NE(nullptr, bpm->FetchPage(page_id));
+  }
+  EXPECT_EQ(nullptr, bpm->FetchPage(4));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, ReplacerTypeTest) {
+  const size_t buffer_pool_size = 10;
+  const int num_pages = 30;
+
+  for (auto replacer_type : {ReplacerType::LRU_K, ReplacerType::ARC, ReplacerType::TWO_Q}) {
+    auto *disk_manager = new DiskManagerUnlimitedMemory();
+    auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, LRUK_REPLACER_K, nullptr, replacer_type);
+
+    page_id_t page_id_temp;
+    for (int i = 0; i < num_pages; ++i) {
+      auto *page = bpm->NewPage(&page_id_temp);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+      EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    }
+
+    // Scenario: a skewed mix of hot and cold pages always reads back the right contents.
+    std::default_random_engine rng(42);
+    std::uniform_int_distribution<int> page_dist(0, num_pages - 1);
+    for (int i = 0; i < 1000; ++i) {
+      page_id_t page_id = i % 2 == 0 ? page_dist(rng) % 4 : page_dist(rng);
+      auto *page = bpm->FetchPage(page_id);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    }
+
+    // Scenario: every frame can still be pinned, and no more.
+    for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size); ++page_id) {
+      EXPECT_NE(nullptr, bpm->FetchPage(page_id));
+    }
+    EXPECT_EQ(nullptr, bpm->FetchPage(static_cast<page_id_t>(buffer_pool_size)));
+
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, DeletePageReuseTest) {
+  const size_t buffer_pool_size = 4;
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  for (int i = 0; i < 8; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: a resident and an evicted page are both returned to the disk manager.
+  EXPECT_EQ(true, bpm->DeletePage(6));
+  EXPECT_EQ(true, bpm->DeletePage(1));
+  EXPECT_FALSE(disk_manager->IsPageAllocated(1));
+  EXPECT_FALSE(disk_manager->IsPageAllocated(6));
+
+  // Scenario: new pages reuse the deleted ids, lowest first, and start out zeroed.
+  auto *page = bpm->NewPage(&page_id_temp);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(1, page_id_temp);
+  EXPECT_EQ(0, page->GetData()[0]);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(6, page_id_temp);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(8, page_id_temp);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+
+  // Scenario: even after eviction, a reused page does not read back the contents of the deleted one.
+  for (page_id_t page_id = 2; page_id < 6; ++page_id) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  page = bpm->FetchPage(1);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, page->GetData()[0]);
+  EXPECT_EQ(true, bpm->UnpinPage(1, false));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, ResizeTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t grown_size = BufferPoolManagerInstance::FRAMES_PER_CHUNK + 8;
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  auto *first_page = bpm->NewPage(&page_id_temp);
+  ASSERT_NE(nullptr, first_page);
+  snprintf(first_page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+
+  // Scenario: growing past a chunk adds frames while a page stays pinned where it is.
+  EXPECT_EQ(true, bpm->Resize(grown_size));
+  EXPECT_EQ(grown_size, bpm->GetPoolSize());
+  for (size_t i = 1; i < grown_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(first_page, bpm->FetchPage(0));
+  EXPECT_EQ(true, bpm->UnpinPage(0, true));
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(grown_size); ++page_id) {
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: a pinned frame keeps the pool from shrinking past it until the timeout.
+  auto *last_page = bpm->FetchPage(static_cast<page_id_t>(grown_size - 1));
+  ASSERT_NE(nullptr, last_page);
+  EXPECT_EQ(false, bpm->Resize(2, std::chrono::milliseconds(20)));
+  EXPECT_EQ(grown_size, bpm->GetPoolSize());
+  EXPECT_EQ(true, bpm->UnpinPage(static_cast<page_id_t>(grown_size - 1), false));
+
+  // Scenario: shrinking writes the dirty pages of the retired frames back, and the rest of the pool keeps working.
+  EXPECT_EQ(true, bpm->Resize(2));
+  EXPECT_EQ(2, bpm->GetPoolSize());
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(grown_size); ++page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  ASSERT_NE(nullptr, bpm->FetchPage(0));
+  ASSERT_NE(nullptr, bpm->FetchPage(1));
+  EXPECT_EQ(nullptr, bpm->FetchPage(2));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+  EXPECT_EQ(true, bpm->UnpinPage(1, false));
+
+  // Scenario: growing again brings the retired frames back.
+  EXPECT_EQ(true, bpm->Resize(buffer_pool_size));
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size); ++page_id) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+  }
+  EXPECT_EQ(nullptr, bpm->FetchPage(static_cast<page_id_t>(buffer_pool_size)));
+  EXPECT_EQ(false, bpm->Resize(0));
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size); ++page_id) {
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: readers keep fetching the right pages while the pool grows and shrinks under them.
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int thread_id = 0; thread_id < 4; ++thread_id) {
+    readers.emplace_back([&, thread_id] {
+      std::mt19937 rng(thread_id);
+      while (!done) {
+        const auto page_id = static_cast<page_id_t>(rng() % 64);
+        auto *page = bpm->FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+        EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (int round = 0; round < 10; ++round) {
+    EXPECT_EQ(true, bpm->Resize(round % 2 == 0 ? grown_size : 8));
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, VictimCacheTest) {
+  const size_t buffer_pool_size = 4;
+  const int num_pages = 12;
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  victim_cache_size = 1 << 20;
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  victim_cache_size = 0;
+
+  page_id_t page_id_temp;
+  for (int i = 0; i < num_pages; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  // Dirty victims are written back, not demoted.
+  EXPECT_EQ(0, bpm->GetVictimCacheStats().demotions_);
+
+  // Scenario: once the pages are clean, their evictions demote them and later misses are served from the cache.
+  for (int round = 0; round < 3; ++round) {
+    for (page_id_t page_id = 0; page_id < num_pages; ++page_id) {
+      auto *page = bpm->FetchPage(page_id);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    }
+  }
+  auto stats = bpm->GetVictimCacheStats();
+  EXPECT_EQ(2 * num_pages, stats.hits_);
+  EXPECT_EQ(stats.hits_ + num_pages, stats.lookups_);
+  EXPECT_GT(stats.GetCompressionRatio(), 4.0);
+
+  // Touching all the other pages evicts page 0 with the replacer's cyclic pattern.
+  auto evict_first_page = [&] {
+    for (page_id_t page_id = 1; page_id < num_pages; ++page_id) {
+      ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    }
+  };
+
+  // Scenario: a modified page is written back on eviction; the cache never returns the copy from before.
+  auto *page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "modified");
+  EXPECT_EQ(true, bpm->UnpinPage(0, true));
+  evict_first_page();
+  page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("modified", std::string(page->GetData()));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+
+  // Scenario: deleting a demoted page drops it from the cache, so its reused id does not read it back.
+  evict_first_page();
+  EXPECT_EQ(true, bpm->DeletePage(0));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(0, page_id_temp);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  evict_first_page();
+  page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, page->GetData()[0]);
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, StatsTest) {
+  const size_t buffer_pool_size = 4;
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  for (page_id_t page_id = 4; page_id < 8; ++page_id) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  ASSERT_NE(nullptr, bpm->FetchPage(0));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+  EXPECT_EQ(true, bpm->FlushPage(0));
+
+  // Scenario: every request and every I/O is counted, and each timed event lands in its histogram.
+  auto stats = bpm->GetStats();
+  EXPECT_EQ(8, stats.Get(BufferPoolCounter::NEW_PAGES));
+  EXPECT_EQ(4, stats.Get(BufferPoolCounter::FETCH_HITS));
+  EXPECT_EQ(1, stats.Get(BufferPoolCounter::FETCH_MISSES));
+  EXPECT_EQ(5, stats.Get(BufferPoolCounter::EVICTIONS));
+  EXPECT_EQ(5, stats.Get(BufferPoolCounter::DIRTY_WRITE_BACKS));
+  EXPECT_EQ(1, stats.Get(BufferPoolCounter::DISK_READS));
+  EXPECT_EQ(6, stats.Get(BufferPoolCounter::DISK_WRITES));
+  EXPECT_EQ(0, stats.Get(BufferPoolCounter::PIN_WAITS));
+  EXPECT_DOUBLE_EQ(0.8, stats.GetHitRatio());
+  // Hits are sampled per thread.
+  EXPECT_GE(1, stats.GetLatency(BufferPoolLatency::FETCH_HIT).count_);
+  EXPECT_EQ(1, stats.GetLatency(BufferPoolLatency::FETCH_MISS).count_);
+  EXPECT_EQ(1, stats.GetLatency(BufferPoolLatency::DISK_READ).count_);
+  EXPECT_EQ(6, stats.GetLatency(BufferPoolLatency::DISK_WRITE).count_);
+  const auto &miss_latency = stats.GetLatency(BufferPoolLatency::FETCH_MISS);
+  EXPECT_LE(miss_latency.GetMeanNs(), miss_latency.GetPercentileNs(100));
+  EXPECT_GT(2 * miss_latency.GetMeanNs() + 1, miss_latency.GetPercentileNs(100));
+
+  // Scenario: percentiles are reported as the upper bound of their power-of-two bucket.
+  LatencyHistogram histogram;
+  for (uint64_t latency_ns : {0, 1, 100, 100, 100, 5000}) {
+    histogram.buckets_[LatencyHistogram::BucketOf(latency_ns)]++;
+    histogram.count_++;
+    histogram.sum_ns_ += latency_ns;
+  }
+  EXPECT_EQ(1, histogram.GetPercentileNs(0));
+  EXPECT_EQ(127, histogram.GetPercentileNs(50));
+  EXPECT_EQ(8191, histogram.GetPercentileNs(100));
+  EXPECT_EQ(883, histogram.GetMeanNs());
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, PageClassTest) {
+  const size_t buffer_pool_size = 4;
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  page_class_priorities = true;
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  page_class_priorities = false;
+
+  page_id_t page_id_temp;
+  for (int i = 0; i < 4; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    if (page_id_temp == 0) {
+      page->SetPageClass(PageClass::INDEX_INTERNAL);
+    }
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  auto is_resident = [&](page_id_t page_id) {
+    auto misses = bpm->GetStats().Get(BufferPoolCounter::FETCH_MISSES);
+    EXPECT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    return bpm->GetStats().Get(BufferPoolCounter::FETCH_MISSES) == misses;
+  };
+  auto churn = [&] {
+    for (int i = 0; i < 8; ++i) {
+      ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+      EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    }
+  };
+
+  // Scenario: the index-internal page outlives untagged pages that were used more recently.
+  churn();
+  EXPECT_TRUE(is_resident(0));
+  EXPECT_FALSE(is_resident(1));
+
+  // Scenario: resident pages survive any churn, but may take at most half of the frames.
+  EXPECT_TRUE(bpm->SetPageResident(2, true));
+  EXPECT_TRUE(bpm->SetPageResident(3, true));
+  EXPECT_FALSE(bpm->SetPageResident(4, true));
+  churn();
+  EXPECT_TRUE(is_resident(2));
+  EXPECT_TRUE(is_resident(3));
+
+  // Scenario: released pages are evicted again, and deleting a resident page releases it.
+  EXPECT_TRUE(bpm->SetPageResident(2, false));
+  EXPECT_TRUE(bpm->DeletePage(3));
+  EXPECT_TRUE(bpm->SetPageResident(4, true));
+  churn();
+  EXPECT_FALSE(is_resident(2));
+  EXPECT_TRUE(is_resident(4));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, WarmStartTest) {
+  const std::string hot_page_file = "bpm_warm_start_test.warm";
+  const size_t buffer_pool_size = 8;
+  const size_t k = 2;
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, k);
+
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  for (page_id_t page_id : {2, 5, 5}) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: pages with k accesses are hottest by their kth most recent access, then the others by their first one.
+  const std::vector<page_id_t> hot_pages{5, 2, 7, 6, 4, 3, 1, 0};
+  EXPECT_EQ(hot_pages, bpm->GetHotPages());
+  ASSERT_TRUE(HotPageSet::Save(hot_page_file, bpm->GetHotPages()));
+  EXPECT_EQ(hot_pages, HotPageSet::Load(hot_page_file));
+  bpm->FlushAllPages();
+  delete bpm;
+
+  // Scenario: a restarted pool loads the saved pages in the background.
+  bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, k);
+  bpm->WarmUp({0, 2, 5});
+  for (int i = 0; i < 500 && bpm->GetNumPrefetchedPages() < 3; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(3, bpm->GetNumPrefetchedPages());
+  auto *page = bpm->FetchPage(5);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("5", std::string(page->GetData()));
+  EXPECT_EQ(true, bpm->UnpinPage(5, false));
+  delete bpm;
+
+  // Scenario: a warm-up only fills the frames that are free, and a missing file holds no pages.
+  bpm = new BufferPoolManagerInstance(2, disk_manager, k);
+  bpm->WarmUp(hot_pages);
+  for (int i = 0; i < 500 && bpm->GetNumPrefetchedPages() < 2; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(2, bpm->GetNumPrefetchedPages());
+  remove(hot_page_file.c_str());
+  EXPECT_TRUE(HotPageSet::Load(hot_page_file).empty());
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, DirectIOTest) {
+  const std::string db_name = "bpm_direct_io_test.db";
+  const size_t buffer_pool_size = 4;
+  const int num_pages = 12;
+  remove(db_name.c_str());
+
+  for (bool huge_pages : {false, true}) {
+    buffer_pool_huge_pages = huge_pages;
+    auto *disk_manager = new DiskManagerPosix(db_name, true);
+    auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+    // Scenario: frames are page-aligned, so O_DIRECT reads and writes them in place.
+    page_id_t page_id_temp;
+    for (int i = 0; i < num_pages; ++i) {
+      auto *page = bpm->NewPage(&page_id_temp);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(0, reinterpret_cast<uintptr_t>(page->GetData()) % BUSTUB_PAGE_SIZE);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+      EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    }
+
+    // Scenario: evicted pages read back through the direct path.
+    for (page_id_t page_id = 0; page_id < num_pages; ++page_id) {
+      auto *page = bpm->FetchPage(page_id);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    }
+
+    delete bpm;
+    disk_manager->ShutDown();
+    delete disk_manager;
+    remove(db_name.c_str());
+    remove("bpm_direct_io_test.log");
+    remove("bpm_direct_io_test.fsm");
+  }
+  buffer_pool_huge_pages = false;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, ReadOnlyMmapTest) {
+  const std::string db_name = "bpm_read_only_mmap_test.db";
+  const size_t buffer_pool_size = 4;
+  const int num_pages = 12;
+  remove(db_name.c_str());
+  remove("bpm_read_only_mmap_test.fsm");
+  {
+    DiskManagerPosix disk_manager(db_name);
+    BufferPoolManagerInstance bpm(buffer_pool_size, &disk_manager);
+    page_id_t page_id_temp;
+    for (int i = 0; i < num_pages; ++i) {
+      auto *page = bpm.NewPage(&page_id_temp);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id_temp);
+      EXPECT_EQ(true, bpm.UnpinPage(page_id_temp, true));
+    }
+    bpm.FlushAllPages();
+    disk_manager.ShutDown();
+  }
+
+  auto *disk_manager = new DiskManagerMmap(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: misses point the frames at the mapped pages instead of copying them, also after eviction.
+  for (int round = 0; round < 2; ++round) {
+    for (page_id_t page_id = 0; page_id < num_pages; ++page_id) {
+      auto *page = bpm->FetchPage(page_id);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(disk_manager->MapPage(page_id), page->GetData());
+      EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    }
+  }
+
+  // Scenario: prefetched pages are mapped too.
+  bpm->PrefetchPages({0, 1}, nullptr);
+  for (int i = 0; i < 500 && bpm->GetNumPrefetchedPages() < 2; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(2, bpm->GetNumPrefetchedPages());
+  auto *page = bpm->FetchPage(1);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(disk_manager->MapPage(1), page->GetData());
+
+  // Scenario: writes are rejected up front. A dirty unpin still releases the pin.
+  page_id_t page_id_temp;
+  EXPECT_THROW(bpm->NewPage(&page_id_temp), Exception);
+  EXPECT_THROW(bpm->DeletePage(0), Exception);
+  EXPECT_THROW(bpm->UnpinPage(1, true), Exception);
+  EXPECT_EQ(0, page->GetPinCount());
+  EXPECT_EQ(false, page->IsDirty());
+  EXPECT_EQ(true, bpm->FlushPage(1));
+  bpm->FlushAllPages();
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+  remove("bpm_read_only_mmap_test.log");
+  remove("bpm_read_only_mmap_test.fsm");
+}
+
 }  // namespace bustub
@@ -97,4 +97,70 @@ TEST(LRUKReplacerTest, SampleTest) {
   lru_replacer.Remove(1);
   ASSERT_EQ(0, lru_replacer.Size());
 }
+
+TEST(LRUKReplacerTest, RemoveTest) {
+  LRUKReplacer lru_replacer(3, 2);
+  int value;
+
+  // Scenario: a non-evictable frame is removed too, and starts over with no history.
+  lru_replacer.RecordAccess(2);
+  lru_replacer.RecordAccess(2);
+  lru_replacer.SetEvictable(2, true);
+  lru_replacer.RecordAccess(1);
+  lru_replacer.SetEvictable(1, false);
+  lru_replacer.Remove(1);
+  ASSERT_EQ(1, lru_replacer.Size());
+
+  // With its old access kept, frame 1 would have a finite k-distance, shorter than frame 2's.
+  lru_replacer.RecordAccess(1);
+  lru_replacer.SetEvictable(1, true);
+  ASSERT_EQ(2, lru_replacer.Size());
+  ASSERT_TRUE(lru_replacer.Evict(&value));
+  EXPECT_EQ(1, value);
+
+  // Scenario: removing an evictable frame shrinks the replacer.
+  lru_replacer.Remove(2);
+  ASSERT_EQ(0, lru_replacer.Size());
+  ASSERT_FALSE(lru_replacer.Evict(&value));
+}
+
+TEST(LRUKReplacerTest, PageClassTest) {
+  LRUKReplacer lru_replacer(6, 2);
+  int value;
+
+  // Scenario: frames are evicted by the priority of their class first: temp, heap, leaf, internal.
+  lru_replacer.RecordAccess(0, 0, PageClass::INDEX_INTERNAL);
+  lru_replacer.RecordAccess(1, 1, PageClass::HEAP);
+  lru_replacer.RecordAccess(2, 2, PageClass::INDEX_LEAF);
+  lru_replacer.RecordAccess(3, 3, PageClass::TEMP);
+  lru_replacer.RecordAccess(4, 4, PageClass::HEAP);
+  lru_replacer.RecordAccess(1, 1, PageClass::HEAP);
+  for (frame_id_t frame_id = 0; frame_id < 5; frame_id++) {
+    lru_replacer.SetEvictable(frame_id, true);
+  }
+  for (frame_id_t expected : {3, 4, 1, 2, 0}) {
+    ASSERT_TRUE(lru_replacer.Evict(&value));
+    EXPECT_EQ(expected, value);
+  }
+
+  // Scenario: a frame takes the class of its last access, and untagged accesses rank like heap pages.
+  lru_replacer.RecordAccess(0, 0, PageClass::INDEX_INTERNAL);
+  lru_replacer.RecordAccess(1);
+  lru_replacer.RecordAccess(0, 0, PageClass::HEAP);
+  lru_replacer.SetEvictable(0, true);
+  lru_replacer.SetEvictable(1, true);
+  ASSERT_TRUE(lru_replacer.Evict(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_TRUE(lru_replacer.Evict(&value));
+  EXPECT_EQ(0, value);
+
+  // Scenario: with all priorities equal, the classes are ignored.
+  lru_replacer.SetPageClassPriorities({});
+  lru_replacer.RecordAccess(0, 0, PageClass::INDEX_INTERNAL);
+  lru_replacer.RecordAccess(1, 1, PageClass::TEMP);
+  lru_replacer.SetEvictable(0, true);
+  lru_replacer.SetEvictable(1, true);
+  ASSERT_TRUE(lru_replacer.Evict(&value));
+  EXPECT_EQ(0, value);
+}
 }  // namespace bustub
@@ -0,0 +1,124 @@
+/**
+ * two_q_replacer_test.cpp
+ */
+
+#include "buffer/two_q_replacer.h"
+
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(TwoQReplacerTest, SampleTest) {
+  // A1in may keep 2 of the 8 frames before it becomes the preferred victim queue.
+  TwoQReplacer two_q_replacer(8);
+
+  // Scenario: load pages 0..3 into frames 0..3. They are all in A1in.
+  for (frame_id_t frame_id = 0; frame_id < 4; frame_id++) {
+    two_q_replacer.RecordAccess(frame_id, frame_id);
+    two_q_replacer.SetEvictable(frame_id, true);
+  }
+  ASSERT_EQ(4, two_q_replacer.Size());
+
+  // Scenario: re-accessing a page in A1in does not promote it, so A1in is still evicted in FIFO order.
+  two_q_replacer.RecordAccess(0, 0);
+  frame_id_t value;
+  ASSERT_TRUE(two_q_replacer.Victim(&value));
+  ASSERT_EQ(0, value);
+  ASSERT_EQ(3, two_q_replacer.Size());
+
+  // Scenario: page 0 is read back while remembered in A1out, so it enters Am.
+  two_q_replacer.RecordAccess(0, 0);
+  two_q_replacer.SetEvictable(0, true);
+  two_q_replacer.RecordAccess(4, 4);
+  two_q_replacer.SetEvictable(4, true);
+  ASSERT_EQ(5, two_q_replacer.Size());
+
+  // Scenario: A1in = [1, 2, 3, 4] exceeds its share and loses frames until it is back at 2.
+  ASSERT_TRUE(two_q_replacer.Victim(&value));
+  ASSERT_EQ(1, value);
+  ASSERT_TRUE(two_q_replacer.Victim(&value));
+  ASSERT_EQ(2, value);
+
+  // Scenario: A1in is at its share, so the least recently used frame of Am goes next.
+  ASSERT_TRUE(two_q_replacer.Victim(&value));
+  ASSERT_EQ(0, value);
+
+  // Scenario: non-evictable frames are skipped.
+  two_q_replacer.SetEvictable(3, false);
+  ASSERT_TRUE(two_q_replacer.Victim(&value));
+  ASSERT_EQ(4, value);
+  ASSERT_FALSE(two_q_replacer.Victim(&value));
+  ASSERT_EQ(0, two_q_replacer.Size());
+
+  // Scenario: removing a frame stops tracking it.
+  two_q_replacer.SetEvictable(3, true);
+  ASSERT_EQ(1, two_q_replacer.Size());
+  two_q_replacer.Remove(3);
+  ASSERT_EQ(0, two_q_replacer.Size());
+  ASSERT_FALSE(two_q_replacer.Victim(&value));
+}
+
+TEST(TwoQReplacerTest, ScanResistanceTest) {
+  const size_t num_frames = 16;
+  TwoQReplacer two_q_replacer(num_frames);
+
+  // Scenario: a hot set of 8 pages is loaded, pushed out of A1in by 8 other pages and read back, so it lives in Am.
+  // The other pages stay in A1in.
+  for (frame_id_t frame_id = 0; frame_id < static_cast<frame_id_t>(num_frames); frame_id++) {
+    two_q_replacer.RecordAccess(frame_id, frame_id < 8 ? frame_id : 1000 + frame_id);
+    two_q_replacer.SetEvictable(frame_id, true);
+  }
+  for (frame_id_t frame_id = 0; frame_id < 8; frame_id++) {
+    frame_id_t value;
+    ASSERT_TRUE(two_q_replacer.Victim(&value));
+    ASSERT_EQ(frame_id, value);
+  }
+  for (frame_id_t frame_id = 0; frame_id < 8; frame_id++) {
+    two_q_replacer.RecordAccess(frame_id, frame_id);
+    two_q_replacer.SetEvictable(frame_id, true);
+  }
+
+  // Scenario: a long scan streams pages through the other frames. It must only ever evict its own frames.
+  page_id_t next_page_id = 2000;
+  for (int i = 0; i < 100; i++) {
+    frame_id_t value;
+    ASSERT_TRUE(two_q_replacer.Victim(&value));
+    ASSERT_GE(value, 8);
+    two_q_replacer.RecordAccess(value, next_page_id++);
+    two_q_replacer.SetEvictable(value, true);
+  }
+}
+
+TEST(TwoQReplacerTest, ConcurrencyTest) {
+  const size_t num_threads = 4;
+  const size_t num_frames = 64;
+  TwoQReplacer two_q_replacer(num_frames);
+
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&two_q_replacer, tid] {
+      for (int round = 0; round < 100; round++) {
+        for (size_t i = tid; i < num_frames; i += num_threads) {
+          auto frame_id = static_cast<frame_id_t>(i);
+          two_q_replacer.RecordAccess(frame_id, static_cast<page_id_t>(round * num_frames + i));
+          two_q_replacer.SetEvictable(frame_id, true);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(num_frames, two_q_replacer.Size());
+  frame_id_t value;
+  for (size_t i = 0; i < num_frames; i++) {
+    ASSERT_TRUE(two_q_replacer.Victim(&value));
+  }
+  ASSERT_FALSE(two_q_replacer.Victim(&value));
+}
+
+}  // namespace bustub
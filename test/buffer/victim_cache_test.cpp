@@ -0,0 +1,90 @@
+/**
+ * victim_cache_test.cpp
+ */
+
+#include "buffer/victim_cache.h"
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/** A page that compresses well: its id followed by zeroes. */
+static auto MakePage(page_id_t page_id) -> std::vector<char> {
+  std::vector<char> page(BUSTUB_PAGE_SIZE, 0);
+  snprintf(page.data(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+  return page;
+}
+
+TEST(VictimCacheTest, SampleTest) {
+  VictimCache cache(1 << 20);
+  std::vector<char> data(BUSTUB_PAGE_SIZE);
+
+  for (page_id_t page_id = 0; page_id < 8; page_id++) {
+    EXPECT_TRUE(cache.Insert(page_id, MakePage(page_id).data()));
+  }
+  EXPECT_EQ(8, cache.Size());
+  EXPECT_LT(cache.GetUsedBytes(), 8 * BUSTUB_PAGE_SIZE / 4);
+
+  // Scenario: a hit decompresses the page and moves it out of the cache.
+  EXPECT_TRUE(cache.Take(3, data.data()));
+  EXPECT_EQ(MakePage(3), data);
+  EXPECT_FALSE(cache.Take(3, data.data()));
+  EXPECT_EQ(7, cache.Size());
+
+  // Scenario: erased pages are gone, and a page inserted again replaces its older copy.
+  cache.Erase(4);
+  EXPECT_FALSE(cache.Take(4, data.data()));
+  auto page = MakePage(5);
+  page[100] = 'x';
+  EXPECT_TRUE(cache.Insert(5, page.data()));
+  EXPECT_EQ(6, cache.Size());
+  EXPECT_TRUE(cache.Take(5, data.data()));
+  EXPECT_EQ(page, data);
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(4, stats.lookups_);
+  EXPECT_EQ(2, stats.hits_);
+  EXPECT_EQ(9, stats.demotions_);
+  EXPECT_EQ(0, stats.rejections_);
+  EXPECT_GT(stats.GetCompressionRatio(), 4.0);
+}
+
+TEST(VictimCacheTest, CapacityTest) {
+  std::vector<char> data(BUSTUB_PAGE_SIZE);
+  const size_t page_size = [] {
+    VictimCache cache(1 << 20);
+    cache.Insert(0, MakePage(0).data());
+    return cache.GetUsedBytes();
+  }();
+  VictimCache cache(page_size * 4);
+
+  // Scenario: the least recently demoted pages make room for new ones.
+  for (page_id_t page_id = 0; page_id < 6; page_id++) {
+    EXPECT_TRUE(cache.Insert(page_id, MakePage(page_id).data()));
+    EXPECT_LE(cache.GetUsedBytes(), page_size * 4);
+  }
+  EXPECT_EQ(4, cache.Size());
+  EXPECT_FALSE(cache.Take(0, data.data()));
+  EXPECT_FALSE(cache.Take(1, data.data()));
+  EXPECT_TRUE(cache.Take(2, data.data()));
+  EXPECT_EQ(MakePage(2), data);
+  EXPECT_EQ(2, cache.GetStats().evictions_);
+
+  // Scenario: pages that do not compress are not stored.
+  std::mt19937 rng(0);
+  std::vector<char> random_page(BUSTUB_PAGE_SIZE);
+  for (auto &c : random_page) {
+    c = static_cast<char>(rng());
+  }
+  EXPECT_FALSE(cache.Insert(9, random_page.data()));
+  EXPECT_FALSE(cache.Take(9, data.data()));
+  EXPECT_EQ(1, cache.GetStats().rejections_);
+  EXPECT_EQ(3, cache.Size());
+}
+
+}  // namespace bustub
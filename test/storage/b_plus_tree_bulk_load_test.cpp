@@ -0,0 +1,232 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_bulk_load_test.cpp
+//
+// Identification: test/storage/b_plus_tree_bulk_load_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <array>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/config.h"
+#include "common/exception.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using BulkLoadTree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+/** @return num_keys shuffled key/value pairs, in which the keys divisible by 7 appear twice with different values */
+static auto MakePairs(int64_t num_keys) -> std::vector<std::pair<GenericKey<8>, RID>> {
+  std::vector<std::pair<GenericKey<8>, RID>> pairs;
+  GenericKey<8> index_key;
+  for (int64_t key = 1; key <= num_keys; key++) {
+    index_key.SetFromInteger(key);
+    pairs.emplace_back(index_key, RID(0, key));
+    if (key % 7 == 0) {
+      pairs.emplace_back(index_key, RID(1, key));
+    }
+  }
+  std::shuffle(pairs.begin(), pairs.end(), std::mt19937(0));
+  return pairs;
+}
+
+TEST(BPlusTreeTests, BulkLoadTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // create b+ tree with small nodes, so that the bulk load builds several levels
+  BulkLoadTree tree("foo_pk", bpm, comparator, 4, 5);
+  GenericKey<8> index_key;
+  // create transaction
+  auto *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int64_t num_keys = 500;
+  auto pairs = MakePairs(num_keys);
+  // Scenario: the first of several pairs with the same key wins, as with Insert.
+  std::vector<RID> first_values(num_keys + 1);
+  for (auto it = pairs.rbegin(); it != pairs.rend(); ++it) {
+    first_values[it->second.GetSlotNum()] = it->second;
+  }
+  EXPECT_TRUE(tree.BulkLoad(pairs));
+  EXPECT_FALSE(tree.IsEmpty());
+
+  std::vector<RID> rids;
+  for (int64_t key = 1; key <= num_keys; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.GetValue(index_key, &rids));
+    ASSERT_EQ(rids.size(), 1);
+    EXPECT_EQ(rids[0], first_values[key]);
+  }
+
+  // Scenario: a tree that is not empty is left unchanged.
+  EXPECT_FALSE(tree.BulkLoad(MakePairs(10)));
+
+  // Scenario: the bulk loaded tree takes inserts and removes, which split and merge its nodes.
+  for (int64_t key = num_keys + 1; key <= num_keys + 100; key++) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, key), transaction));
+  }
+  for (int64_t key = 1; key <= num_keys + 100; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+  }
+  for (int64_t key = 1; key <= num_keys + 100; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(tree.GetValue(index_key, &rids), key % 2 == 0);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, BulkLoadFillFactorTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManagerMemory(1 << 10);
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int64_t num_keys = 1000;
+  auto pairs = MakePairs(num_keys);
+
+  BulkLoadTree inserted("inserted", bpm, comparator, 10, 10);
+  for (const auto &[key, value] : pairs) {
+    inserted.Insert(key, value);
+  }
+  BulkLoadTree full("full", bpm, comparator, 10, 10);
+  EXPECT_TRUE(full.BulkLoad(pairs, 1.0));
+  BulkLoadTree half("half", bpm, comparator, 10, 10);
+  // Scenario: a fill factor below one half is raised to it, so that nodes do not start out underflowing.
+  EXPECT_TRUE(half.BulkLoad(pairs, 0.1));
+
+  // Scenario: packed nodes take fewer pages than the half full nodes of splits.
+  auto inserted_pages = inserted.GetPageIds().size();
+  auto full_pages = full.GetPageIds().size();
+  auto half_pages = half.GetPageIds().size();
+  EXPECT_LT(full_pages, inserted_pages);
+  EXPECT_LT(full_pages, half_pages);
+  // 1000 keys in leaves of 5 keys, 200 leaves under internal nodes of 5 children, and so on up to the root.
+  EXPECT_EQ(half_pages, 200 + 40 + 8 + 2 + 1);
+
+  GenericKey<8> index_key;
+  std::vector<RID> rids;
+  for (int64_t key = 1; key <= num_keys; key++) {
+    index_key.SetFromInteger(key);
+    rids.clear();
+    EXPECT_TRUE(full.GetValue(index_key, &rids));
+    rids.clear();
+    EXPECT_TRUE(half.GetValue(index_key, &rids));
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+}
+
+TEST(BPlusTreeTests, BulkLoadOutOfFramesTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(3, disk_manager);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  page_id_t pinned_page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&pinned_page_id));
+
+  // Scenario: with a single free frame, the second leaf finds no frame. The first one is deleted again, and the tree
+  // stays empty.
+  BulkLoadTree tree("foo_pk", bpm, comparator, 4, 5);
+  EXPECT_THROW(tree.BulkLoad(MakePairs(100)), Exception);
+  EXPECT_TRUE(tree.IsEmpty());
+  EXPECT_FALSE(disk_manager->IsPageAllocated(pinned_page_id + 1));
+
+  // Scenario: no page of the bulk load is left pinned.
+  EXPECT_TRUE(bpm->UnpinPage(pinned_page_id, false));
+  std::vector<page_id_t> new_page_ids(2);
+  for (auto &new_page_id : new_page_ids) {
+    EXPECT_NE(nullptr, bpm->NewPage(&new_page_id));
+  }
+  for (auto new_page_id : new_page_ids) {
+    EXPECT_TRUE(bpm->UnpinPage(new_page_id, false));
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+}
+
+TEST(BPlusTreeTests, DISABLED_BulkLoadBenchmark) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  std::cout << "keys insert_ms bulk_load_ms insert_pages bulk_load_pages" << std::endl;
+  for (int64_t num_keys : {10000, 30000, 100000}) {
+    auto pairs = MakePairs(num_keys);
+    std::array<size_t, 2> time_ms{};
+    std::array<size_t, 2> pages{};
+    for (size_t bulk = 0; bulk < 2; bulk++) {
+      auto *disk_manager = new DiskManagerMemory(256 << 10);
+      BufferPoolManager *bpm = new BufferPoolManagerInstance(1024, disk_manager);
+      page_id_t page_id;
+      auto header_page = bpm->NewPage(&page_id);
+      (void)header_page;
+      // A node one entry over its max size must still fit into its page until it is split.
+      BulkLoadTree tree("foo_pk", bpm, comparator, 128, 128);
+
+      auto start = std::chrono::steady_clock::now();
+      if (bulk == 1) {
+        tree.BulkLoad(pairs);
+      } else {
+        for (const auto &[key, value] : pairs) {
+          tree.Insert(key, value);
+        }
+      }
+      auto dur = std::chrono::steady_clock::now() - start;
+      time_ms[bulk] = std::chrono::duration_cast<std::chrono::milliseconds>(dur).count();
+      pages[bulk] = tree.GetPageIds().size();
+
+      bpm->UnpinPage(HEADER_PAGE_ID, true);
+      delete disk_manager;
+      delete bpm;
+    }
+    std::cout << num_keys << " " << time_ms[0] << " " << time_ms[1] << " " << pages[0] << " " << pages[1]
+              << std::endl;
+  }
+}
+
+}  // namespace bustub
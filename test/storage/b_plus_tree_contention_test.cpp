@@ -2,18 +2,24 @@
  * b_plus_tree_contention_test.cpp
  */
 
+#include <array>
+#include <atomic>
 #include <chrono>  // NOLINT
 #include <cstdio>
 #include <functional>
 #include <future>  // NOLINT
 #include <iostream>
+#include <random>
 #include <thread>  // NOLINT
 
 #include "buffer/buffer_pool_manager_instance.h"
+#include "common/config.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager_memory.h"
 #include "storage/index/b_plus_tree.h"
+#include "storage/table/table_heap.h"
 #include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
 
 namespace bustub {
 
@@ -154,4 +160,226 @@ TEST(BPlusTreeTest, DISABLED_BPlusTreeContentionBenchmark2) {  // NOLINT
             << std::endl;
 }
 
+/**
+ * Run inserts, lookups and removes of disjoint key ranges from num_threads threads against one tree.
+ * @return the operations per second of each phase: insert, lookup, remove
+ */
+auto BPlusTreeThroughputCall(size_t num_threads, int leaf_node_size, bool optimistic) -> std::array<double, 3> {
+  b_plus_tree_optimistic_latching = optimistic;
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManagerMemory(256 << 10);
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(1024, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, leaf_node_size, 10);
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int keys_per_thread = 40000 / num_threads;
+  // Interleave the keys of the threads so that they keep meeting in the same leaves.
+  auto key_of = [num_threads](size_t thread, int i) { return static_cast<int64_t>(i) * num_threads + thread; };
+
+  std::array<double, 3> ops_per_second{};
+  for (size_t phase = 0; phase < ops_per_second.size(); phase++) {
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < num_threads; t++) {
+      threads.emplace_back([&, t, phase] {
+        GenericKey<8> index_key;
+        std::vector<RID> result;
+        for (int i = 0; i < keys_per_thread; i++) {
+          auto key = key_of(t, i);
+          index_key.SetFromInteger(key);
+          if (phase == 0) {
+            tree.Insert(index_key, RID(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF));
+          } else if (phase == 1) {
+            result.clear();
+            tree.GetValue(index_key, &result);
+          } else if (i % 2 == 0) {
+            // Remove every other key, which also merges leaves now and then.
+            tree.Remove(index_key);
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    auto ops = phase == 2 ? (keys_per_thread + 1) / 2 * num_threads : keys_per_thread * num_threads;
+    ops_per_second[phase] = static_cast<double>(ops) / seconds;
+  }
+
+  // Every key that was not removed is still there.
+  GenericKey<8> index_key;
+  std::vector<RID> result;
+  for (size_t t = 0; t < num_threads; t++) {
+    for (int i = 1; i < keys_per_thread; i += 2) {
+      index_key.SetFromInteger(key_of(t, i));
+      result.clear();
+      EXPECT_TRUE(tree.GetValue(index_key, &result));
+    }
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  b_plus_tree_optimistic_latching = true;
+  return ops_per_second;
+}
+
+TEST(BPlusTreeTest, DISABLED_BPlusTreeThroughputBenchmark) {  // NOLINT
+  std::cout << "threads latching insert/s lookup/s remove/s" << std::endl;
+  for (size_t num_threads : {1, 2, 4, 8, 16}) {
+    for (bool optimistic : {false, true}) {
+      auto ops_per_second = BPlusTreeThroughputCall(num_threads, 32, optimistic);
+      std::cout << num_threads << " " << (optimistic ? "optimistic" : "pessimistic") << " "
+                << static_cast<uint64_t>(ops_per_second[0]) << " " << static_cast<uint64_t>(ops_per_second[1]) << " "
+                << static_cast<uint64_t>(ops_per_second[2]) << std::endl;
+    }
+  }
+}
+
+/**
+ * Run a read-mostly workload from num_threads threads: point lookups of a preloaded key range, with an insert of a new
+ * key every INSERT_INTERVAL operations.
+ * @return the operations per second
+ */
+auto BPlusTreeReadMostlyCall(size_t num_threads, bool optimistic_reads) -> double {
+  static constexpr int INSERT_INTERVAL = 20;
+  const int preloaded_keys = 40000;
+  const int ops_per_thread = 80000 / num_threads;
+
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManagerMemory(256 << 10);
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(1024, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 32, 32);
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < preloaded_keys; key++) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key));
+  }
+
+  b_plus_tree_optimistic_reads = optimistic_reads;
+  std::atomic<int> misses{0};
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      GenericKey<8> key;
+      std::vector<RID> result;
+      std::mt19937 rng(t);
+      for (int i = 0; i < ops_per_thread; i++) {
+        if (i % INSERT_INTERVAL == 0) {
+          int64_t new_key = preloaded_keys + static_cast<int64_t>(i) * num_threads + t;
+          key.SetFromInteger(new_key);
+          tree.Insert(key, RID(0, new_key));
+          continue;
+        }
+        int64_t lookup_key = rng() % preloaded_keys;
+        key.SetFromInteger(lookup_key);
+        result.clear();
+        if (!tree.GetValue(key, &result) || result[0].GetSlotNum() != lookup_key) {
+          misses++;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  EXPECT_EQ(0, misses);
+  b_plus_tree_optimistic_reads = true;
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  return static_cast<double>(ops_per_thread * num_threads) / seconds;
+}
+
+TEST(BPlusTreeTest, DISABLED_BPlusTreeReadMostlyBenchmark) {  // NOLINT
+  std::cout << "threads reads ops/s" << std::endl;
+  for (size_t num_threads : {1, 2, 4, 8, 16}) {
+    for (bool optimistic_reads : {false, true}) {
+      std::cout << num_threads << " " << (optimistic_reads ? "optimistic" : "latched") << " "
+                << static_cast<uint64_t>(BPlusTreeReadMostlyCall(num_threads, optimistic_reads)) << std::endl;
+    }
+  }
+}
+
+/**
+ * Look rows up through an index, fetching the leaf and then the heap page of each, in a buffer pool that holds only a
+ * part of the heap and the index.
+ * @return the buffer pool misses per lookup and the lookups per second
+ */
+auto IndexLookupCall(bool priorities) -> std::array<double, 2> {
+  const int num_rows = 16000;
+  const int num_lookups = 100000;
+
+  page_class_priorities = priorities;
+  auto *disk_manager = new DiskManagerMemory(256 << 10);
+  auto *bpm = new BufferPoolManagerInstance(192, disk_manager);
+  page_class_priorities = false;
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 32, 32);
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // Rows of about 100 bytes, so that the heap spans about as many pages as the leaves of the index.
+  Schema schema({Column("a", TypeId::BIGINT), Column("b", TypeId::VARCHAR, 100)});
+  Transaction txn(0);
+  TableHeap heap(bpm, nullptr, nullptr, &txn);
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < num_rows; key++) {
+    Tuple tuple({ValueFactory::GetBigIntValue(key), ValueFactory::GetVarcharValue(std::string(80, 'x'))}, &schema);
+    RID rid;
+    EXPECT_TRUE(heap.InsertTuple(tuple, &rid, &txn));
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid);
+  }
+
+  // Lookups are skewed towards the low keys, so that part of the working set fits into the pool.
+  std::mt19937 rng(0);
+  std::exponential_distribution<double> skew(4.0 / num_rows);
+  std::vector<RID> result;
+  Tuple tuple;
+  int errors = 0;
+  auto misses = bpm->GetStats().Get(BufferPoolCounter::FETCH_MISSES);
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_lookups; i++) {
+    auto key = static_cast<int64_t>(skew(rng)) % num_rows;
+    index_key.SetFromInteger(key);
+    result.clear();
+    if (!tree.GetValue(index_key, &result) || !heap.GetTuple(result[0], &tuple, &txn) ||
+        tuple.GetValue(&schema, 0).GetAs<int64_t>() != key) {
+      errors++;
+    }
+  }
+  auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  misses = bpm->GetStats().Get(BufferPoolCounter::FETCH_MISSES) - misses;
+  EXPECT_EQ(0, errors);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  return {static_cast<double>(misses) / num_lookups, num_lookups / seconds};
+}
+
+TEST(BPlusTreeTest, DISABLED_IndexLookupBenchmark) {  // NOLINT
+  std::cout << "page_class_priorities misses/lookup lookups/s" << std::endl;
+  for (bool priorities : {false, true}) {
+    auto [misses, lookups_per_second] = IndexLookupCall(priorities);
+    std::cout << (priorities ? "on" : "off") << " " << misses << " " << static_cast<uint64_t>(lookups_per_second)
+              << std::endl;
+  }
+}
+
 }  // namespace bustub
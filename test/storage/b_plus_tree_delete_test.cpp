@@ -12,9 +12,12 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <random>
 
 #include "buffer/buffer_pool_manager_instance.h"
+#include "common/config.h"
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
 #include "storage/index/b_plus_tree.h"
 #include "test_util.h"  // NOLINT
 
@@ -163,4 +166,155 @@ TEST(BPlusTreeTests, DeleteTest2) {
   remove("test.db");
   remove("test.log");
 }
+TEST(BPlusTreeTests, DeleteTest3) {
+  // Small nodes, so that removes redistribute and merge internal pages on several levels.
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  for (bool optimistic : {false, true}) {
+    b_plus_tree_optimistic_latching = optimistic;
+    auto *disk_manager = new DiskManager("test.db");
+    BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4);
+    GenericKey<8> index_key;
+    RID rid;
+    auto *transaction = new Transaction(0);
+
+    page_id_t page_id;
+    auto header_page = bpm->NewPage(&page_id);
+    (void)header_page;
+
+    std::vector<int64_t> keys;
+    for (int64_t key = 1; key <= 200; key++) {
+      keys.push_back(key);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+    for (auto key : keys) {
+      rid.Set(0, key);
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, rid, transaction);
+    }
+    // Scenario: remove the odd keys in random order.
+    for (auto key : keys) {
+      if (key % 2 == 1) {
+        index_key.SetFromInteger(key);
+        tree.Remove(index_key, transaction);
+      }
+    }
+
+    std::vector<RID> rids;
+    for (int64_t key = 1; key <= 200; key++) {
+      rids.clear();
+      index_key.SetFromInteger(key);
+      EXPECT_EQ(tree.GetValue(index_key, &rids), key % 2 == 0) << key;
+    }
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete transaction;
+    delete disk_manager;
+    delete bpm;
+    remove("test.db");
+    remove("test.log");
+  }
+  b_plus_tree_optimistic_latching = true;
+}
+
+TEST(BPlusTreeTests, DeleteFreesPagesTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManagerMemory(1 << 10);
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // create b+ tree with small nodes, so that removes merge nodes on every level
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 3);
+  GenericKey<8> index_key;
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int64_t num_keys = 200;
+  for (int64_t key = 1; key <= num_keys; key++) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, key)));
+  }
+  auto page_ids = tree.GetPageIds();
+
+  // Scenario: the pages of merged-away nodes and of collapsed roots are returned to the disk manager.
+  for (int64_t key = 1; key < num_keys; key++) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key);
+  }
+  auto remaining = tree.GetPageIds();
+  EXPECT_EQ(remaining.size(), 1);
+  for (auto old_page_id : page_ids) {
+    bool in_tree = std::find(remaining.begin(), remaining.end(), old_page_id) != remaining.end();
+    EXPECT_EQ(disk_manager->IsPageAllocated(old_page_id), in_tree) << old_page_id;
+  }
+  std::vector<RID> rids;
+  index_key.SetFromInteger(num_keys);
+  EXPECT_TRUE(tree.GetValue(index_key, &rids));
+
+  // Scenario: a growing tree reuses the freed pages.
+  for (int64_t key = 1; key < num_keys; key++) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, key)));
+  }
+  for (auto new_page_id : tree.GetPageIds()) {
+    EXPECT_NE(std::find(page_ids.begin(), page_ids.end(), new_page_id), page_ids.end()) << new_page_id;
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+}
+
+TEST(BPlusTreeTests, DeletePinnedPagesTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManagerMemory(1 << 10);
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 3);
+  GenericKey<8> index_key;
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int64_t num_keys = 20;
+  for (int64_t key = 1; key <= num_keys; key++) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, key)));
+  }
+  auto page_ids = tree.GetPageIds();
+  for (auto old_page_id : page_ids) {
+    ASSERT_NE(nullptr, bpm->FetchPage(old_page_id));
+  }
+
+  // Scenario: the pages of removed nodes that a reader still pins are not deleted under it.
+  for (int64_t key = 1; key < num_keys; key++) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key);
+  }
+  auto remaining = tree.GetPageIds();
+  EXPECT_EQ(remaining.size(), 1);
+  for (auto old_page_id : page_ids) {
+    EXPECT_TRUE(disk_manager->IsPageAllocated(old_page_id)) << old_page_id;
+  }
+
+  // Scenario: once they are unpinned, the next remove deletes them, even if it does not find its key.
+  for (auto old_page_id : page_ids) {
+    EXPECT_TRUE(bpm->UnpinPage(old_page_id, false));
+  }
+  index_key.SetFromInteger(num_keys + 1);
+  tree.Remove(index_key);
+  for (auto old_page_id : page_ids) {
+    bool in_tree = std::find(remaining.begin(), remaining.end(), old_page_id) != remaining.end();
+    EXPECT_EQ(disk_manager->IsPageAllocated(old_page_id), in_tree) << old_page_id;
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
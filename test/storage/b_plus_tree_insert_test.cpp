@@ -44,7 +44,9 @@ TEST(BPlusTreeTests, InsertTest1) {
   int64_t value = key & 0xFFFFFFFF;
   rid.Set(static_cast<int32_t>(key), value);
   index_key.SetFromInteger(key);
-  tree.Insert(index_key, rid, transaction);
+  // Scenario: the first insert creates the root leaf and succeeds; inserting its key again does not.
+  EXPECT_TRUE(tree.Insert(index_key, rid, transaction));
+  EXPECT_FALSE(tree.Insert(index_key, rid, transaction));
 
   auto root_page_id = tree.GetRootPageId();
   auto root_page = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(root_page_id)->GetData());
@@ -0,0 +1,175 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search_test.cpp
+//
+// Identification: test/storage/b_plus_tree_key_search_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/page/b_plus_tree_key_search.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+/** @return the instruction sets this CPU supports */
+static auto SupportedIsas() -> std::vector<KeySearchIsa> {
+  if (GetKeySearchIsa() == KeySearchIsa::AVX2) {
+    return {KeySearchIsa::AVX2, KeySearchIsa::SCALAR};
+  }
+  return {KeySearchIsa::SCALAR};
+}
+
+/** @return size sorted, distinct keys, negative and positive, in an array of key/value pairs of stride bytes */
+static auto MakeKeys(int size, size_t stride, std::mt19937 *rng) -> std::vector<char> {
+  std::vector<int32_t> values;
+  while (static_cast<int>(values.size()) < size) {
+    while (static_cast<int>(values.size()) < size) {
+      values.push_back(static_cast<int32_t>((*rng)()));
+    }
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+  }
+  std::vector<char> keys(size * stride + 1);
+  GenericKey<4> key;
+  for (int i = 0; i < size; i++) {
+    key.SetFromInteger(values[i]);
+    memcpy(keys.data() + i * stride, key.data_, sizeof(key.data_));
+  }
+  return keys;
+}
+
+TEST(KeySearchTest, LowerBoundTest) {
+  std::mt19937 rng(0);
+  GenericComparator<4> comparator(nullptr);
+  GenericKey<4> search_key;
+  GenericKey<4> key;
+  // Scenario: every instruction set finds the same lower bound as std::lower_bound, for the strides of leaf and
+  // internal pages of 4-byte keys and for one the AVX2 gather cannot take.
+  for (size_t stride : {size_t{8}, size_t{12}, size_t{5}}) {
+    for (int size : {0, 1, 3, 8, 31, 32, 33, 100, 339}) {
+      auto keys = MakeKeys(size, stride, &rng);
+      for (int probe = 0; probe < 200; probe++) {
+        if (probe % 2 == 0 && size > 0) {
+          memcpy(search_key.data_, keys.data() + (rng() % size) * stride, sizeof(search_key.data_));
+        } else {
+          search_key.SetFromInteger(static_cast<int32_t>(rng()));
+        }
+        int expected = 0;
+        for (; expected < size; expected++) {
+          memcpy(key.data_, keys.data() + expected * stride, sizeof(key.data_));
+          if (comparator(key, search_key) >= 0) {
+            break;
+          }
+        }
+        for (auto isa : SupportedIsas()) {
+          ASSERT_EQ(LowerBoundKey32(keys.data(), stride, size, search_key.data_, isa), expected)
+              << "isa " << static_cast<int>(isa) << " stride " << stride << " size " << size;
+        }
+      }
+    }
+  }
+}
+
+TEST(KeySearchTest, IntegerTreeTest) {
+  // Scenario: a tree of 4-byte keys, whose pages search with LowerBoundKey32, finds what was inserted.
+  auto key_schema = ParseCreateStatement("a integer");
+  GenericComparator<4> comparator(key_schema.get());
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  BPlusTree<GenericKey<4>, RID, GenericComparator<4>> tree("foo_pk", bpm, comparator, 40, 40);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  std::vector<int32_t> keys;
+  for (int32_t key = -1000; key < 1000; key += 2) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  GenericKey<4> index_key;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, key)));
+  }
+  std::vector<RID> rids;
+  for (int32_t key = -1001; key <= 1001; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    bool inserted = key % 2 == 0 && key < 1000;
+    ASSERT_EQ(tree.GetValue(index_key, &rids), inserted) << key;
+    if (inserted) {
+      EXPECT_EQ(rids[0].GetSlotNum(), static_cast<uint32_t>(key));
+    }
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(KeySearchTest, DISABLED_KeySearchBenchmark) {
+  const size_t stride = sizeof(std::pair<GenericKey<4>, RID>);
+  const int max_size = static_cast<int>((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / stride);
+  const int lookups = 1 << 20;
+  std::mt19937 rng(0);
+  GenericComparator<4> comparator(nullptr);
+
+  std::cout << "fill keys std::lower_bound_ns scalar_ns avx2_ns" << std::endl;
+  for (int fill_percent : {10, 25, 50, 75, 100}) {
+    int size = max_size * fill_percent / 100;
+    auto keys = MakeKeys(size, stride, &rng);
+    const auto *items = reinterpret_cast<const std::pair<GenericKey<4>, RID> *>(keys.data());
+    std::vector<GenericKey<4>> search_keys(1024);
+    for (auto &search_key : search_keys) {
+      search_key.SetFromInteger(static_cast<int32_t>(rng()));
+    }
+
+    // Time the lookups with the comparator, as pages searched before, and with every supported instruction set.
+    auto time_ns = [&](auto search) {
+      int64_t checksum = 0;
+      auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < lookups; i++) {
+        checksum += search(search_keys[i % search_keys.size()]);
+      }
+      auto dur = std::chrono::steady_clock::now() - start;
+      EXPECT_GE(checksum, 0);
+      return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(dur).count()) / lookups;
+    };
+    std::cout << fill_percent << "% " << size << " " << time_ns([&](const GenericKey<4> &search_key) {
+      auto iter = std::lower_bound(items, items + size, search_key, [&](const auto &item, const auto &key) {
+        return comparator(item.first, key) < 0;
+      });
+      return iter - items;
+    });
+    for (auto isa : {KeySearchIsa::SCALAR, KeySearchIsa::AVX2}) {
+      auto supported = SupportedIsas();
+      if (std::find(supported.begin(), supported.end(), isa) == supported.end()) {
+        std::cout << " -";
+        continue;
+      }
+      std::cout << " " << time_ns([&](const GenericKey<4> &search_key) {
+        return LowerBoundKey32(keys.data(), stride, size, search_key.data_, isa);
+      });
+    }
+    std::cout << std::endl;
+  }
+}
+
+}  // namespace bustub
@@ -10,11 +10,22 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <sys/stat.h>
 #include <cstring>
+#include <future>  // NOLINT
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "common/exception.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_compressed.h"
+#include "storage/disk/disk_manager_mmap.h"
+#include "storage/disk/disk_manager_posix.h"
+#include "storage/disk/disk_manager_uring.h"
+#include "storage/disk/lz_codec.h"
 
 namespace bustub {
 
@@ -24,12 +35,16 @@ class DiskManagerTest : public ::testing::Test {
   void SetUp() override {
     remove("test.db");
     remove("test.log");
+    remove("test.fsm");
+    remove("test.pmap");
   }
 
   // This function is called after every test.
   void TearDown() override {
     remove("test.db");
     remove("test.log");
+    remove("test.fsm");
+    remove("test.pmap");
   };
 };
 
@@ -72,7 +87,408 @@ TEST_F(DiskManagerTest, ReadWriteLogTest) {
   dm.ShutDown();
 }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, PosixReadWritePageTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  char zeroes[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  std::strncpy(data, "A test string.", sizeof(data));
+  {
+    auto dm = DiskManagerPosix(db_file);
+
+    // Pages beyond the end of the file read as zeroes.
+    std::memset(buf, 'x', sizeof(buf));
+    dm.ReadPage(0, buf);
+    EXPECT_EQ(std::memcmp(buf, zeroes, sizeof(buf)), 0);
+
+    dm.WritePage(0, data);
+    dm.ReadPage(0, buf);
+    EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+
+    std::memset(buf, 0, sizeof(buf));
+    dm.WritePage(5, data);
+    dm.ReadPage(5, buf);
+    EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+
+    // The hole before page 5 reads as zeroes too.
+    dm.ReadPage(3, buf);
+    EXPECT_EQ(std::memcmp(buf, zeroes, sizeof(buf)), 0);
+    EXPECT_EQ(2, dm.GetNumWrites());
+
+    dm.ShutDown();
+  }
+
+  // The pages are still there once the file is reopened.
+  auto dm = DiskManagerPosix(db_file);
+  dm.ReadPage(5, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, PosixDirectIOTest) {
+  alignas(BUSTUB_PAGE_SIZE) char aligned[BUSTUB_PAGE_SIZE] = {0};
+  char unaligned_storage[BUSTUB_PAGE_SIZE + 1] = {0};
+  char *unaligned = unaligned_storage + 1;
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  std::strncpy(data, "A direct string.", sizeof(data));
+  auto dm = DiskManagerPosix(db_file, true);
+
+  // Aligned buffers go straight to the file; unaligned ones take the bounce buffer.
+  std::memcpy(aligned, data, sizeof(data));
+  dm.WritePage(0, aligned);
+  std::memcpy(unaligned, data, sizeof(data));
+  dm.WritePage(1, unaligned);
+
+  std::memset(aligned, 0, sizeof(aligned));
+  dm.ReadPage(1, aligned);
+  EXPECT_EQ(std::memcmp(aligned, data, sizeof(data)), 0);
+  std::memset(unaligned, 0, BUSTUB_PAGE_SIZE);
+  dm.ReadPage(0, unaligned);
+  EXPECT_EQ(std::memcmp(unaligned, data, sizeof(data)), 0);
+
+  // So does a batch mixing both.
+  DiskManagerUring uring_dm(db_file, DISK_URING_QUEUE_DEPTH, true);
+  EXPECT_EQ(dm.IsDirectIO(), uring_dm.IsDirectIO());
+  std::memset(aligned, 0, sizeof(aligned));
+  std::memset(unaligned, 0, BUSTUB_PAGE_SIZE);
+  std::vector<DiskRequest> requests(2);
+  requests[0].data_ = aligned;
+  requests[0].page_id_ = 0;
+  requests[1].data_ = unaligned;
+  requests[1].page_id_ = 1;
+  std::vector<std::future<bool>> futures;
+  for (auto &request : requests) {
+    request.is_write_ = false;
+    futures.push_back(request.callback_.get_future());
+  }
+  uring_dm.SubmitRequests(&requests);
+  for (auto &future : futures) {
+    EXPECT_TRUE(future.get());
+  }
+  EXPECT_EQ(std::memcmp(aligned, data, sizeof(data)), 0);
+  EXPECT_EQ(std::memcmp(unaligned, data, sizeof(data)), 0);
+
+  uring_dm.ShutDown();
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, PosixConcurrentReadWriteTest) {
+  const int num_threads = 4;
+  const int pages_per_thread = 64;
+  std::string db_file("test.db");
+  auto dm = DiskManagerPosix(db_file);
+
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&dm, tid] {
+      char data[BUSTUB_PAGE_SIZE];
+      char buf[BUSTUB_PAGE_SIZE];
+      for (int i = 0; i < pages_per_thread; i++) {
+        page_id_t page_id = i * num_threads + tid;
+        std::memset(data, 'a' + tid, sizeof(data));
+        snprintf(data, sizeof(data), "%d", page_id);
+        dm.WritePage(page_id, data);
+        dm.ReadPage(page_id, buf);
+        EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  dm.Sync();
+
+  char buf[BUSTUB_PAGE_SIZE];
+  for (page_id_t page_id = 0; page_id < num_threads * pages_per_thread; page_id++) {
+    dm.ReadPage(page_id, buf);
+    EXPECT_EQ(std::to_string(page_id), std::string(buf));
+    EXPECT_EQ('a' + page_id % num_threads, buf[BUSTUB_PAGE_SIZE - 1]);
+  }
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, UringSubmitRequestsTest) {
+  const int num_pages = 300;
+  std::string db_file("test.db");
+  // A queue depth smaller than the batch makes the submitter wait for completions.
+  auto dm = DiskManagerUring(db_file, 32);
+  std::vector<char> data(num_pages * BUSTUB_PAGE_SIZE);
+  std::vector<char> buf(num_pages * BUSTUB_PAGE_SIZE, 'x');
+
+  std::vector<DiskRequest> requests;
+  std::vector<std::future<bool>> results;
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    char *page_data = data.data() + page_id * BUSTUB_PAGE_SIZE;
+    std::memset(page_data, 'a' + page_id % 26, BUSTUB_PAGE_SIZE);
+    requests.push_back(DiskRequest{true, page_data, page_id, std::promise<bool>()});
+    results.push_back(requests.back().callback_.get_future());
+  }
+  dm.SubmitRequests(&requests);
+  for (auto &result : results) {
+    EXPECT_TRUE(result.get());
+  }
+  EXPECT_EQ(num_pages, dm.GetNumWrites());
+
+  // Read the pages back in one batch, together with one page beyond the end of the file.
+  requests.clear();
+  results.clear();
+  for (page_id_t page_id = 0; page_id <= num_pages; page_id++) {
+    char *page_data = page_id < num_pages ? buf.data() + page_id * BUSTUB_PAGE_SIZE : data.data();
+    requests.push_back(DiskRequest{false, page_data, page_id, std::promise<bool>()});
+    results.push_back(requests.back().callback_.get_future());
+  }
+  dm.SubmitRequests(&requests);
+  for (auto &result : results) {
+    EXPECT_TRUE(result.get());
+  }
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    EXPECT_EQ('a' + page_id % 26, buf[page_id * BUSTUB_PAGE_SIZE]);
+    EXPECT_EQ('a' + page_id % 26, buf[(page_id + 1) * BUSTUB_PAGE_SIZE - 1]);
+  }
+  EXPECT_EQ(0, data[0]);
+  EXPECT_EQ(0, data[BUSTUB_PAGE_SIZE - 1]);
+
+  // The synchronous path sees the pages written through the ring.
+  char page[BUSTUB_PAGE_SIZE];
+  dm.ReadPage(num_pages - 1, page);
+  EXPECT_EQ('a' + (num_pages - 1) % 26, page[0]);
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, FreePageMapTest) {
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  {
+    auto dm = DiskManagerPosix(db_file);
+    for (page_id_t page_id = 0; page_id < 6; page_id++) {
+      EXPECT_EQ(page_id, dm.AllocatePage());
+      dm.WritePage(page_id, data);
+    }
+
+    // Allocations only reach the map file when it is synced.
+    struct stat fsm_stat;
+    ASSERT_EQ(0, stat("test.fsm", &fsm_stat));
+    EXPECT_EQ(0, fsm_stat.st_size);
+    dm.Sync();
+    ASSERT_EQ(0, stat("test.fsm", &fsm_stat));
+    EXPECT_EQ(1, fsm_stat.st_size);
+
+    // Deallocated pages are reused lowest first, before the file grows.
+    dm.DeallocatePage(3);
+    dm.DeallocatePage(1);
+    dm.DeallocatePage(1);
+    EXPECT_FALSE(dm.IsPageAllocated(1));
+    EXPECT_EQ(1, dm.AllocatePage());
+    EXPECT_EQ(3, dm.AllocatePage());
+    EXPECT_EQ(6, dm.AllocatePage());
+
+    // A shard only gets the page ids that map to it.
+    dm.DeallocatePage(2);
+    dm.DeallocatePage(5);
+    EXPECT_EQ(5, dm.AllocatePage(2, 1));
+    EXPECT_EQ(7, dm.AllocatePage(2, 1));
+    EXPECT_EQ(2, dm.AllocatePage(2, 0));
+    dm.DeallocatePage(7);
+    dm.DeallocatePage(6);
+    dm.ShutDown();
+  }
+
+  // The map survives a restart. Pages 6 and 7 were never written, so there is nothing to truncate yet.
+  auto dm = DiskManagerPosix(db_file);
+  for (page_id_t page_id = 0; page_id < 6; page_id++) {
+    EXPECT_TRUE(dm.IsPageAllocated(page_id));
+  }
+  EXPECT_FALSE(dm.IsPageAllocated(6));
+  EXPECT_EQ(0, dm.Vacuum());
+
+  // Vacuum truncates the free pages at the end of the file, and only those.
+  dm.DeallocatePage(5);
+  dm.DeallocatePage(4);
+  dm.DeallocatePage(1);
+  EXPECT_EQ(2, dm.Vacuum());
+  struct stat stat_buf;
+  ASSERT_EQ(0, stat(db_file.c_str(), &stat_buf));
+  EXPECT_EQ(4 * BUSTUB_PAGE_SIZE, stat_buf.st_size);
+  EXPECT_EQ(1, dm.AllocatePage());
+  dm.ShutDown();
+
+  // A new database file starts with an empty map, whatever the map file says.
+  remove(db_file.c_str());
+  auto new_dm = DiskManager(db_file);
+  EXPECT_FALSE(new_dm.IsPageAllocated(0));
+  EXPECT_EQ(0, new_dm.AllocatePage());
+  new_dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST(LzCodecTest, RoundTripTest) {
+  std::mt19937 gen(15445);
+  std::vector<std::vector<char>> inputs;
+  inputs.emplace_back(BUSTUB_PAGE_SIZE, 0);
+  inputs.emplace_back(BUSTUB_PAGE_SIZE);
+  for (auto &byte : inputs.back()) {
+    byte = static_cast<char>(gen());
+  }
+  inputs.emplace_back(BUSTUB_PAGE_SIZE);
+  for (size_t i = 0; i < inputs.back().size(); i++) {
+    inputs.back()[i] = "abcab"[gen() % 5];
+  }
+  inputs.emplace_back(std::vector<char>{'s', 'h', 'o', 'r', 't'});
+
+  std::vector<char> compressed(2 * BUSTUB_PAGE_SIZE);
+  std::vector<char> decompressed(BUSTUB_PAGE_SIZE);
+  for (const auto &input : inputs) {
+    size_t size = LzCodec::Compress(input.data(), input.size(), compressed.data(), compressed.size());
+    ASSERT_GT(size, 0U);
+    EXPECT_EQ(input.size(), LzCodec::Decompress(compressed.data(), size, decompressed.data(), decompressed.size()));
+    EXPECT_EQ(0, memcmp(input.data(), decompressed.data(), input.size()));
+  }
+  // Zeroes compress well; random bytes do not fit into less than their own size.
+  EXPECT_LT(LzCodec::Compress(inputs[0].data(), BUSTUB_PAGE_SIZE, compressed.data(), compressed.size()), 64U);
+  EXPECT_EQ(0U, LzCodec::Compress(inputs[1].data(), BUSTUB_PAGE_SIZE, compressed.data(), BUSTUB_PAGE_SIZE));
+
+  // A match reaching before the start of the output is rejected, and a truncated block does not yield a whole page.
+  const char bad_offset[] = {0x10, 'a', 0x05, 0x00};
+  EXPECT_EQ(0U, LzCodec::Decompress(bad_offset, sizeof(bad_offset), decompressed.data(), decompressed.size()));
+  size_t size = LzCodec::Compress(inputs[2].data(), BUSTUB_PAGE_SIZE, compressed.data(), compressed.size());
+  EXPECT_NE(static_cast<size_t>(BUSTUB_PAGE_SIZE),
+            LzCodec::Decompress(compressed.data(), size / 2, decompressed.data(), decompressed.size()));
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, CompressedReadWritePageTest) {
+  std::mt19937 gen(15445);
+  char rows[BUSTUB_PAGE_SIZE] = {0};
+  for (int offset = 0; offset < BUSTUB_PAGE_SIZE; offset += 16) {
+    snprintf(rows + offset, 16, "row %d", offset / 16);
+  }
+  char random[BUSTUB_PAGE_SIZE];
+  for (auto &byte : random) {
+    byte = static_cast<char>(gen());
+  }
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  struct stat stat_buf;
+  off_t file_size;
+  {
+    auto dm = DiskManagerCompressed(db_file);
+    for (page_id_t page_id = 0; page_id < 3; page_id++) {
+      EXPECT_EQ(page_id, dm.AllocatePage());
+    }
+    // Only opted-in pages that shrink are stored compressed.
+    dm.SetPageCompressed(0, true);
+    dm.SetPageCompressed(2, true);
+    dm.WritePage(0, rows);
+    dm.WritePage(1, rows);
+    dm.WritePage(2, random);
+    dm.ReadPage(0, buf);
+    EXPECT_EQ(0, memcmp(buf, rows, BUSTUB_PAGE_SIZE));
+    dm.ReadPage(1, buf);
+    EXPECT_EQ(0, memcmp(buf, rows, BUSTUB_PAGE_SIZE));
+    dm.ReadPage(2, buf);
+    EXPECT_EQ(0, memcmp(buf, random, BUSTUB_PAGE_SIZE));
+
+    auto stats = dm.GetCompressionStats();
+    EXPECT_EQ(3U, stats.pages_written_);
+    EXPECT_EQ(1U, stats.compressed_pages_written_);
+    EXPECT_GT(stats.GetCompressionRatio(), 1.0);
+    EXPECT_GT(stats.GetReadSavings(), 0.0);
+    EXPECT_LT(dm.GetNumFileBytes(), 3U * BUSTUB_PAGE_SIZE);
+
+    // Page 0 compresses to a different size in as many sectors, and is overwritten in place.
+    char changed_rows[BUSTUB_PAGE_SIZE];
+    memcpy(changed_rows, rows, BUSTUB_PAGE_SIZE);
+    snprintf(changed_rows, 16, "changed row 0");
+    file_size = static_cast<off_t>(dm.GetNumFileBytes());
+    dm.WritePage(0, changed_rows);
+    EXPECT_EQ(file_size, static_cast<off_t>(dm.GetNumFileBytes()));
+    dm.ReadPage(0, buf);
+    EXPECT_EQ(0, memcmp(buf, changed_rows, BUSTUB_PAGE_SIZE));
+
+    // Page 0 no longer compresses and moves to a larger extent. Its old extent and page 1's are merged and reused.
+    dm.WritePage(0, random);
+    dm.DeallocatePage(1);
+    file_size = static_cast<off_t>(dm.GetNumFileBytes());
+    EXPECT_EQ(1, dm.AllocatePage());
+    dm.WritePage(1, random);
+    EXPECT_EQ(file_size, static_cast<off_t>(dm.GetNumFileBytes()));
+    dm.ShutDown();
+  }
+
+  // The indirection map survives a restart.
+  auto dm = DiskManagerCompressed(db_file);
+  for (page_id_t page_id = 0; page_id < 3; page_id++) {
+    dm.ReadPage(page_id, buf);
+    EXPECT_EQ(0, memcmp(buf, random, BUSTUB_PAGE_SIZE));
+  }
+  dm.ReadPage(3, buf);
+  EXPECT_EQ(0, buf[0]);
+
+  // Page 0 is stored last; Vacuum truncates its extent once it is deallocated.
+  dm.DeallocatePage(0);
+  EXPECT_EQ(1U, dm.Vacuum());
+  ASSERT_EQ(0, stat(db_file.c_str(), &stat_buf));
+  EXPECT_EQ(file_size - BUSTUB_PAGE_SIZE, stat_buf.st_size);
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, MmapReadPageTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  char zeroes[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  std::strncpy(data, "A test string.", sizeof(data));
+  {
+    auto dm = DiskManagerPosix(db_file);
+    dm.WritePage(0, data);
+    dm.WritePage(2, data);
+    dm.ShutDown();
+  }
+
+  auto dm = DiskManagerMmap(db_file);
+  EXPECT_TRUE(dm.IsReadOnly());
+  EXPECT_EQ(3, dm.GetNumPages());
+
+  // Scenario: pages are read from the mapping, either copied out or in place.
+  dm.ReadPage(2, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+  ASSERT_NE(nullptr, dm.MapPage(0));
+  EXPECT_EQ(std::memcmp(dm.MapPage(0), data, sizeof(data)), 0);
+  EXPECT_EQ(std::memcmp(dm.MapPage(1), zeroes, sizeof(zeroes)), 0);
+  EXPECT_TRUE(dm.IsPageAllocated(2));
+
+  // Scenario: pages beyond the end of the file are not mapped and read as zeroes.
+  EXPECT_EQ(nullptr, dm.MapPage(3));
+  EXPECT_FALSE(dm.IsPageAllocated(3));
+  std::memset(buf, 'x', sizeof(buf));
+  dm.ReadPage(3, buf);
+  EXPECT_EQ(std::memcmp(buf, zeroes, sizeof(buf)), 0);
+
+  // Scenario: everything that would change the file is rejected.
+  EXPECT_THROW(dm.WritePage(0, data), Exception);
+  EXPECT_THROW(dm.DeallocatePage(0), Exception);
+  EXPECT_THROW(dm.Vacuum(), Exception);
+  dm.ShutDown();
+  EXPECT_EQ(nullptr, dm.MapPage(0));
+
+  // Scenario: the file must exist, it is never created.
+  remove(db_file.c_str());
+  EXPECT_THROW(DiskManagerMmap{db_file}, Exception);
+}
+
 // NOLINTNEXTLINE
 TEST_F(DiskManagerTest, ThrowBadFileTest) { EXPECT_THROW(DiskManager("dev/null\\/foo/bar/baz/test.db"), Exception); }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, PosixThrowBadFileTest) {
+  EXPECT_THROW(DiskManagerPosix("dev/null\\/foo/bar/baz/test.db"), Exception);
+}
+
 }  // namespace bustub
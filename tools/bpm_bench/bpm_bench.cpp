@@ -0,0 +1,352 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/access_trace.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "common/exception.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_manager_posix.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+static const size_t BUSTUB_BPM_BENCH_PAGES = 2048;
+static const size_t BUSTUB_BPM_BENCH_FRAMES = 512;
+
+/** Wraps a disk manager and counts the pages read from it, i.e. the buffer pool misses. */
+class CountingDiskManager : public bustub::DiskManager {
+ public:
+  explicit CountingDiskManager(std::unique_ptr<bustub::DiskManager> disk_manager)
+      : disk_manager_(std::move(disk_manager)) {}
+
+  void ShutDown() override { disk_manager_->ShutDown(); }
+
+  void WritePage(bustub::page_id_t page_id, const char *page_data) override {
+    disk_manager_->WritePage(page_id, page_data);
+  }
+
+  void ReadPage(bustub::page_id_t page_id, char *page_data) override {
+    read_cnt_ += 1;
+    disk_manager_->ReadPage(page_id, page_data);
+  }
+
+  void Sync() override { disk_manager_->Sync(); }
+
+  void SubmitRequests(std::vector<bustub::DiskRequest> *requests) override {
+    for (const auto &request : *requests) {
+      read_cnt_ += request.is_write_ ? 0 : 1;
+    }
+    disk_manager_->SubmitRequests(requests);
+  }
+
+  std::atomic<uint64_t> read_cnt_{0};
+
+ private:
+  std::unique_ptr<bustub::DiskManager> disk_manager_;
+};
+
+/** @return the size of the kernel page cache in KiB, or 0 if /proc/meminfo is not available */
+auto PageCacheKb() -> int64_t {
+  std::ifstream meminfo("/proc/meminfo");
+  std::string key;
+  int64_t value;
+  std::string unit;
+  while (meminfo >> key >> value >> unit) {
+    if (key == "Cached:") {
+      return value;
+    }
+  }
+  return 0;
+}
+
+struct BpmTotalMetrics {
+  std::atomic<uint64_t> op_cnt_{0};
+  std::atomic<uint64_t> miss_cnt_{0};
+  uint64_t start_time_{0};
+  uint64_t start_read_cnt_{0};
+  int64_t start_page_cache_kb_{0};
+  bustub::VictimCacheStats start_victim_cache_stats_;
+
+  void Begin(const CountingDiskManager &disk_manager, bustub::BufferPoolManager *bpm) {
+    start_time_ = ClockMs();
+    start_read_cnt_ = disk_manager.read_cnt_;
+    start_page_cache_kb_ = PageCacheKb();
+    start_victim_cache_stats_ = bpm->GetVictimCacheStats();
+  }
+
+  void Report(size_t num_threads, size_t num_instances, const std::string &replacer,
+              const CountingDiskManager &disk_manager, bustub::BufferPoolManager *bpm) {
+    auto now = ClockMs();
+    auto elsped = now - start_time_;
+    auto ops_per_sec = op_cnt_ / static_cast<double>(elsped) * 1000;
+    auto reads = disk_manager.read_cnt_ - start_read_cnt_;
+    auto hit_ratio = op_cnt_ == 0 ? 0.0 : 1.0 - static_cast<double>(reads) / static_cast<double>(op_cnt_);
+
+    fmt::print("<<< BEGIN\n");
+    fmt::print("threads: {}\n", num_threads);
+    fmt::print("instances: {}\n", num_instances);
+    fmt::print("replacer: {}\n", replacer);
+    fmt::print("ops: {}\n", ops_per_sec);
+    fmt::print("hit_ratio: {}\n", hit_ratio);
+    fmt::print("page_cache_delta_kb: {}\n", PageCacheKb() - start_page_cache_kb_);
+    fmt::print("failed: {}\n", miss_cnt_.load());
+    if (bustub::victim_cache_size > 0) {
+      auto stats = bpm->GetVictimCacheStats();
+      auto lookups = stats.lookups_ - start_victim_cache_stats_.lookups_;
+      auto hits = stats.hits_ - start_victim_cache_stats_.hits_;
+      fmt::print("victim_cache_hit_ratio: {}\n", lookups == 0 ? 0.0 : static_cast<double>(hits) / lookups);
+      fmt::print("victim_cache_promotions: {}\n", hits);
+      fmt::print("victim_cache_demotions: {}\n", stats.demotions_ - start_victim_cache_stats_.demotions_);
+      fmt::print("victim_cache_compression_ratio: {}\n", stats.GetCompressionRatio());
+    }
+    fmt::print(">>> END\n");
+  }
+};
+
+auto ParseBool(const std::string &str) -> bool {
+  if (str == "no" || str == "false") {
+    return false;
+  }
+  if (str == "yes" || str == "true") {
+    return true;
+  }
+  throw bustub::Exception(fmt::format("unexpected arg: {}", str));
+}
+
+auto ParseReplacerType(const std::string &str) -> bustub::ReplacerType {
+  if (str == "lru-k") {
+    return bustub::ReplacerType::LRU_K;
+  }
+  if (str == "arc") {
+    return bustub::ReplacerType::ARC;
+  }
+  if (str == "2q") {
+    return bustub::ReplacerType::TWO_Q;
+  }
+  throw bustub::Exception(fmt::format("unexpected replacer: {}", str));
+}
+
+/**
+ * Fetch and unpin pages from `num_threads` threads for `duration_ms` milliseconds. Without `mixed`, pages are picked
+ * uniformly at random. With `mixed`, 80% of the fetches go to a hot eighth of the pages and the rest continue a
+ * sequential scan over all pages, which is the pattern that separates scan-resistant policies from plain recency.
+ */
+void RunFetchWorkload(bustub::BufferPoolManager *bpm, const std::vector<bustub::page_id_t> &page_ids,
+                      size_t num_threads, uint64_t duration_ms, bool mixed, const CountingDiskManager &disk_manager,
+                      BpmTotalMetrics *total_metrics) {
+  std::vector<std::thread> threads;
+  total_metrics->Begin(disk_manager, bpm);
+
+  for (size_t thread_id = 0; thread_id < num_threads; thread_id++) {
+    threads.emplace_back([bpm, &page_ids, total_metrics, duration_ms, mixed, thread_id] {
+      std::random_device r;
+      std::default_random_engine gen(r());
+      std::uniform_int_distribution<size_t> page_dist(0, page_ids.size() - 1);
+      std::uniform_int_distribution<size_t> hot_page_dist(0, std::max<size_t>(1, page_ids.size() / 8) - 1);
+      std::uniform_int_distribution<size_t> percent_dist(0, 99);
+      size_t scan_cursor = thread_id * page_ids.size() / 4;
+      uint64_t op_cnt = 0;
+      uint64_t miss_cnt = 0;
+      auto start_time = ClockMs();
+
+      while (ClockMs() - start_time < duration_ms) {
+        size_t page_idx;
+        if (!mixed) {
+          page_idx = page_dist(gen);
+        } else if (percent_dist(gen) < 80) {
+          page_idx = hot_page_dist(gen);
+        } else {
+          page_idx = scan_cursor++ % page_ids.size();
+        }
+        auto page_id = page_ids[page_idx];
+        auto *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          miss_cnt += 1;
+          continue;
+        }
+        if (page->GetPageId() != page_id) {
+          fmt::print("unexpected page {} when fetching {}\n", page->GetPageId(), page_id);
+          exit(1);
+        }
+        bpm->UnpinPage(page_id, false);
+        op_cnt += 1;
+      }
+
+      total_metrics->op_cnt_ += op_cnt;
+      total_metrics->miss_cnt_ += miss_cnt;
+    });
+  }
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-bpm-bench");
+  program.add_argument("--duration").help("run bpm bench for n milliseconds");
+  program.add_argument("--threads").help("number of worker threads");
+  program.add_argument("--instances").help("number of buffer pool instances (1 = BufferPoolManagerInstance)");
+  program.add_argument("--frames").help("total number of frames, split evenly across the instances");
+  program.add_argument("--pages").help("number of distinct pages accessed by the workers");
+  program.add_argument("--sweep").help("run with 1, 2, 4, ... up to --threads threads");
+  program.add_argument("--replacer").help("replacement policy: lru-k, arc or 2q");
+  program.add_argument("--workload").help("uniform: random pages; mixed: hot pages interleaved with a scan");
+  program.add_argument("--trace").help("record the page accesses to this file, for bustub-replacer-sim");
+  program.add_argument("--disk").help("memory: in-memory pages; file: buffered pread/pwrite; direct: O_DIRECT");
+  program.add_argument("--file").help("database file for --disk file and --disk direct");
+  program.add_argument("--huge-pages").help("back the frames with huge pages");
+  program.add_argument("--victim-cache-mb").help("keep clean victims compressed in this many MiB of memory");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  uint64_t duration_ms = 5000;
+  size_t num_threads = 4;
+  size_t num_instances = 1;
+  size_t num_frames = BUSTUB_BPM_BENCH_FRAMES;
+  size_t num_pages = BUSTUB_BPM_BENCH_PAGES;
+
+  if (program.present("--duration")) {
+    duration_ms = std::stoi(program.get("--duration"));
+  }
+  if (program.present("--threads")) {
+    num_threads = std::stoi(program.get("--threads"));
+  }
+  if (program.present("--instances")) {
+    num_instances = std::stoi(program.get("--instances"));
+  }
+  if (program.present("--frames")) {
+    num_frames = std::stoi(program.get("--frames"));
+  }
+  if (program.present("--pages")) {
+    num_pages = std::stoi(program.get("--pages"));
+  }
+  bool sweep = false;
+  if (program.present("--sweep")) {
+    sweep = ParseBool(program.get("--sweep"));
+  }
+  std::string replacer = "lru-k";
+  if (program.present("--replacer")) {
+    replacer = program.get("--replacer");
+  }
+  auto replacer_type = ParseReplacerType(replacer);
+  bool mixed = false;
+  if (program.present("--workload")) {
+    auto workload = program.get("--workload");
+    if (workload != "uniform" && workload != "mixed") {
+      throw bustub::Exception(fmt::format("unexpected workload: {}", workload));
+    }
+    mixed = workload == "mixed";
+  }
+  std::string disk = "memory";
+  if (program.present("--disk")) {
+    disk = program.get("--disk");
+    if (disk != "memory" && disk != "file" && disk != "direct") {
+      throw bustub::Exception(fmt::format("unexpected disk: {}", disk));
+    }
+  }
+  std::string db_file = "bpm_bench.db";
+  if (program.present("--file")) {
+    db_file = program.get("--file");
+  }
+  if (program.present("--huge-pages")) {
+    bustub::buffer_pool_huge_pages = ParseBool(program.get("--huge-pages"));
+  }
+  if (program.present("--victim-cache-mb")) {
+    bustub::victim_cache_size = static_cast<size_t>(std::stoi(program.get("--victim-cache-mb"))) << 20;
+  }
+  if (num_instances == 0 || num_frames < num_instances * num_threads) {
+    std::cerr << "every instance needs at least one frame per thread" << std::endl;
+    return 1;
+  }
+
+  std::unique_ptr<bustub::DiskManager> backing_disk_manager;
+  if (disk == "memory") {
+    backing_disk_manager = std::make_unique<bustub::DiskManagerUnlimitedMemory>();
+  } else {
+    // Start from an empty file, so that no page of a previous run is in the page cache.
+    remove(db_file.c_str());
+    auto posix_disk_manager = std::make_unique<bustub::DiskManagerPosix>(db_file, disk == "direct");
+    if (disk == "direct" && !posix_disk_manager->IsDirectIO()) {
+      std::cerr << "x: O_DIRECT is not supported here, using buffered I/O" << std::endl;
+    }
+    backing_disk_manager = std::move(posix_disk_manager);
+  }
+  auto disk_manager = std::make_unique<CountingDiskManager>(std::move(backing_disk_manager));
+  // Declared before the buffer pool, which records to it until it is destroyed.
+  std::unique_ptr<bustub::AccessTraceWriter> trace;
+  if (program.present("--trace")) {
+    trace = std::make_unique<bustub::AccessTraceWriter>(program.get("--trace"));
+  }
+  std::unique_ptr<bustub::BufferPoolManager> bpm;
+  if (num_instances > 1) {
+    auto parallel_bpm = std::make_unique<bustub::ParallelBufferPoolManager>(
+        num_instances, num_frames / num_instances, disk_manager.get(), bustub::LRUK_REPLACER_K, nullptr, replacer_type);
+    parallel_bpm->SetAccessTrace(trace.get());
+    bpm = std::move(parallel_bpm);
+  } else {
+    auto bpm_instance = std::make_unique<bustub::BufferPoolManagerInstance>(
+        num_frames, disk_manager.get(), bustub::LRUK_REPLACER_K, nullptr, replacer_type);
+    bpm_instance->SetAccessTrace(trace.get());
+    bpm = std::move(bpm_instance);
+  }
+
+  std::cerr << "x: " << num_threads << " threads, " << num_instances << " instances, " << bpm->GetPoolSize()
+            << " frames, " << num_pages << " pages, " << replacer << " replacer, " << disk << " disk" << std::endl;
+
+  // initialize data
+  std::cerr << "x: initialize data" << std::endl;
+  std::vector<bustub::page_id_t> page_ids;
+  for (size_t i = 0; i < num_pages; i++) {
+    bustub::page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    if (page == nullptr) {
+      throw bustub::Exception("cannot allocate page");
+    }
+    snprintf(page->GetData(), bustub::BUSTUB_PAGE_SIZE, "%d", page_id);
+    bpm->UnpinPage(page_id, true);
+    page_ids.push_back(page_id);
+  }
+
+  // With --pages no larger than --frames every fetch after warm-up is a page-table hit.
+  for (size_t threads = sweep ? 1 : num_threads; threads <= num_threads; threads *= 2) {
+    std::cerr << "x: benchmark start with " << threads << " threads" << std::endl;
+    BpmTotalMetrics total_metrics;
+    RunFetchWorkload(bpm.get(), page_ids, threads, duration_ms, mixed, *disk_manager, &total_metrics);
+    total_metrics.Report(threads, num_instances, replacer, *disk_manager, bpm.get());
+  }
+
+  bpm.reset();
+  disk_manager->ShutDown();
+  if (disk != "memory") {
+    remove(db_file.c_str());
+    remove((db_file.substr(0, db_file.rfind('.')) + ".log").c_str());
+    remove((db_file.substr(0, db_file.rfind('.')) + ".fsm").c_str());
+  }
+  return 0;
+}
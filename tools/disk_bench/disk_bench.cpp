@@ -0,0 +1,253 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "common/exception.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_compressed.h"
+#include "storage/disk/disk_manager_posix.h"
+#include "storage/disk/disk_manager_uring.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+static const size_t BUSTUB_DISK_BENCH_PAGES = 8192;
+
+/** Creates the disk manager a run is measured with. */
+auto MakeDiskManager(const std::string &disk, const std::string &db_file) -> std::unique_ptr<bustub::DiskManager> {
+  if (disk == "stream") {
+    return std::make_unique<bustub::DiskManager>(db_file);
+  }
+  if (disk == "posix") {
+    return std::make_unique<bustub::DiskManagerPosix>(db_file);
+  }
+  if (disk == "compressed") {
+    return std::make_unique<bustub::DiskManagerCompressed>(db_file);
+  }
+  if (disk == "uring") {
+    auto disk_manager = std::make_unique<bustub::DiskManagerUring>(db_file);
+    if (!disk_manager->IsAsync()) {
+      std::cerr << "x: io_uring is unavailable, measuring the synchronous fallback" << std::endl;
+    }
+    return disk_manager;
+  }
+  throw bustub::Exception(fmt::format("unexpected disk manager: {}", disk));
+}
+
+/**
+ * Fill a page for the initial database file. "zero" leaves it empty, "rows" packs it with table-like rows of small
+ * integers and words from a short dictionary, and "random" makes it incompressible.
+ */
+void FillPage(const std::string &fill, bustub::page_id_t page_id, std::default_random_engine *gen, char *data) {
+  memset(data, 0, bustub::BUSTUB_PAGE_SIZE);
+  if (fill == "random") {
+    std::uniform_int_distribution<int> byte_dist(0, 255);
+    for (int i = 0; i < bustub::BUSTUB_PAGE_SIZE; i++) {
+      data[i] = static_cast<char>(byte_dist(*gen));
+    }
+    return;
+  }
+  if (fill == "rows") {
+    static const char *words[] = {"pending", "shipped", "returned", "delivered", "cancelled", "on hold"};
+    std::uniform_int_distribution<int> word_dist(0, 5);
+    std::uniform_int_distribution<int32_t> amount_dist(0, 9999);
+    const size_t row_size = 32;
+    for (size_t offset = 0; offset + row_size <= bustub::BUSTUB_PAGE_SIZE; offset += row_size) {
+      const auto id = static_cast<int32_t>(page_id * (bustub::BUSTUB_PAGE_SIZE / row_size) + offset / row_size);
+      const int32_t amount = amount_dist(*gen);
+      memcpy(data + offset, &id, sizeof(id));
+      memcpy(data + offset + 4, &amount, sizeof(amount));
+      snprintf(data + offset + 8, row_size - 8, "%s", words[word_dist(*gen)]);
+    }
+    return;
+  }
+  if (fill != "zero") {
+    throw bustub::Exception(fmt::format("unexpected fill: {}", fill));
+  }
+}
+
+/**
+ * Read and write random pages from `num_threads` threads for `duration_ms` milliseconds, then Sync(). Reports the
+ * throughput including the final sync, so that a disk manager cannot win by deferring its writes. With a batch size
+ * above 1, each thread submits its requests through SubmitRequests() and waits for the whole batch.
+ */
+void RunDiskWorkload(bustub::DiskManager *disk_manager, const std::string &disk, size_t num_pages, size_t num_threads,
+                     uint64_t duration_ms, size_t write_percent, size_t batch_size) {
+  std::atomic<uint64_t> total_op_cnt{0};
+  std::vector<std::thread> threads;
+  auto start_time = ClockMs();
+
+  for (size_t thread_id = 0; thread_id < num_threads; thread_id++) {
+    threads.emplace_back(
+        [disk_manager, num_pages, duration_ms, write_percent, batch_size, start_time, &total_op_cnt] {
+          std::random_device r;
+          std::default_random_engine gen(r());
+          std::uniform_int_distribution<bustub::page_id_t> page_dist(0,
+                                                                     static_cast<bustub::page_id_t>(num_pages - 1));
+          std::uniform_int_distribution<size_t> percent_dist(0, 99);
+          std::vector<char> data(batch_size * bustub::BUSTUB_PAGE_SIZE);
+          uint64_t op_cnt = 0;
+
+          while (ClockMs() - start_time < duration_ms) {
+            if (batch_size == 1) {
+              auto page_id = page_dist(gen);
+              if (percent_dist(gen) < write_percent) {
+                snprintf(data.data(), bustub::BUSTUB_PAGE_SIZE, "%d", page_id);
+                disk_manager->WritePage(page_id, data.data());
+              } else {
+                disk_manager->ReadPage(page_id, data.data());
+              }
+              op_cnt++;
+              continue;
+            }
+
+            // Distinct pages, so that no two requests of the batch touch the same page.
+            std::vector<bustub::DiskRequest> requests;
+            std::vector<std::future<bool>> results;
+            auto first_page_id = page_dist(gen);
+            for (size_t i = 0; i < batch_size; i++) {
+              auto page_id = static_cast<bustub::page_id_t>((first_page_id + i * 7919) % num_pages);
+              char *buffer = data.data() + i * bustub::BUSTUB_PAGE_SIZE;
+              bool is_write = percent_dist(gen) < write_percent;
+              if (is_write) {
+                snprintf(buffer, bustub::BUSTUB_PAGE_SIZE, "%d", page_id);
+              }
+              requests.push_back(bustub::DiskRequest{is_write, buffer, page_id, std::promise<bool>()});
+              results.push_back(requests.back().callback_.get_future());
+            }
+            disk_manager->SubmitRequests(&requests);
+            for (auto &result : results) {
+              result.wait();
+            }
+            op_cnt += batch_size;
+          }
+          total_op_cnt += op_cnt;
+        });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  disk_manager->Sync();
+
+  auto elapsed = ClockMs() - start_time;
+  fmt::print("<<< BEGIN\n");
+  fmt::print("disk: {}\n", disk);
+  fmt::print("threads: {}\n", num_threads);
+  fmt::print("write_percent: {}\n", write_percent);
+  fmt::print("batch: {}\n", batch_size);
+  fmt::print("ops: {}\n", total_op_cnt / static_cast<double>(elapsed) * 1000);
+  if (auto *compressed = dynamic_cast<bustub::DiskManagerCompressed *>(disk_manager); compressed != nullptr) {
+    auto stats = compressed->GetCompressionStats();
+    fmt::print("compressed_pages: {}/{}\n", stats.compressed_pages_written_, stats.pages_written_);
+    fmt::print("compression_ratio: {:.2f}\n", stats.GetCompressionRatio());
+    fmt::print("read_savings: {:.1f}%\n", stats.GetReadSavings() * 100);
+    fmt::print("file_kb: {}\n", compressed->GetNumFileBytes() / 1024);
+  }
+  fmt::print(">>> END\n");
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-disk-bench");
+  program.add_argument("--duration").help("run each disk manager for n milliseconds");
+  program.add_argument("--threads").help("number of worker threads");
+  program.add_argument("--pages").help("number of pages in the database file");
+  program.add_argument("--write-percent").help("percentage of the operations that are page writes");
+  program.add_argument("--batch").help("requests each thread submits at once through SubmitRequests()");
+  program.add_argument("--disk").help("disk manager to measure: stream, posix, uring, compressed or all");
+  program.add_argument("--fill").help("initial page contents: zero, rows or random");
+  program.add_argument("--file").help("database file to use; it is overwritten and removed");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  uint64_t duration_ms = 3000;
+  size_t num_threads = 4;
+  size_t num_pages = BUSTUB_DISK_BENCH_PAGES;
+  size_t write_percent = 10;
+  size_t batch_size = 1;
+  std::string disk = "all";
+  std::string db_file = "disk_bench.db";
+  std::string fill = "zero";
+
+  if (program.present("--duration")) {
+    duration_ms = std::stoi(program.get("--duration"));
+  }
+  if (program.present("--threads")) {
+    num_threads = std::stoi(program.get("--threads"));
+  }
+  if (program.present("--pages")) {
+    num_pages = std::stoi(program.get("--pages"));
+  }
+  if (program.present("--write-percent")) {
+    write_percent = std::stoi(program.get("--write-percent"));
+  }
+  if (program.present("--batch")) {
+    batch_size = std::max(1, std::stoi(program.get("--batch")));
+  }
+  if (program.present("--disk")) {
+    disk = program.get("--disk");
+  }
+  if (program.present("--file")) {
+    db_file = program.get("--file");
+  }
+  if (program.present("--fill")) {
+    fill = program.get("--fill");
+  }
+
+  std::vector<std::string> disks{disk};
+  if (disk == "all") {
+    disks = {"stream", "posix", "uring", "compressed"};
+  }
+  auto base_name = db_file.substr(0, db_file.rfind('.'));
+  std::vector<std::string> files{db_file, base_name + ".log", base_name + ".fsm", base_name + ".pmap"};
+
+  for (const auto &name : disks) {
+    for (const auto &file : files) {
+      remove(file.c_str());
+    }
+    auto disk_manager = MakeDiskManager(name, db_file);
+
+    // Every page exists on disk before the measurement starts, so reads never hit the end of the file.
+    std::cerr << "x: initialize " << num_pages << " " << fill << " pages with " << name << std::endl;
+    std::default_random_engine gen(42);
+    std::vector<char> data(bustub::BUSTUB_PAGE_SIZE);
+    for (size_t i = 0; i < num_pages; i++) {
+      auto page_id = static_cast<bustub::page_id_t>(i);
+      FillPage(fill, page_id, &gen, data.data());
+      disk_manager->SetPageCompressed(page_id, true);
+      disk_manager->WritePage(page_id, data.data());
+    }
+    disk_manager->Sync();
+
+    std::cerr << "x: benchmark start with " << num_threads << " threads" << std::endl;
+    RunDiskWorkload(disk_manager.get(), name, num_pages, num_threads, duration_ms, write_percent, batch_size);
+    disk_manager->ShutDown();
+  }
+  for (const auto &file : files) {
+    remove(file.c_str());
+  }
+
+  return 0;
+}
@@ -0,0 +1,222 @@
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/access_trace.h"
+#include "buffer/replacer.h"
+#include "common/exception.h"
+#include "fmt/core.h"
+
+/** Outcome of replaying a trace against one configuration. */
+struct SimResult {
+  uint64_t fetches_{0};
+  uint64_t hits_{0};
+  /** Fetches and new pages that found every frame pinned. */
+  uint64_t failed_{0};
+};
+
+/**
+ * Replays an access trace against a replacer, mirroring how BufferPoolManagerInstance drives it: frames come from
+ * the free list first, a frame's access is recorded and it becomes evictable when its last pin is released, and
+ * deleted pages leave the replacer without being remembered as evicted.
+ */
+class PoolSimulator {
+ public:
+  PoolSimulator(bustub::Replacer *replacer, size_t pool_size) : replacer_(replacer), frames_(pool_size) {
+    for (size_t i = 0; i < pool_size; i++) {
+      free_list_.push_back(static_cast<bustub::frame_id_t>(pool_size - 1 - i));
+    }
+  }
+
+  void Replay(const std::vector<bustub::AccessTraceRecord> &records, SimResult *result) {
+    for (const auto &record : records) {
+      switch (record.op_) {
+        case bustub::AccessTraceOp::FETCH:
+          result->fetches_++;
+          if (Pin(record.page_id_)) {
+            result->hits_++;
+          } else if (!Load(record.page_id_)) {
+            result->failed_++;
+          }
+          break;
+        case bustub::AccessTraceOp::NEW:
+          if (!Load(record.page_id_)) {
+            result->failed_++;
+          }
+          break;
+        case bustub::AccessTraceOp::UNPIN:
+          Unpin(record.page_id_);
+          break;
+        case bustub::AccessTraceOp::DELETE:
+          Delete(record.page_id_);
+          break;
+      }
+    }
+  }
+
+ private:
+  struct Frame {
+    bustub::page_id_t page_id_{bustub::INVALID_PAGE_ID};
+    int pin_count_{0};
+  };
+
+  /** @return whether the page is resident, pinning it if so */
+  auto Pin(bustub::page_id_t page_id) -> bool {
+    auto it = page_table_.find(page_id);
+    if (it == page_table_.end()) {
+      return false;
+    }
+    if (frames_[it->second].pin_count_++ == 0) {
+      replacer_->SetEvictable(it->second, false);
+    }
+    return true;
+  }
+
+  /** @return whether a frame could be found for the page, which is then resident and pinned */
+  auto Load(bustub::page_id_t page_id) -> bool {
+    bustub::frame_id_t frame_id;
+    if (!free_list_.empty()) {
+      frame_id = free_list_.back();
+      free_list_.pop_back();
+    } else if (replacer_->Victim(&frame_id)) {
+      page_table_.erase(frames_[frame_id].page_id_);
+    } else {
+      // The unpin that matches this request must not release a pin taken by someone else.
+      failed_pins_[page_id]++;
+      return false;
+    }
+    frames_[frame_id].page_id_ = page_id;
+    frames_[frame_id].pin_count_ = 1;
+    page_table_[page_id] = frame_id;
+    return true;
+  }
+
+  void Unpin(bustub::page_id_t page_id) {
+    auto failed = failed_pins_.find(page_id);
+    if (failed != failed_pins_.end()) {
+      if (--failed->second == 0) {
+        failed_pins_.erase(failed);
+      }
+      return;
+    }
+    auto it = page_table_.find(page_id);
+    if (it == page_table_.end() || frames_[it->second].pin_count_ == 0) {
+      return;
+    }
+    if (--frames_[it->second].pin_count_ == 0) {
+      replacer_->RecordAccess(it->second, page_id);
+      replacer_->SetEvictable(it->second, true);
+    }
+  }
+
+  void Delete(bustub::page_id_t page_id) {
+    auto it = page_table_.find(page_id);
+    if (it == page_table_.end() || frames_[it->second].pin_count_ != 0) {
+      return;
+    }
+    replacer_->Remove(it->second);
+    frames_[it->second].page_id_ = bustub::INVALID_PAGE_ID;
+    free_list_.push_back(it->second);
+    page_table_.erase(it);
+  }
+
+  bustub::Replacer *replacer_;
+  std::vector<Frame> frames_;
+  std::vector<bustub::frame_id_t> free_list_;
+  std::unordered_map<bustub::page_id_t, bustub::frame_id_t> page_table_;
+  std::unordered_map<bustub::page_id_t, int> failed_pins_;
+};
+
+auto ParseList(const std::string &str) -> std::vector<size_t> {
+  std::vector<size_t> values;
+  std::stringstream stream(str);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    values.push_back(std::stoul(item));
+  }
+  if (values.empty()) {
+    throw bustub::Exception(fmt::format("unexpected list: {}", str));
+  }
+  return values;
+}
+
+auto ParseReplacerTypes(const std::string &str) -> std::vector<std::pair<std::string, bustub::ReplacerType>> {
+  std::vector<std::pair<std::string, bustub::ReplacerType>> types;
+  std::stringstream stream(str);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (item == "lru-k") {
+      types.emplace_back(item, bustub::ReplacerType::LRU_K);
+    } else if (item == "arc") {
+      types.emplace_back(item, bustub::ReplacerType::ARC);
+    } else if (item == "2q") {
+      types.emplace_back(item, bustub::ReplacerType::TWO_Q);
+    } else {
+      throw bustub::Exception(fmt::format("unexpected replacer: {}", item));
+    }
+  }
+  return types;
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-replacer-sim");
+  program.add_argument("trace").help("access trace recorded with BufferPoolManagerInstance::SetAccessTrace");
+  program.add_argument("--pool-sizes").help("comma-separated pool sizes to simulate");
+  program.add_argument("--k").help("comma-separated values of K to simulate LRU-K with");
+  program.add_argument("--replacers").help("comma-separated replacement policies: lru-k, arc, 2q");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  std::vector<size_t> pool_sizes{64, 128, 256, 512, 1024};
+  std::vector<size_t> ks{1, 2, 4, 8};
+  auto replacer_types = ParseReplacerTypes("lru-k,arc,2q");
+  if (program.present("--pool-sizes")) {
+    pool_sizes = ParseList(program.get("--pool-sizes"));
+  }
+  if (program.present("--k")) {
+    ks = ParseList(program.get("--k"));
+  }
+  if (program.present("--replacers")) {
+    replacer_types = ParseReplacerTypes(program.get("--replacers"));
+  }
+
+  std::vector<bustub::AccessTraceRecord> records;
+  bustub::AccessTraceReader reader(program.get("trace"));
+  bustub::AccessTraceRecord record;
+  while (reader.Next(&record)) {
+    records.push_back(record);
+  }
+  std::cerr << "x: " << records.size() << " records" << std::endl;
+
+  fmt::print("{:<8} {:>4} {:>10} {:>12} {:>12} {:>10} {:>10}\n", "replacer", "k", "pool_size", "fetches", "hits",
+             "hit_ratio", "failed");
+  for (const auto &[name, replacer_type] : replacer_types) {
+    // K only matters to LRU-K; the other policies are simulated once per pool size.
+    std::vector<size_t> type_ks = replacer_type == bustub::ReplacerType::LRU_K ? ks : std::vector<size_t>{0};
+    for (auto k : type_ks) {
+      for (auto pool_size : pool_sizes) {
+        std::unique_ptr<bustub::Replacer> replacer(bustub::MakeReplacer(replacer_type, pool_size, k));
+        PoolSimulator simulator(replacer.get(), pool_size);
+        SimResult result;
+        simulator.Replay(records, &result);
+        auto hit_ratio =
+            result.fetches_ == 0 ? 0.0 : static_cast<double>(result.hits_) / static_cast<double>(result.fetches_);
+        fmt::print("{:<8} {:>4} {:>10} {:>12} {:>12} {:>10.4f} {:>10}\n", name,
+                   replacer_type == bustub::ReplacerType::LRU_K ? std::to_string(k) : "-", pool_size, result.fetches_,
+                   result.hits_, hit_ratio, result.failed_);
+      }
+    }
+  }
+  return 0;
+}
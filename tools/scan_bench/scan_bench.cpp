@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/exception.h"
+#include "fmt/core.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_mmap.h"
+#include "storage/disk/disk_manager_posix.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+static const size_t BUSTUB_SCAN_BENCH_PAGES = 16384;
+static const size_t BUSTUB_SCAN_BENCH_FRAMES = 1024;
+
+/** Write `num_pages` pages of table-like rows to a new database file. */
+void CreateDatabaseFile(const std::string &db_file, size_t num_pages) {
+  bustub::DiskManagerPosix disk_manager(db_file);
+  std::vector<char> data(bustub::BUSTUB_PAGE_SIZE);
+  for (size_t i = 0; i < num_pages; i++) {
+    const auto page_id = disk_manager.AllocatePage();
+    memset(data.data(), 0, data.size());
+    for (size_t offset = 0; offset + 64 <= data.size(); offset += 64) {
+      const auto row = static_cast<int64_t>(i * data.size() / 64 + offset / 64);
+      memcpy(data.data() + offset, &row, sizeof(row));
+      snprintf(data.data() + offset + 8, 56, "row %ld of page %d", static_cast<long>(row), page_id);  // NOLINT
+    }
+    disk_manager.WritePage(page_id, data.data());
+  }
+  disk_manager.ShutDown();
+}
+
+/**
+ * Scan the pages in order from `num_threads` threads, each reading its own contiguous share, `num_scans` times. Every
+ * page is fetched, summed up like a filter would read it, and unpinned. Reports the scan throughput.
+ */
+void RunScan(const std::string &disk, bustub::BufferPoolManager *bpm, size_t num_pages, size_t num_threads,
+             size_t num_scans) {
+  std::atomic<uint64_t> checksum{0};
+  std::atomic<uint64_t> failed{0};
+  std::vector<std::thread> threads;
+  auto start_time = ClockMs();
+
+  for (size_t thread_id = 0; thread_id < num_threads; thread_id++) {
+    threads.emplace_back([&, thread_id] {
+      const size_t begin = thread_id * num_pages / num_threads;
+      const size_t end = (thread_id + 1) * num_pages / num_threads;
+      uint64_t sum = 0;
+      for (size_t scan = 0; scan < num_scans; scan++) {
+        for (size_t i = begin; i < end; i++) {
+          const auto page_id = static_cast<bustub::page_id_t>(i);
+          auto *page = bpm->FetchPage(page_id);
+          if (page == nullptr) {
+            failed += 1;
+            continue;
+          }
+          const auto *words = reinterpret_cast<const uint64_t *>(page->GetData());
+          for (size_t w = 0; w < bustub::BUSTUB_PAGE_SIZE / sizeof(uint64_t); w++) {
+            sum += words[w];
+          }
+          bpm->UnpinPage(page_id, false);
+        }
+      }
+      checksum += sum;
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  auto elapsed = std::max<uint64_t>(1, ClockMs() - start_time);
+  auto pages = static_cast<double>(num_pages * num_scans);
+  fmt::print("<<< BEGIN\n");
+  fmt::print("disk: {}\n", disk);
+  fmt::print("threads: {}\n", num_threads);
+  fmt::print("pages_per_sec: {:.0f}\n", pages / static_cast<double>(elapsed) * 1000);
+  fmt::print("mb_per_sec: {:.1f}\n", pages * bustub::BUSTUB_PAGE_SIZE / (1 << 20) / static_cast<double>(elapsed) * 1000);
+  fmt::print("checksum: {}\n", checksum.load());
+  fmt::print("failed: {}\n", failed.load());
+  fmt::print(">>> END\n");
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-scan-bench");
+  program.add_argument("--pages").help("number of pages in the database file");
+  program.add_argument("--frames").help("number of frames in the buffer pool");
+  program.add_argument("--threads").help("number of scanning threads");
+  program.add_argument("--scans").help("number of times every thread scans its pages");
+  program.add_argument("--disk").help("file: pread into the frames; mmap: map the file read-only; all: both");
+  program.add_argument("--file").help("database file to create and scan");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t num_pages = BUSTUB_SCAN_BENCH_PAGES;
+  size_t num_frames = BUSTUB_SCAN_BENCH_FRAMES;
+  size_t num_threads = 1;
+  size_t num_scans = 4;
+  if (program.present("--pages")) {
+    num_pages = std::stoi(program.get("--pages"));
+  }
+  if (program.present("--frames")) {
+    num_frames = std::stoi(program.get("--frames"));
+  }
+  if (program.present("--threads")) {
+    num_threads = std::stoi(program.get("--threads"));
+  }
+  if (program.present("--scans")) {
+    num_scans = std::stoi(program.get("--scans"));
+  }
+  std::vector<std::string> disks = {"file", "mmap"};
+  if (program.present("--disk")) {
+    auto disk = program.get("--disk");
+    if (disk != "file" && disk != "mmap" && disk != "all") {
+      throw bustub::Exception(fmt::format("unexpected disk: {}", disk));
+    }
+    if (disk != "all") {
+      disks = {disk};
+    }
+  }
+  std::string db_file = "scan_bench.db";
+  if (program.present("--file")) {
+    db_file = program.get("--file");
+  }
+  if (num_threads == 0 || num_frames < num_threads) {
+    std::cerr << "the buffer pool needs at least one frame per thread" << std::endl;
+    return 1;
+  }
+
+  std::cerr << "x: " << num_pages << " pages, " << num_frames << " frames, " << num_threads << " threads, "
+            << num_scans << " scans" << std::endl;
+  std::cerr << "x: create " << db_file << std::endl;
+  remove(db_file.c_str());
+  remove((db_file.substr(0, db_file.rfind('.')) + ".fsm").c_str());
+  CreateDatabaseFile(db_file, num_pages);
+
+  // Both paths read the file through the page cache, which the first run warms up for the others.
+  for (const auto &disk : disks) {
+    std::unique_ptr<bustub::DiskManager> disk_manager;
+    if (disk == "mmap") {
+      disk_manager = std::make_unique<bustub::DiskManagerMmap>(db_file);
+    } else {
+      disk_manager = std::make_unique<bustub::DiskManagerPosix>(db_file);
+    }
+    auto bpm = std::make_unique<bustub::BufferPoolManagerInstance>(num_frames, disk_manager.get());
+    std::cerr << "x: benchmark start with " << disk << " disk" << std::endl;
+    RunScan(disk, bpm.get(), num_pages, num_threads, num_scans);
+    bpm.reset();
+    disk_manager->ShutDown();
+  }
+
+  remove(db_file.c_str());
+  remove((db_file.substr(0, db_file.rfind('.')) + ".log").c_str());
+  remove((db_file.substr(0, db_file.rfind('.')) + ".fsm").c_str());
+  return 0;
+}
@@ -27,8 +27,6 @@ auto GetWidthOfUtf8(const void *beg, const void *end, size_t *width) -> int {
 auto main(int argc, char **argv) -> int {
   ft_set_u8strwid_func(&GetWidthOfUtf8);
 
-  auto bustub = std::make_unique<bustub::BustubInstance>("test.db");
-
   auto default_prompt = "bustub> ";
   auto emoji_prompt = "\U0001f6c1> ";  // the bathtub emoji
   bool use_emoji_prompt = false;
@@ -43,11 +41,21 @@ auto main(int argc, char **argv) -> int {
       disable_tty = true;
       break;
     }
+    if (strcmp(argv[i], "--page-compression") == 0) {
+      // Tables created WITH (compression) store their pages compressed.
+      bustub::enable_page_compression = true;
+    }
+    if (strcmp(argv[i], "--read-only") == 0) {
+      // Map the existing database file read-only, e.g. for an analytic replica.
+      bustub::open_read_only = true;
+    }
   }
 
+  auto bustub = std::make_unique<bustub::BustubInstance>("test.db");
+
   bustub->GenerateMockTable();
 
-  if (bustub->buffer_pool_manager_ != nullptr) {
+  if (bustub->buffer_pool_manager_ != nullptr && !bustub::open_read_only) {
     bustub->GenerateTestTable();
   }
 
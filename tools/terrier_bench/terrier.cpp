@@ -17,7 +17,9 @@
 #include "concurrency/transaction_manager.h"
 #include "fmt/core.h"
 #include "fmt/std.h"
+#include "storage/index/index.h"
 #include "terrier_bench_config.h"
+#include "type/value_factory.h"
 
 #include <sys/time.h>
 
@@ -36,6 +38,7 @@ struct TerrierTotalMetrics {
   uint64_t committed_count_txn_cnt_{0};
   uint64_t aborted_update_txn_cnt_{0};
   uint64_t committed_update_txn_cnt_{0};
+  uint64_t lookup_cnt_{0};
   uint64_t start_time_{0};
   std::mutex mutex_;
 
@@ -53,15 +56,24 @@ struct TerrierTotalMetrics {
     committed_update_txn_cnt_ += committed_cnt;
   }
 
-  void Report() {
+  void ReportLookup(uint64_t lookup_cnt) {
+    std::unique_lock<std::mutex> l(mutex_);
+    lookup_cnt_ += lookup_cnt;
+  }
+
+  void Report(bool report_lookup) {
     auto now = ClockMs();
     auto elsped = now - start_time_;
     auto count_txn_per_sec = committed_count_txn_cnt_ / static_cast<double>(elsped) * 1000;
     auto update_txn_per_sec = committed_update_txn_cnt_ / static_cast<double>(elsped) * 1000;
+    auto lookup_per_sec = lookup_cnt_ / static_cast<double>(elsped) * 1000;
 
     fmt::print("<<< BEGIN\n");
     fmt::print("update: {}\n", update_txn_per_sec);
     fmt::print("count: {}\n", count_txn_per_sec);
+    if (report_lookup) {
+      fmt::print("lookup: {}\n", lookup_per_sec);
+    }
     fmt::print(">>> END\n");
   }
 };
@@ -120,6 +132,12 @@ auto main(int argc, char **argv) -> int {
   program.add_argument("--duration").help("run terrier bench for n milliseconds");
   program.add_argument("--force-create-index").help("create index in terrier bench");
   program.add_argument("--force-enable-update").help("use update statement in terrier bench");
+  program.add_argument("--bpm-size").help("number of frames in the buffer pool");
+  program.add_argument("--update-threads").help("number of threads updating the table");
+  program.add_argument("--count-threads").help("number of threads counting the table");
+  program.add_argument("--lookup-threads").help("number of threads looking up random ids in the index");
+  program.add_argument("--page-class-priorities").help("favor index pages over heap pages in the buffer pool");
+  program.add_argument("--pin-index").help("keep the pages of the index resident in the buffer pool");
 
   try {
     program.parse_args(argc, argv);
@@ -129,7 +147,17 @@ auto main(int argc, char **argv) -> int {
     return 1;
   }
 
-  auto bustub = std::make_unique<bustub::BustubInstance>();
+  size_t bpm_size = 128;
+  if (program.present("--bpm-size")) {
+    bpm_size = std::stoi(program.get("--bpm-size"));
+  }
+  if (program.present("--page-class-priorities")) {
+    bustub::page_class_priorities = ParseBool(program.get("--page-class-priorities"));
+  }
+  std::cerr << "x: buffer pool of " << bpm_size << " frames, page class priorities "
+            << (bustub::page_class_priorities ? "enabled" : "disabled") << std::endl;
+
+  auto bustub = std::make_unique<bustub::BustubInstance>(bpm_size);
   auto writer = bustub::SimpleStreamWriter(std::cerr);
 
   // create schema
@@ -172,6 +200,23 @@ auto main(int argc, char **argv) -> int {
     std::cerr << "x: use insert + delete" << std::endl;
   }
 
+  size_t update_threads = BUSTUB_TERRIER_THREAD;
+  if (program.present("--update-threads")) {
+    update_threads = std::stoi(program.get("--update-threads"));
+  }
+  size_t count_threads = BUSTUB_TERRIER_THREAD;
+  if (program.present("--count-threads")) {
+    count_threads = std::stoi(program.get("--count-threads"));
+  }
+  size_t lookup_threads = 0;
+  if (program.present("--lookup-threads")) {
+    lookup_threads = std::stoi(program.get("--lookup-threads"));
+    if (lookup_threads > 0 && !enable_index) {
+      std::cerr << "x: index lookups require the index" << std::endl;
+      return 1;
+    }
+  }
+
   uint64_t duration_ms = 30000;
 
   if (program.present("--duration")) {
@@ -205,6 +250,15 @@ auto main(int argc, char **argv) -> int {
     }
   }
 
+  if (program.present("--pin-index") && ParseBool(program.get("--pin-index"))) {
+    if (!enable_index) {
+      std::cerr << "x: there is no index to pin" << std::endl;
+      return 1;
+    }
+    std::cerr << "x: pin index" << std::endl;
+    bustub->ExecuteSql("\\pin nftid", writer);
+  }
+
   std::cerr << "x: benchmark start" << std::endl;
 
   std::vector<std::thread> threads;
@@ -212,9 +266,9 @@ auto main(int argc, char **argv) -> int {
 
   total_metrics.Begin();
 
-  for (size_t thread_id = 0; thread_id < BUSTUB_TERRIER_THREAD; thread_id++) {
-    threads.emplace_back(std::thread([thread_id, &bustub, enable_update, duration_ms, &total_metrics] {
-      const size_t nft_range_size = BUSTUB_NFT_NUM / BUSTUB_TERRIER_THREAD;
+  for (size_t thread_id = 0; thread_id < update_threads; thread_id++) {
+    threads.emplace_back(std::thread([thread_id, &bustub, enable_update, update_threads, duration_ms, &total_metrics] {
+      const size_t nft_range_size = BUSTUB_NFT_NUM / update_threads;
       const size_t nft_range_begin = thread_id * nft_range_size;
       const size_t nft_range_end = (thread_id + 1) * nft_range_size;
       std::random_device r;
@@ -303,7 +357,7 @@ auto main(int argc, char **argv) -> int {
     }));
   }
 
-  for (size_t thread_id = 0; thread_id < BUSTUB_TERRIER_THREAD; thread_id++) {
+  for (size_t thread_id = 0; thread_id < count_threads; thread_id++) {
     threads.emplace_back(std::thread([thread_id, &bustub, duration_ms, &total_metrics] {
       std::random_device r;
       std::default_random_engine gen(r());
@@ -341,6 +395,30 @@ auto main(int argc, char **argv) -> int {
     }));
   }
 
+  for (size_t thread_id = 0; thread_id < lookup_threads; thread_id++) {
+    threads.emplace_back(std::thread([thread_id, &bustub, duration_ms, &total_metrics] {
+      auto *index_info = bustub->catalog_->GetIndex("nftid", "nft");
+      std::random_device r;
+      std::default_random_engine gen(r());
+      std::uniform_int_distribution<int> nft_uniform_dist(0, BUSTUB_NFT_NUM - 1);
+
+      // Lookups go straight to the index: they are not transactions, so they count as committed ones.
+      TerrierMetrics metrics(fmt::format("Lookup {}", thread_id), duration_ms);
+      metrics.Begin();
+
+      std::vector<bustub::RID> rids;
+      while (!metrics.ShouldFinish()) {
+        bustub::Tuple key({bustub::ValueFactory::GetIntegerValue(nft_uniform_dist(gen))}, &index_info->key_schema_);
+        rids.clear();
+        index_info->index_->ScanKey(key, &rids, nullptr);
+        metrics.TxnCommitted();
+        metrics.Report();
+      }
+
+      total_metrics.ReportLookup(metrics.committed_txn_cnt_);
+    }));
+  }
+
   for (auto &thread : threads) {
     thread.join();
   }
@@ -358,7 +436,7 @@ auto main(int argc, char **argv) -> int {
     }
   }
 
-  total_metrics.Report();
+  total_metrics.Report(lookup_threads > 0);
 
   return 0;
 }